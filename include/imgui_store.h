@@ -0,0 +1,103 @@
+#ifndef __IMGUI_STORE_H__
+#define __IMGUI_STORE_H__
+
+#include <autodo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Value type of a slot.
+ */
+typedef enum imgui_store_type
+{
+    IMGUI_STORE_NUMBER,     /**< A double. */
+    IMGUI_STORE_INTEGER,    /**< A 64-bit signed integer. */
+    IMGUI_STORE_ARRAY,      /**< Up to capacity doubles. */
+    IMGUI_STORE_STRING,     /**< Up to capacity bytes. */
+} imgui_store_type_t;
+
+/**
+ * @brief A named value published to GUI.
+ *
+ * Each slot is protected by a seqlock: writers never wait for readers, and
+ * readers retry if a write happened while reading. Slots are never freed, so
+ * a slot handle stays valid until process exit.
+ */
+typedef struct imgui_store_slot imgui_store_slot_t;
+
+/**
+ * @brief Publishing API for native modules.
+ *
+ * Get it from #imgui_store_api(), or from `imgui.store.api()` as a light
+ * userdata if linking against this module is not desired.
+ *
+ * All functions are MT-Safe. Writes to the same slot from multiple threads
+ * are serialized.
+ */
+typedef struct imgui_store_api
+{
+    /**
+     * @brief Create a slot, or get the slot with the same name.
+     * @param[in] name      Slot name.
+     * @param[in] type      Value type.
+     * @param[in] capacity  Elements of array, or bytes of string. Ignored for scalars.
+     * @return              Slot handle, or NULL if a slot with the same name
+     *   has different type or capacity.
+     */
+    imgui_store_slot_t* (*create)(const char* name, imgui_store_type_t type, size_t capacity);
+
+    /**
+     * @brief Publish a number.
+     * @note Do nothing if slot is not #IMGUI_STORE_NUMBER.
+     * @param[in] slot      Slot handle.
+     * @param[in] value     Value.
+     */
+    void (*set_number)(imgui_store_slot_t* slot, double value);
+
+    /**
+     * @brief Publish an integer.
+     * @note Do nothing if slot is not #IMGUI_STORE_INTEGER.
+     * @param[in] slot      Slot handle.
+     * @param[in] value     Value.
+     */
+    void (*set_integer)(imgui_store_slot_t* slot, int64_t value);
+
+    /**
+     * @brief Add \p delta to an integer, for counters.
+     * @note Do nothing if slot is not #IMGUI_STORE_INTEGER.
+     * @param[in] slot      Slot handle.
+     * @param[in] delta     Value to add.
+     */
+    void (*add_integer)(imgui_store_slot_t* slot, int64_t delta);
+
+    /**
+     * @brief Publish an array.
+     * @note Do nothing if slot is not #IMGUI_STORE_ARRAY.
+     * @param[in] slot      Slot handle.
+     * @param[in] data      Elements.
+     * @param[in] n         Number of elements, truncated to capacity.
+     */
+    void (*set_array)(imgui_store_slot_t* slot, const double* data, size_t n);
+
+    /**
+     * @brief Publish a string.
+     * @note Do nothing if slot is not #IMGUI_STORE_STRING.
+     * @param[in] slot      Slot handle.
+     * @param[in] str       String, not required to be NUL terminated.
+     * @param[in] len       Length in bytes, truncated to capacity.
+     */
+    void (*set_string)(imgui_store_slot_t* slot, const char* str, size_t len);
+} imgui_store_api_t;
+
+/**
+ * @brief Get publishing API.
+ * @return  Publishing API, never NULL.
+ */
+AUTO_EXPORT const imgui_store_api_t* imgui_store_api(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,4 +1,10 @@
 #include "ImGuiAdapter.hpp"
+#include "allocator.hpp"
+#include "capture.hpp"
+#include "implot_static.hpp"
+#include "lua_imgui.h"
+#include "playback.hpp"
+#include "trace.hpp"
 #include <implot.h>
 
 #if defined(IMGUI_BACKEND_OPENGL3)
@@ -18,10 +24,478 @@
 #   error no imgui backend
 #endif
 
+#include <mutex>
+#include <vector>
+
 /* Font */
 //extern "C" const unsigned int sarasa_compressed_data[];
 //extern "C" const unsigned int sarasa_compressed_size;
 
+#if defined(IMGUI_BACKEND_GLFW)
+typedef enum imgui_adapter_event_type
+{
+    IMGUI_ADAPTER_EVENT_FOCUS,
+    IMGUI_ADAPTER_EVENT_CURSOR_ENTER,
+    IMGUI_ADAPTER_EVENT_CURSOR_POS,
+    IMGUI_ADAPTER_EVENT_MOUSE_BUTTON,
+    IMGUI_ADAPTER_EVENT_SCROLL,
+    IMGUI_ADAPTER_EVENT_KEY,
+    IMGUI_ADAPTER_EVENT_CHAR,
+} imgui_adapter_event_type_t;
+
+/**
+ * @brief Arguments of a GLFW input callback.
+ */
+typedef struct imgui_adapter_event
+{
+    imgui_adapter_event_type_t  type;
+    int                         args[4];    /**< Integer arguments in callback order. */
+    double                      x;
+    double                      y;
+} imgui_adapter_event_t;
+#elif defined(IMGUI_BACKEND_SDL)
+typedef SDL_Event imgui_adapter_event_t;
+#endif
+
+#if defined(_WIN32)
+#   define IMGUI_ADAPTER_APIENTRY   __stdcall
+#else
+#   define IMGUI_ADAPTER_APIENTRY
+#endif
+
+#define IMGUI_GL_NEAREST                0x2600
+#define IMGUI_GL_RGBA8                  0x8058
+#define IMGUI_GL_READ_FRAMEBUFFER       0x8CA8
+#define IMGUI_GL_DRAW_FRAMEBUFFER       0x8CA9
+#define IMGUI_GL_COLOR_ATTACHMENT0      0x8CE0
+#define IMGUI_GL_FRAMEBUFFER_COMPLETE   0x8CD5
+#define IMGUI_GL_RENDERBUFFER           0x8D41
+
+/**
+ * @brief OpenGL 3.0 functions used to keep the last frame. ImGui only loads
+ *   what its renderer needs, so they are loaded here.
+ */
+typedef struct imgui_adapter_gl
+{
+    void (IMGUI_ADAPTER_APIENTRY *GenFramebuffers)(int n, unsigned* framebuffers);
+    void (IMGUI_ADAPTER_APIENTRY *DeleteFramebuffers)(int n, const unsigned* framebuffers);
+    void (IMGUI_ADAPTER_APIENTRY *BindFramebuffer)(unsigned target, unsigned framebuffer);
+    unsigned (IMGUI_ADAPTER_APIENTRY *CheckFramebufferStatus)(unsigned target);
+    void (IMGUI_ADAPTER_APIENTRY *FramebufferRenderbuffer)(unsigned target, unsigned attachment, unsigned rb_target, unsigned renderbuffer);
+    void (IMGUI_ADAPTER_APIENTRY *GenRenderbuffers)(int n, unsigned* renderbuffers);
+    void (IMGUI_ADAPTER_APIENTRY *DeleteRenderbuffers)(int n, const unsigned* renderbuffers);
+    void (IMGUI_ADAPTER_APIENTRY *BindRenderbuffer)(unsigned target, unsigned renderbuffer);
+    void (IMGUI_ADAPTER_APIENTRY *RenderbufferStorage)(unsigned target, unsigned format, int width, int height);
+    void (IMGUI_ADAPTER_APIENTRY *BlitFramebuffer)(int src_x0, int src_y0, int src_x1, int src_y1,
+        int dst_x0, int dst_y0, int dst_x1, int dst_y1, unsigned mask, unsigned filter);
+} imgui_adapter_gl_t;
+
+typedef struct imgui_adapter
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    GLFWwindow*             window;
+#elif defined(IMGUI_BACKEND_SDL)
+    SDL_Window*             window;
+    bool                    done;
+#endif
+
+    bool                    exit;           /**< Playback asked to close window. */
+
+    /**
+     * @brief Platform events not yet handed to ImGui.
+     *
+     * The GUI thread pumps events while user function is still building a
+     * frame on the same ImGui context, so events are only queued by platform
+     * callbacks and replayed into the backend before next NewFrame().
+     */
+    std::vector<imgui_adapter_event_t> events;
+
+    /**
+     * @brief Pixels of last completed frame.
+     *
+     * Re-presenting the draw data would run the renderer on the ImGui context
+     * that user function is building the next frame on, so the framebuffer is
+     * copied before swap, and copied back while user function is late.
+     */
+    imgui_adapter_gl_t      gl;
+    bool                    gl_ok;
+    unsigned                last_fbo;
+    unsigned                last_rbo;
+    int                     last_width;
+    int                     last_height;
+    bool                    last_valid;
+} imgui_adapter_t;
+
+static imgui_adapter_t s_adapter;
+
+/**
+ * @brief Functions registered by #ImGuiAdapterAtExit().
+ */
+static struct
+{
+    std::mutex                  mutex;
+    std::vector<void (*)(void)> callbacks;
+} s_atexit;
+
+#if defined(IMGUI_BACKEND_GLFW)
+static void _adapter_push_event(imgui_adapter_event_type_t type, int a, int b, int c, int d, double x, double y)
+{
+    imgui_adapter_event_t event = { type, { a, b, c, d }, x, y };
+    s_adapter.events.push_back(event);
+}
+
+static void _adapter_on_focus(GLFWwindow*, int focused)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_FOCUS, focused, 0, 0, 0, 0, 0);
+}
+
+static void _adapter_on_cursor_enter(GLFWwindow*, int entered)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_CURSOR_ENTER, entered, 0, 0, 0, 0, 0);
+}
+
+static void _adapter_on_cursor_pos(GLFWwindow*, double x, double y)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_CURSOR_POS, 0, 0, 0, 0, x, y);
+}
+
+static void _adapter_on_mouse_button(GLFWwindow*, int button, int action, int mods)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_MOUSE_BUTTON, button, action, mods, 0, 0, 0);
+}
+
+static void _adapter_on_scroll(GLFWwindow*, double x, double y)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_SCROLL, 0, 0, 0, 0, x, y);
+}
+
+static void _adapter_on_key(GLFWwindow*, int key, int scancode, int action, int mods)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_KEY, key, scancode, action, mods, 0, 0);
+}
+
+static void _adapter_on_char(GLFWwindow*, unsigned int c)
+{
+    _adapter_push_event(IMGUI_ADAPTER_EVENT_CHAR, (int)c, 0, 0, 0, 0, 0);
+}
+
+static void _adapter_install_callbacks(GLFWwindow* window)
+{
+    glfwSetWindowFocusCallback(window, _adapter_on_focus);
+    glfwSetCursorEnterCallback(window, _adapter_on_cursor_enter);
+    glfwSetCursorPosCallback(window, _adapter_on_cursor_pos);
+    glfwSetMouseButtonCallback(window, _adapter_on_mouse_button);
+    glfwSetScrollCallback(window, _adapter_on_scroll);
+    glfwSetKeyCallback(window, _adapter_on_key);
+    glfwSetCharCallback(window, _adapter_on_char);
+}
+#endif
+
+/**
+ * @brief Pump platform events into #imgui_adapter_t::events.
+ * @note Never touches ImGui, so it is safe while user function runs.
+ */
+static void _adapter_poll_events(void)
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    glfwPollEvents();
+#elif defined(IMGUI_BACKEND_SDL)
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        if (event.type == SDL_QUIT)
+            s_adapter.done = true;
+        if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(s_adapter.window))
+            s_adapter.done = true;
+        s_adapter.events.push_back(event);
+    }
+#endif
+}
+
+/**
+ * @brief Hand queued platform events to ImGui backend.
+ * @note Must be called between frames.
+ */
+static void _adapter_replay_events(void)
+{
+    for (size_t i = 0; i < s_adapter.events.size(); i++)
+    {
+#if defined(IMGUI_BACKEND_GLFW)
+        const imgui_adapter_event_t& e = s_adapter.events[i];
+        GLFWwindow* window = s_adapter.window;
+        switch (e.type)
+        {
+        case IMGUI_ADAPTER_EVENT_FOCUS:
+            ImGui_ImplGlfw_WindowFocusCallback(window, e.args[0]);
+            break;
+        case IMGUI_ADAPTER_EVENT_CURSOR_ENTER:
+            ImGui_ImplGlfw_CursorEnterCallback(window, e.args[0]);
+            break;
+        case IMGUI_ADAPTER_EVENT_CURSOR_POS:
+            ImGui_ImplGlfw_CursorPosCallback(window, e.x, e.y);
+            break;
+        case IMGUI_ADAPTER_EVENT_MOUSE_BUTTON:
+            ImGui_ImplGlfw_MouseButtonCallback(window, e.args[0], e.args[1], e.args[2]);
+            break;
+        case IMGUI_ADAPTER_EVENT_SCROLL:
+            ImGui_ImplGlfw_ScrollCallback(window, e.x, e.y);
+            break;
+        case IMGUI_ADAPTER_EVENT_KEY:
+            ImGui_ImplGlfw_KeyCallback(window, e.args[0], e.args[1], e.args[2], e.args[3]);
+            break;
+        case IMGUI_ADAPTER_EVENT_CHAR:
+            ImGui_ImplGlfw_CharCallback(window, (unsigned int)e.args[0]);
+            break;
+        }
+#elif defined(IMGUI_BACKEND_SDL)
+        ImGui_ImplSDL2_ProcessEvent(&s_adapter.events[i]);
+#endif
+    }
+    s_adapter.events.clear();
+}
+
+static void* _adapter_get_proc(const char* name)
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    return (void*)glfwGetProcAddress(name);
+#elif defined(IMGUI_BACKEND_SDL)
+    return SDL_GL_GetProcAddress(name);
+#endif
+}
+
+static void _adapter_framebuffer_size(int* width, int* height)
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    glfwGetFramebufferSize(s_adapter.window, width, height);
+#elif defined(IMGUI_BACKEND_SDL)
+    SDL_GL_GetDrawableSize(s_adapter.window, width, height);
+#endif
+}
+
+static void _adapter_swap(void)
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    glfwSwapBuffers(s_adapter.window);
+#elif defined(IMGUI_BACKEND_SDL)
+    SDL_GL_SwapWindow(s_adapter.window);
+#endif
+}
+
+static void _adapter_gl_init(void)
+{
+    imgui_adapter_gl_t* gl = &s_adapter.gl;
+    *(void**)&gl->GenFramebuffers = _adapter_get_proc("glGenFramebuffers");
+    *(void**)&gl->DeleteFramebuffers = _adapter_get_proc("glDeleteFramebuffers");
+    *(void**)&gl->BindFramebuffer = _adapter_get_proc("glBindFramebuffer");
+    *(void**)&gl->CheckFramebufferStatus = _adapter_get_proc("glCheckFramebufferStatus");
+    *(void**)&gl->FramebufferRenderbuffer = _adapter_get_proc("glFramebufferRenderbuffer");
+    *(void**)&gl->GenRenderbuffers = _adapter_get_proc("glGenRenderbuffers");
+    *(void**)&gl->DeleteRenderbuffers = _adapter_get_proc("glDeleteRenderbuffers");
+    *(void**)&gl->BindRenderbuffer = _adapter_get_proc("glBindRenderbuffer");
+    *(void**)&gl->RenderbufferStorage = _adapter_get_proc("glRenderbufferStorage");
+    *(void**)&gl->BlitFramebuffer = _adapter_get_proc("glBlitFramebuffer");
+
+    s_adapter.gl_ok = gl->GenFramebuffers != NULL && gl->DeleteFramebuffers != NULL
+        && gl->BindFramebuffer != NULL && gl->CheckFramebufferStatus != NULL
+        && gl->FramebufferRenderbuffer != NULL && gl->GenRenderbuffers != NULL
+        && gl->DeleteRenderbuffers != NULL && gl->BindRenderbuffer != NULL
+        && gl->RenderbufferStorage != NULL && gl->BlitFramebuffer != NULL;
+    s_adapter.last_fbo = 0;
+    s_adapter.last_rbo = 0;
+    s_adapter.last_width = 0;
+    s_adapter.last_height = 0;
+    s_adapter.last_valid = false;
+}
+
+static void _adapter_free_frame(void)
+{
+    imgui_adapter_gl_t* gl = &s_adapter.gl;
+    if (s_adapter.last_fbo != 0)
+    {
+        gl->DeleteFramebuffers(1, &s_adapter.last_fbo);
+        s_adapter.last_fbo = 0;
+    }
+    if (s_adapter.last_rbo != 0)
+    {
+        gl->DeleteRenderbuffers(1, &s_adapter.last_rbo);
+        s_adapter.last_rbo = 0;
+    }
+    s_adapter.last_valid = false;
+}
+
+/**
+ * @brief Copy back buffer, so it can be presented again while the next frame
+ *   is not ready.
+ * @note Must be called after rendering and before swap.
+ */
+static void _adapter_save_frame(void)
+{
+    imgui_adapter_gl_t* gl = &s_adapter.gl;
+    if (!s_adapter.gl_ok)
+    {
+        return;
+    }
+
+    int width, height;
+    _adapter_framebuffer_size(&width, &height);
+    if (width <= 0 || height <= 0)
+    {
+        s_adapter.last_valid = false;
+        return;
+    }
+
+    if (s_adapter.last_fbo == 0)
+    {
+        gl->GenFramebuffers(1, &s_adapter.last_fbo);
+        gl->GenRenderbuffers(1, &s_adapter.last_rbo);
+        s_adapter.last_width = 0;
+    }
+    gl->BindFramebuffer(IMGUI_GL_DRAW_FRAMEBUFFER, s_adapter.last_fbo);
+    if (width != s_adapter.last_width || height != s_adapter.last_height)
+    {
+        gl->BindRenderbuffer(IMGUI_GL_RENDERBUFFER, s_adapter.last_rbo);
+        gl->RenderbufferStorage(IMGUI_GL_RENDERBUFFER, IMGUI_GL_RGBA8, width, height);
+        gl->BindRenderbuffer(IMGUI_GL_RENDERBUFFER, 0);
+        gl->FramebufferRenderbuffer(IMGUI_GL_DRAW_FRAMEBUFFER, IMGUI_GL_COLOR_ATTACHMENT0,
+            IMGUI_GL_RENDERBUFFER, s_adapter.last_rbo);
+        s_adapter.last_width = width;
+        s_adapter.last_height = height;
+    }
+
+    s_adapter.last_valid = gl->CheckFramebufferStatus(IMGUI_GL_DRAW_FRAMEBUFFER) == IMGUI_GL_FRAMEBUFFER_COMPLETE;
+    if (s_adapter.last_valid)
+    {
+        gl->BindFramebuffer(IMGUI_GL_READ_FRAMEBUFFER, 0);
+        glDisable(GL_SCISSOR_TEST);
+        gl->BlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, IMGUI_GL_NEAREST);
+    }
+    gl->BindFramebuffer(IMGUI_GL_DRAW_FRAMEBUFFER, 0);
+}
+
+/**
+ * @brief Present the copy of last frame again, anchored at top left like
+ *   ImGui does if window was resized since.
+ */
+static void _adapter_present_saved(void)
+{
+    imgui_adapter_gl_t* gl = &s_adapter.gl;
+    int width, height;
+    _adapter_framebuffer_size(&width, &height);
+
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    int w = s_adapter.last_width, h = s_adapter.last_height;
+    gl->BindFramebuffer(IMGUI_GL_READ_FRAMEBUFFER, s_adapter.last_fbo);
+    gl->BindFramebuffer(IMGUI_GL_DRAW_FRAMEBUFFER, 0);
+    gl->BlitFramebuffer(0, 0, w, h, 0, height - h, w, height, GL_COLOR_BUFFER_BIT, IMGUI_GL_NEAREST);
+    gl->BindFramebuffer(IMGUI_GL_READ_FRAMEBUFFER, 0);
+
+    _adapter_swap();
+}
+
+/**
+ * @brief Render \p draw_data and swap buffers.
+ * @param[in] draw_data Draw data.
+ * @param[in] save      Whether to keep a copy for #ImGuiAdapterIdle().
+ */
+static void _adapter_present(ImDrawData* draw_data, bool save)
+{
+    glViewport(0, 0, (int)draw_data->DisplaySize.x, (int)draw_data->DisplaySize.y);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(draw_data);
+
+    imgui_capture_frame((int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x),
+        (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y));
+    if (save)
+    {
+        _adapter_save_frame();
+    }
+
+    _adapter_swap();
+}
+
+static void _adapter_resize(int width, int height)
+{
+#if defined(IMGUI_BACKEND_GLFW)
+    glfwSetWindowSize(s_adapter.window, width, height);
+#elif defined(IMGUI_BACKEND_SDL)
+    SDL_SetWindowSize(s_adapter.window, width, height);
+#endif
+}
+
+/**
+ * @brief Inject playback events before ImGui starts a new frame.
+ */
+static void _adapter_playback(void)
+{
+    imgui_playback_action_t action;
+    imgui_playback_apply(&action);
+
+    if (action.resize)
+    {
+        _adapter_resize(action.width, action.height);
+    }
+    if (action.exit)
+    {
+        s_adapter.exit = true;
+    }
+}
+
+void ImGuiAdapterAtExit(void (*fn)(void))
+{
+    std::lock_guard<std::mutex> guard(s_atexit.mutex);
+    for (size_t i = 0; i < s_atexit.callbacks.size(); i++)
+    {
+        if (s_atexit.callbacks[i] == fn)
+        {
+            return;
+        }
+    }
+    s_atexit.callbacks.push_back(fn);
+}
+
+static void _adapter_run_atexit(void)
+{
+    std::vector<void (*)(void)> callbacks;
+    {
+        std::lock_guard<std::mutex> guard(s_atexit.mutex);
+        callbacks = s_atexit.callbacks;
+    }
+
+    for (size_t i = 0; i < callbacks.size(); i++)
+    {
+        callbacks[i]();
+    }
+}
+
+bool ImGuiAdapterFocused(void)
+{
+    if (s_adapter.window == NULL)
+    {
+        return false;
+    }
+#if defined(IMGUI_BACKEND_GLFW)
+    return glfwGetWindowAttrib(s_adapter.window, GLFW_FOCUSED) != 0;
+#elif defined(IMGUI_BACKEND_SDL)
+    return (SDL_GetWindowFlags(s_adapter.window) & SDL_WINDOW_INPUT_FOCUS) != 0;
+#endif
+}
+
+void ImGuiAdapterIdle(imgui_ctx_t* gui)
+{
+    (void)gui;
+
+    /* ImGui context belongs to user function now, events are only queued */
+    _adapter_poll_events();
+
+    if (s_adapter.last_valid)
+    {
+        _adapter_present_saved();
+    }
+}
+
 void ImGuiAdapter(imgui_ctx_t* gui, void(*callback)(imgui_ctx_t* ctx))
 {
 #if defined(IMGUI_BACKEND_GLFW)
@@ -38,6 +512,7 @@ void ImGuiAdapter(imgui_ctx_t* gui, void(*callback)(imgui_ctx_t* ctx))
 #if defined(IMGUI_BACKEND_GLFW)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    glfwWindowHint(GLFW_VISIBLE, gui->window.hidden ? GLFW_FALSE : GLFW_TRUE);
 #elif defined(IMGUI_BACKEND_SDL)
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
@@ -49,26 +524,32 @@ void ImGuiAdapter(imgui_ctx_t* gui, void(*callback)(imgui_ctx_t* ctx))
 #if defined(IMGUI_BACKEND_GLFW)
     GLFWwindow* window = glfwCreateWindow(gui->window.x, gui->window.y, gui->window.title, NULL, NULL);
     assert(window != NULL);
+    s_adapter.window = window;
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
 #elif defined(IMGUI_BACKEND_SDL)
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
     SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
-    SDL_WindowFlags window_flags = (SDL_WindowFlags)(SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+    SDL_WindowFlags window_flags = (SDL_WindowFlags)(SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI
+        | (gui->window.hidden ? SDL_WINDOW_HIDDEN : 0));
     SDL_Window* window = SDL_CreateWindow(gui->window.title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
         gui->window.x, gui->window.y, window_flags);
     SDL_GLContext gl_context = SDL_GL_CreateContext(window);
+    s_adapter.window = window;
+    s_adapter.done = false;
     SDL_GL_MakeCurrent(window, gl_context);
     SDL_GL_SetSwapInterval(1); // Enable vsync
 #endif
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    imgui_alloc_install((imgui_alloc_mode_t)gui->allocator);
     ImGui::CreateContext();
     ImPlot::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     io.IniFilename = NULL;
+    io.ConfigMemoryCompactTimer = gui->compact_timer;
 #if 0
     io.Fonts->AddFontFromMemoryCompressedTTF(sarasa_compressed_data,
         sarasa_compressed_size, 16.0f, NULL, io.Fonts->GetGlyphRangesChineseFull());
@@ -78,64 +559,67 @@ void ImGuiAdapter(imgui_ctx_t* gui, void(*callback)(imgui_ctx_t* ctx))
 
     // Setup Platform/Renderer backends
 #if defined(IMGUI_BACKEND_GLFW)
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplGlfw_InitForOpenGL(window, false);
+    _adapter_install_callbacks(window);
 #elif defined(IMGUI_BACKEND_SDL)
     ImGui_ImplSDL2_InitForOpenGL(window, gl_context);
 #endif
     ImGui_ImplOpenGL3_Init(glsl_version);
+    imgui_capture_init(_adapter_get_proc, gui->fps);
+    imgui_implot_static_init(_adapter_get_proc);
+    _adapter_gl_init();
+    s_adapter.exit = false;
 
     // Main loop
 #if defined(IMGUI_BACKEND_GLFW)
-    while (!glfwWindowShouldClose(window))
+    while (!glfwWindowShouldClose(window) && gui->looping && !s_adapter.exit)
 #elif defined(IMGUI_BACKEND_SDL)
-    bool done = false;
-    while (!done && gui->looping)
+    while (!s_adapter.done && gui->looping && !s_adapter.exit)
 #endif
     {
-#if defined(IMGUI_BACKEND_GLFW)
-        glfwPollEvents();
-#elif defined(IMGUI_BACKEND_SDL)
-        SDL_Event event;
-        while (SDL_PollEvent(&event))
-        {
-            ImGui_ImplSDL2_ProcessEvent(&event);
-            if (event.type == SDL_QUIT)
-                done = true;
-            if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
-                done = true;
-        }
-#endif
+        uint64_t frame_begin = api->misc->hrtime();
+        IMGUI_TRACE_BEGIN("frame");
+        IMGUI_TRACE_BEGIN("poll");
+        _adapter_poll_events();
+        _adapter_replay_events();
+        IMGUI_TRACE_END();
 
         // Start the Dear ImGui frame
+        IMGUI_TRACE_BEGIN("new_frame");
         ImGui_ImplOpenGL3_NewFrame();
 #if defined(IMGUI_BACKEND_GLFW)
         ImGui_ImplGlfw_NewFrame();
 #elif defined(IMGUI_BACKEND_SDL)
         ImGui_ImplSDL2_NewFrame();
 #endif
+        _adapter_playback();
         ImGui::NewFrame();
+        IMGUI_TRACE_END();
 
         // GUI
         callback(gui);
 
         // Rendering
+        IMGUI_TRACE_BEGIN("render");
         ImGui::Render();
-#if defined(IMGUI_BACKEND_GLFW)
-        int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
-#endif
-        glViewport(0, 0, (int)io.DisplaySize.x, (int)io.DisplaySize.y);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        ImDrawData* draw_data = ImGui::GetDrawData();
+        IMGUI_TRACE_END();
 
-#if defined(IMGUI_BACKEND_GLFW)
-        glfwSwapBuffers(window);
-#elif defined(IMGUI_BACKEND_SDL)
-        SDL_GL_SwapWindow(window);
-#endif
+        IMGUI_TRACE_BEGIN("present");
+        _adapter_present(draw_data, gui->frame_deadline != 0);
+        IMGUI_TRACE_END();
+        IMGUI_TRACE_END();
+
+        /* Frame cost does not include time slept for frame rate limit */
+        uint64_t cost = api->misc->hrtime() - frame_begin;
+        imgui_playback_record(cost > gui->slept ? cost - gui->slept : 0);
     }
 
     // Cleanup
+    _adapter_free_frame();
+    _adapter_run_atexit();
+    s_adapter.events.clear();
+    imgui_capture_exit();
     ImGui_ImplOpenGL3_Shutdown();
 #if defined(IMGUI_BACKEND_GLFW)
     ImGui_ImplGlfw_Shutdown();
@@ -153,4 +637,5 @@ void ImGuiAdapter(imgui_ctx_t* gui, void(*callback)(imgui_ctx_t* ctx))
     SDL_DestroyWindow(window);
     SDL_Quit();
 #endif
+    s_adapter.window = NULL;
 }
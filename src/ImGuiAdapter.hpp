@@ -2,30 +2,69 @@
 #define __IMGUI_ADAPTER_HPP__
 
 #include <autodo.h>
+#include <imgui.h>
 
 typedef struct imgui_ctx
 {
     auto_coroutine_t*   co;
 
     auto_thread_t*      gui_thr;
-    auto_sem_t*         sem;
+    struct imgui_frame_sync* sync;      /**< Signaled when user function finished a frame. */
     auto_notify_t*      nfy_gui_update;
 
     uint64_t            now_time;
     uint64_t            last_frame;
+    uint64_t            slept;          /**< Time slept for frame rate limit in last frame. */
+    uint64_t            wakeup;         /**< Time GUI thread asked for next frame. */
 
     int                 looping;
     int                 fps;
     uint64_t            fps_delay;
+    uint64_t            frame_deadline; /**< Time to wait for user function in nanoseconds, 0 to wait forever. */
+
+    int                 allocator;      /**< #imgui_alloc_mode_t of ImGui and ImPlot. */
+    float               compact_timer;  /**< Seconds before buffers of idle window are freed, negative to disable. */
 
     struct
     {
         int             x;
         int             y;
         char*           title;
+        int             hidden;     /**< Create window hidden, for automated runs. */
     } window;
 } imgui_ctx_t;
 
 AUTO_LOCAL void ImGuiAdapter(imgui_ctx_t* ctx, void(*callback)(imgui_ctx_t* ctx));
 
+/**
+ * @brief Keep window responsive while user function is late.
+ *
+ * Pump platform events and present a copy of the pixels of last completed
+ * frame again. ImGui is not touched: events are queued and handed to ImGui
+ * before next frame.
+ *
+ * @note Must be called on GUI thread, inside \p callback of #ImGuiAdapter().
+ * @param[in] ctx   GUI context.
+ */
+AUTO_LOCAL void ImGuiAdapterIdle(imgui_ctx_t* ctx);
+
+/**
+ * @brief Check whether window has input focus.
+ * @note Must be called on GUI thread.
+ * @return          Boolean.
+ */
+AUTO_LOCAL bool ImGuiAdapterFocused(void);
+
+/**
+ * @brief Register a function called on GUI thread when the loop ends.
+ *
+ * OpenGL and ImGui contexts are still current, so cached GPU resources can be
+ * released. The next loop creates new contexts, where such resources are not
+ * valid any more. Registering the same function again has no effect.
+ *
+ * @note Can be called from any thread.
+ * @param[in] fn    Function.
+ */
+AUTO_LOCAL void ImGuiAdapterAtExit(void (*fn)(void));
+
 #endif
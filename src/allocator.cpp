@@ -0,0 +1,288 @@
+#include <stdlib.h>
+#include <imgui.h>
+#include <mutex>
+#include "allocator.hpp"
+#include "lua_imgui.h"
+
+/**
+ * @brief Bytes of each chunk carved into blocks.
+ */
+#define IMGUI_ALLOC_CHUNK_SIZE  (64 * 1024)
+
+/**
+ * @brief Block sizes of each size class. Larger requests bypass the pool.
+ */
+static const size_t s_alloc_class_size[] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512,
+    640, 768, 896, 1024, 1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096,
+};
+
+#define IMGUI_ALLOC_CLASS_NUM   (sizeof(s_alloc_class_size) / sizeof(s_alloc_class_size[0]))
+
+/**
+ * @brief Requests up to this size are pooled.
+ */
+#define IMGUI_ALLOC_CLASS_MAX   4096
+
+typedef struct imgui_alloc_chunk
+{
+    struct imgui_alloc_chunk*   next;
+    size_t                      used;   /**< Blocks in use. */
+    imgui_alloc_mode_t          source; /**< Mode when chunk was allocated. */
+} imgui_alloc_chunk_t;
+
+/**
+ * @brief Placed before each block. 16 bytes, so blocks keep malloc alignment.
+ */
+typedef struct imgui_alloc_hdr
+{
+    imgui_alloc_chunk_t*        chunk;  /**< Owner chunk, NULL if not pooled. */
+    uint32_t                    cls;    /**< Size class, or mode if not pooled. */
+    uint32_t                    size;   /**< Requested size. */
+} imgui_alloc_hdr_t;
+
+/**
+ * @brief Free block, link is stored in place of user data.
+ */
+typedef struct imgui_alloc_free
+{
+    struct imgui_alloc_free*    next;
+} imgui_alloc_free_t;
+
+typedef struct imgui_alloc_class
+{
+    imgui_alloc_chunk_t*        chunks;
+    imgui_alloc_free_t*         free;
+} imgui_alloc_class_t;
+
+typedef struct imgui_alloc
+{
+    std::mutex                  mutex;
+    imgui_alloc_mode_t          mode;
+    imgui_alloc_class_t         classes[IMGUI_ALLOC_CLASS_NUM];
+    uint8_t                     lookup[IMGUI_ALLOC_CLASS_MAX / 16 + 1];   /**< Class of size in 16 bytes. */
+
+    uint64_t                    live;
+    uint64_t                    peak;
+    uint64_t                    reserved;
+    uint64_t                    allocs;
+    uint64_t                    bytes;          /**< Bytes allocated since start. */
+    uint64_t                    mark_allocs;    /**< #allocs when last frame closed. */
+    uint64_t                    mark_bytes;     /**< #bytes when last frame closed. */
+    uint64_t                    frame_allocs;
+    uint64_t                    frame_bytes;
+} imgui_alloc_t;
+
+static imgui_alloc_t s_alloc;
+
+static void* _alloc_sys_malloc(size_t size)
+{
+    return s_alloc.mode == IMGUI_ALLOC_AUTODO ? api->memory->malloc(size) : malloc(size);
+}
+
+/**
+ * @brief Free memory from #_alloc_sys_malloc(). Mode may have changed since,
+ *   so the caller tells where it came from.
+ */
+static void _alloc_sys_free(void* ptr, imgui_alloc_mode_t source)
+{
+    if (source == IMGUI_ALLOC_AUTODO)
+    {
+        api->memory->free(ptr);
+        return;
+    }
+    free(ptr);
+}
+
+static size_t _alloc_block_size(size_t cls)
+{
+    return sizeof(imgui_alloc_hdr_t) + s_alloc_class_size[cls];
+}
+
+/**
+ * @brief Allocate a chunk and carve it into free blocks of \p cls.
+ * @note Must be called with mutex locked.
+ */
+static int _alloc_grow(size_t cls)
+{
+    imgui_alloc_chunk_t* chunk = (imgui_alloc_chunk_t*)_alloc_sys_malloc(IMGUI_ALLOC_CHUNK_SIZE);
+    if (chunk == NULL)
+    {
+        return -1;
+    }
+    chunk->used = 0;
+    chunk->source = s_alloc.mode;
+    chunk->next = s_alloc.classes[cls].chunks;
+    s_alloc.classes[cls].chunks = chunk;
+    s_alloc.reserved += IMGUI_ALLOC_CHUNK_SIZE;
+
+    /* Blocks start after chunk header, rounded up to 16 bytes */
+    const size_t block = _alloc_block_size(cls);
+    const size_t first = (sizeof(imgui_alloc_chunk_t) + 15) & ~(size_t)15;
+    for (size_t off = first; off + block <= IMGUI_ALLOC_CHUNK_SIZE; off += block)
+    {
+        imgui_alloc_hdr_t* hdr = (imgui_alloc_hdr_t*)((char*)chunk + off);
+        hdr->chunk = chunk;
+        hdr->cls = (uint32_t)cls;
+
+        imgui_alloc_free_t* node = (imgui_alloc_free_t*)(hdr + 1);
+        node->next = s_alloc.classes[cls].free;
+        s_alloc.classes[cls].free = node;
+    }
+    return 0;
+}
+
+static void _alloc_account(size_t size)
+{
+    s_alloc.live += size;
+    s_alloc.peak = s_alloc.live > s_alloc.peak ? s_alloc.live : s_alloc.peak;
+    s_alloc.allocs++;
+    s_alloc.bytes += size;
+}
+
+static void* _alloc_malloc(size_t size, void* user_data)
+{
+    (void)user_data;
+    std::lock_guard<std::mutex> guard(s_alloc.mutex);
+
+    imgui_alloc_hdr_t* hdr;
+    if (size > IMGUI_ALLOC_CLASS_MAX || s_alloc.mode == IMGUI_ALLOC_SYSTEM)
+    {
+        hdr = (imgui_alloc_hdr_t*)_alloc_sys_malloc(sizeof(imgui_alloc_hdr_t) + size);
+        if (hdr == NULL)
+        {
+            return NULL;
+        }
+        hdr->chunk = NULL;
+        hdr->cls = (uint32_t)s_alloc.mode;
+        s_alloc.reserved += sizeof(imgui_alloc_hdr_t) + size;
+    }
+    else
+    {
+        size_t cls = s_alloc.lookup[(size + 15) / 16];
+        imgui_alloc_class_t* c = &s_alloc.classes[cls];
+        if (c->free == NULL && _alloc_grow(cls) != 0)
+        {
+            return NULL;
+        }
+
+        imgui_alloc_free_t* node = c->free;
+        c->free = node->next;
+        hdr = (imgui_alloc_hdr_t*)node - 1;
+        hdr->chunk->used++;
+    }
+
+    hdr->size = (uint32_t)size;
+    _alloc_account(size);
+    return hdr + 1;
+}
+
+static void _alloc_free(void* ptr, void* user_data)
+{
+    (void)user_data;
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_alloc.mutex);
+    imgui_alloc_hdr_t* hdr = (imgui_alloc_hdr_t*)ptr - 1;
+    s_alloc.live -= hdr->size;
+
+    if (hdr->chunk == NULL)
+    {
+        s_alloc.reserved -= sizeof(imgui_alloc_hdr_t) + hdr->size;
+        _alloc_sys_free(hdr, (imgui_alloc_mode_t)hdr->cls);
+        return;
+    }
+
+    imgui_alloc_class_t* c = &s_alloc.classes[hdr->cls];
+    imgui_alloc_free_t* node = (imgui_alloc_free_t*)ptr;
+    node->next = c->free;
+    c->free = node;
+    hdr->chunk->used--;
+}
+
+void imgui_alloc_install(imgui_alloc_mode_t mode)
+{
+    {
+        /*
+         * Blocks remember where they came from, so memory allocated before
+         * a mode change is still freed correctly.
+         */
+        std::lock_guard<std::mutex> guard(s_alloc.mutex);
+        s_alloc.mode = mode;
+
+        for (size_t i = 0, cls = 0; i <= IMGUI_ALLOC_CLASS_MAX / 16; i++)
+        {
+            while (s_alloc_class_size[cls] < i * 16)
+            {
+                cls++;
+            }
+            s_alloc.lookup[i] = (uint8_t)cls;
+        }
+    }
+
+    ImGui::SetAllocatorFunctions(_alloc_malloc, _alloc_free, NULL);
+}
+
+void imgui_alloc_frame(void)
+{
+    std::lock_guard<std::mutex> guard(s_alloc.mutex);
+    s_alloc.frame_allocs = s_alloc.allocs - s_alloc.mark_allocs;
+    s_alloc.frame_bytes = s_alloc.bytes - s_alloc.mark_bytes;
+    s_alloc.mark_allocs = s_alloc.allocs;
+    s_alloc.mark_bytes = s_alloc.bytes;
+}
+
+uint64_t imgui_alloc_trim(void)
+{
+    std::lock_guard<std::mutex> guard(s_alloc.mutex);
+
+    uint64_t released = 0;
+    for (size_t cls = 0; cls < IMGUI_ALLOC_CLASS_NUM; cls++)
+    {
+        imgui_alloc_class_t* c = &s_alloc.classes[cls];
+
+        /* Unlink free blocks of idle chunks */
+        imgui_alloc_free_t** link = &c->free;
+        while (*link != NULL)
+        {
+            imgui_alloc_hdr_t* hdr = (imgui_alloc_hdr_t*)*link - 1;
+            if (hdr->chunk->used == 0)
+            {
+                *link = (*link)->next;
+                continue;
+            }
+            link = &(*link)->next;
+        }
+
+        imgui_alloc_chunk_t** pchunk = &c->chunks;
+        while (*pchunk != NULL)
+        {
+            imgui_alloc_chunk_t* chunk = *pchunk;
+            if (chunk->used != 0)
+            {
+                pchunk = &chunk->next;
+                continue;
+            }
+            *pchunk = chunk->next;
+            _alloc_sys_free(chunk, chunk->source);
+            released += IMGUI_ALLOC_CHUNK_SIZE;
+        }
+    }
+
+    s_alloc.reserved -= released;
+    return released;
+}
+
+void imgui_alloc_stats(imgui_alloc_stats_t* stats)
+{
+    std::lock_guard<std::mutex> guard(s_alloc.mutex);
+    stats->live = s_alloc.live;
+    stats->peak = s_alloc.peak;
+    stats->reserved = s_alloc.reserved;
+    stats->allocs = s_alloc.allocs;
+    stats->frame_allocs = s_alloc.frame_allocs;
+    stats->frame_bytes = s_alloc.frame_bytes;
+}
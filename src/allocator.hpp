@@ -0,0 +1,56 @@
+#ifndef __IMGUI_ALLOCATOR_HPP__
+#define __IMGUI_ALLOCATOR_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Where ImGui and ImPlot get memory from.
+ */
+typedef enum imgui_alloc_mode
+{
+    IMGUI_ALLOC_SYSTEM,     /**< malloc(3) for every request, only accounting. */
+    IMGUI_ALLOC_POOL,       /**< Size class pool, chunks from malloc(3). */
+    IMGUI_ALLOC_AUTODO,     /**< Size class pool, chunks from autodo memory API. */
+} imgui_alloc_mode_t;
+
+/**
+ * @brief Allocator accounting.
+ */
+typedef struct imgui_alloc_stats
+{
+    uint64_t    live;           /**< Bytes requested and not freed. */
+    uint64_t    peak;           /**< Highest #live. */
+    uint64_t    reserved;       /**< Bytes held by pool, including free blocks. */
+    uint64_t    allocs;         /**< Allocations since start. */
+    uint64_t    frame_allocs;   /**< Allocations in last frame. */
+    uint64_t    frame_bytes;    /**< Bytes allocated in last frame. */
+} imgui_alloc_stats_t;
+
+/**
+ * @brief Install allocator for ImGui and ImPlot.
+ * @note Must be called before ImGui::CreateContext(). ImPlot allocates
+ *   through ImGui, so it uses the same allocator. Mode can be changed later,
+ *   memory allocated before is still freed correctly.
+ * @param[in] mode      Allocator mode.
+ */
+AUTO_LOCAL void imgui_alloc_install(imgui_alloc_mode_t mode);
+
+/**
+ * @brief Close accounting of a frame.
+ * @note Called once per frame on GUI thread.
+ */
+AUTO_LOCAL void imgui_alloc_frame(void);
+
+/**
+ * @brief Release pool chunks that have no block in use.
+ * @return              Bytes released.
+ */
+AUTO_LOCAL uint64_t imgui_alloc_trim(void);
+
+/**
+ * @brief Get allocator accounting.
+ * @param[out] stats    Accounting.
+ */
+AUTO_LOCAL void imgui_alloc_stats(imgui_alloc_stats_t* stats);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef __IMGUI_BUFFER_HPP__
+#define __IMGUI_BUFFER_HPP__
+
+#include "series.hpp"
+
+struct imgui_buffer_spill;
+
+/**
+ * @brief Native typed buffer.
+ *
+ * A buffer is either growable, or a ring buffer with fixed capacity that
+ * overwrite oldest element when full. Every modification assign a new
+ * version, so derived data can be cached by version.
+ */
+typedef struct imgui_buffer
+{
+    imgui_dtype_t       type;       /**< Element type. */
+    size_t              elem_size;  /**< Element size in bytes. */
+    char*               data;       /**< Element storage. */
+    size_t              size;       /**< The number of elements. */
+    size_t              capacity;   /**< The number of allocated elements. */
+    size_t              head;       /**< Index of oldest element, only non-zero for full ring buffer. */
+    int                 ring;       /**< Whether this is a ring buffer. */
+    uint64_t            version;    /**< Data version. */
+    uint64_t            total;      /**< The number of elements ever appended. */
+    uint64_t            epoch;      /**< Changed when existing elements are modified or removed. */
+    struct imgui_buffer_spill* spill;/**< Spill state, NULL if not spilling. */
+} imgui_buffer_t;
+
+/**
+ * @brief Create buffer and push it onto stack.
+ * @param[in] L         Lua VM.
+ * @param[in] type      Element type.
+ * @param[in] capacity  Ring buffer capacity, or 0 for growable buffer.
+ * @return              Buffer object.
+ */
+AUTO_LOCAL imgui_buffer_t* imgui_buffer_new(lua_State* L, imgui_dtype_t type, size_t capacity);
+
+/**
+ * @brief Checks whether the function argument \p arg is a buffer.
+ * @param[in] L     Lua VM.
+ * @param[in] arg   Argument index.
+ * @return          Buffer object.
+ */
+AUTO_LOCAL imgui_buffer_t* imgui_buffer_check(lua_State* L, int arg);
+
+/**
+ * @brief Test whether the function argument \p arg is a buffer that spills
+ *   to file.
+ * @param[in] L     Lua VM.
+ * @param[in] arg   Argument index.
+ * @return          Buffer object, or NULL.
+ */
+AUTO_LOCAL imgui_buffer_t* imgui_buffer_test_spill(lua_State* L, int arg);
+
+/**
+ * @brief Describe elements [\p beg, \p end) of the whole history of a
+ *   spilling buffer as a contiguous series.
+ * @see #imgui_buffer_spill_read()
+ * @param[in] buf       Spilling buffer.
+ * @param[in] beg       First element.
+ * @param[in] end       One past last element.
+ * @param[out] series   Series view, valid until next call.
+ */
+AUTO_LOCAL void imgui_buffer_window(imgui_buffer_t* buf, size_t beg, size_t end, imgui_series_t* series);
+
+/**
+ * @brief Append value to buffer.
+ * @note Version is not updated, call #imgui_buffer_touch() after modification.
+ * @param[in] buf   Buffer object.
+ * @param[in] v     Value.
+ * @return          0 if success, ENOMEM if the buffer cannot grow.
+ */
+AUTO_LOCAL int imgui_buffer_push(imgui_buffer_t* buf, double v);
+
+/**
+ * @brief Remove all elements.
+ * @note Version is not updated, call #imgui_buffer_touch() after modification.
+ * @param[in] buf   Buffer object.
+ */
+AUTO_LOCAL void imgui_buffer_clear(imgui_buffer_t* buf);
+
+/**
+ * @brief Get address of element.
+ * @param[in] buf   Buffer object.
+ * @param[in] idx   Logical index, 0 is oldest.
+ * @return          Element address.
+ */
+AUTO_LOCAL void* imgui_buffer_at(imgui_buffer_t* buf, size_t idx);
+
+/**
+ * @brief Assign a new version to buffer.
+ * @param[in] buf   Buffer object.
+ */
+AUTO_LOCAL void imgui_buffer_touch(imgui_buffer_t* buf);
+
+#endif
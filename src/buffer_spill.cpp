@@ -0,0 +1,335 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "buffer_spill.hpp"
+#include "file_map.hpp"
+#include "lua_imgui.h"
+
+/**
+ * @brief Sparse index entry, one for each segment.
+ */
+typedef struct imgui_buffer_segment
+{
+    size_t                  first;      /**< Element index of first element. */
+    size_t                  count;      /**< The number of elements. */
+    size_t                  offset;     /**< Position in file, in bytes. */
+    char*                   mem;        /**< Copy of elements until written, NULL after. */
+} imgui_buffer_segment_t;
+
+struct imgui_buffer_spill
+{
+    std::string             path;
+    FILE*                   file;
+    size_t                  elem_size;
+    size_t                  segment;    /**< Elements per segment. */
+    size_t                  pending;    /**< Elements appended since last segment. */
+    size_t                  total;      /**< Elements appended since spilling started. */
+    size_t                  queued;     /**< Bytes queued for write. */
+    size_t                  written;    /**< Elements written to file. */
+    double                  v_min;
+    double                  v_max;
+
+    /* Shared with writer thread */
+    std::mutex                          mutex;
+    std::vector<imgui_buffer_segment_t> index;
+    std::deque<size_t>                  queue;      /**< Index entries to write. */
+    bool                                looping;
+    bool                                failed;     /**< Write failed, later segments stay in memory. */
+    auto_sem_t*                         sem;
+    auto_thread_t*                      thread;
+
+    /* Used by Lua thread only */
+    imgui_file_map_t        map;
+    std::vector<char>       window;
+    uint64_t                win_version;
+    size_t                  win_beg;
+    size_t                  win_end;
+};
+
+static void _spill_writer(void* arg)
+{
+    imgui_buffer_spill* s = (imgui_buffer_spill*)arg;
+
+    for (;;)
+    {
+        api->sem->wait(s->sem);
+
+        size_t pos;
+        imgui_buffer_segment_t seg;
+        {
+            std::lock_guard<std::mutex> guard(s->mutex);
+            if (s->queue.empty())
+            {
+                if (!s->looping)
+                {
+                    return;
+                }
+                continue;
+            }
+            pos = s->queue.front();
+            s->queue.pop_front();
+            seg = s->index[pos];
+        }
+
+        /*
+         * Offsets are assigned when queued, so once a write failed nothing
+         * after it can be written. Elements stay in memory instead.
+         */
+        size_t bytes = seg.count * s->elem_size;
+        if (s->failed || fwrite(seg.mem, 1, bytes, s->file) != bytes || fflush(s->file) != 0)
+        {
+            s->failed = true;
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(s->mutex);
+            s->index[pos].mem = NULL;
+            s->written += seg.count;
+        }
+        free(seg.mem);
+    }
+}
+
+/**
+ * @brief Get address of element \p idx of ring, 0 is oldest.
+ */
+static const char* _spill_ring_at(const imgui_buffer_t* buf, size_t idx)
+{
+    idx += buf->head;
+    idx = idx < buf->capacity ? idx : idx - buf->capacity;
+    return buf->data + idx * buf->elem_size;
+}
+
+/**
+ * @brief Queue last \p n elements of ring as a new segment.
+ */
+static void _spill_segment(imgui_buffer_t* buf, size_t n)
+{
+    imgui_buffer_spill* s = buf->spill;
+
+    imgui_buffer_segment_t seg;
+    seg.first = s->total - n;
+    seg.count = n;
+    seg.offset = s->queued;
+    seg.mem = (char*)malloc(n * s->elem_size);
+    for (size_t i = 0; i < n; i++)
+    {
+        memcpy(seg.mem + i * s->elem_size, _spill_ring_at(buf, buf->size - n + i), s->elem_size);
+    }
+    s->queued += n * s->elem_size;
+    s->pending = 0;
+
+    {
+        std::lock_guard<std::mutex> guard(s->mutex);
+        s->index.push_back(seg);
+        s->queue.push_back(s->index.size() - 1);
+    }
+    api->sem->post(s->sem);
+}
+
+int imgui_buffer_spill_open(imgui_buffer_t* buf, const char* path, size_t segment)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return errno;
+    }
+
+    imgui_buffer_spill* s = new imgui_buffer_spill;
+    s->path = path;
+    s->file = file;
+    s->elem_size = buf->elem_size;
+    s->segment = segment;
+    s->pending = 0;
+    s->total = buf->size;
+    s->queued = 0;
+    s->written = 0;
+    s->v_min = 0;
+    s->v_max = 0;
+    s->looping = true;
+    s->failed = false;
+    s->sem = api->sem->create(0);
+    memset(&s->map, 0, sizeof(s->map));
+    s->win_version = 0;
+    s->win_beg = 0;
+    s->win_end = 0;
+
+    imgui_series_t series;
+    memset(&series, 0, sizeof(series));
+    series.data = buf->data;
+    series.count = buf->size;
+    series.stride = buf->elem_size;
+    series.type = buf->type;
+    for (size_t i = 0; i < buf->size; i++)
+    {
+        double v = imgui_series_get(&series, (i + buf->head) % buf->capacity);
+        s->v_min = i == 0 || v < s->v_min ? v : s->v_min;
+        s->v_max = i == 0 || v > s->v_max ? v : s->v_max;
+    }
+
+    buf->spill = s;
+    s->thread = api->thread->create(_spill_writer, s);
+
+    if (buf->size != 0)
+    {
+        _spill_segment(buf, buf->size);
+    }
+    return 0;
+}
+
+void imgui_buffer_spill_close(imgui_buffer_t* buf)
+{
+    imgui_buffer_spill* s = buf->spill;
+    if (s == NULL)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(s->mutex);
+        s->looping = false;
+    }
+    api->sem->post(s->sem);
+    api->thread->join(s->thread);
+    api->sem->destroy(s->sem);
+
+    fclose(s->file);
+    imgui_file_unmap(&s->map);
+    for (size_t i = 0; i < s->index.size(); i++)
+    {
+        free(s->index[i].mem);
+    }
+
+    delete s;
+    buf->spill = NULL;
+}
+
+void imgui_buffer_spill_push(imgui_buffer_t* buf, double v)
+{
+    imgui_buffer_spill* s = buf->spill;
+
+    s->v_min = s->total == 0 || v < s->v_min ? v : s->v_min;
+    s->v_max = s->total == 0 || v > s->v_max ? v : s->v_max;
+    s->total++;
+
+    if (++s->pending >= s->segment)
+    {
+        _spill_segment(buf, s->pending);
+    }
+}
+
+void imgui_buffer_spill_flush(imgui_buffer_t* buf)
+{
+    imgui_buffer_spill* s = buf->spill;
+    if (s->pending != 0)
+    {
+        _spill_segment(buf, s->pending);
+    }
+}
+
+/**
+ * @brief Find data of segment \p pos, mapping file again if it has grown.
+ * @note Must be called with mutex locked.
+ */
+static const char* _spill_segment_data(imgui_buffer_spill* s, size_t pos)
+{
+    const imgui_buffer_segment_t* seg = &s->index[pos];
+    if (seg->mem != NULL)
+    {
+        return seg->mem;
+    }
+
+    size_t end = seg->offset + seg->count * s->elem_size;
+    if (end > s->map.size)
+    {
+        imgui_file_unmap(&s->map);
+        if (imgui_file_map(&s->map, s->path.c_str()) != 0 || end > s->map.size)
+        {
+            return NULL;
+        }
+    }
+    return s->map.data + seg->offset;
+}
+
+const void* imgui_buffer_spill_read(imgui_buffer_t* buf, size_t beg, size_t end)
+{
+    imgui_buffer_spill* s = buf->spill;
+    if (s->win_version == buf->version && s->win_beg == beg && s->win_end == end)
+    {
+        return s->window.data();
+    }
+
+    const size_t elem_size = s->elem_size;
+    const size_t ring_start = s->total - buf->size;
+    s->window.resize((end > beg ? end - beg : 1) * elem_size);
+    char* dst = s->window.data();
+    size_t i = beg;
+
+    if (i < ring_start)
+    {
+        std::lock_guard<std::mutex> guard(s->mutex);
+
+        /* Last segment that starts before the first element */
+        size_t lo = 0, hi = s->index.size();
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (s->index[mid].first <= i) lo = mid + 1; else hi = mid;
+        }
+
+        for (size_t pos = lo > 0 ? lo - 1 : 0; i < end && i < ring_start; pos++)
+        {
+            size_t stop = end < ring_start ? end : ring_start;
+            if (pos >= s->index.size())
+            {
+                memset(dst, 0, (stop - i) * elem_size);
+                dst += (stop - i) * elem_size;
+                i = stop;
+                break;
+            }
+
+            const imgui_buffer_segment_t* seg = &s->index[pos];
+            size_t seg_end = seg->first + seg->count;
+            size_t n = (seg_end < stop ? seg_end : stop) - i;
+            const char* src = _spill_segment_data(s, pos);
+            if (src != NULL)
+            {
+                memcpy(dst, src + (i - seg->first) * elem_size, n * elem_size);
+            }
+            else
+            {
+                memset(dst, 0, n * elem_size);
+            }
+            dst += n * elem_size;
+            i += n;
+        }
+    }
+
+    for (; i < end; i++)
+    {
+        memcpy(dst, _spill_ring_at(buf, i - ring_start), elem_size);
+        dst += elem_size;
+    }
+
+    s->win_version = buf->version;
+    s->win_beg = beg;
+    s->win_end = end;
+    return s->window.data();
+}
+
+void imgui_buffer_spill_bounds(imgui_buffer_t* buf, size_t* total, size_t* spilled,
+    double* v_min, double* v_max)
+{
+    imgui_buffer_spill* s = buf->spill;
+    *total = s->total;
+    *v_min = s->v_min;
+    *v_max = s->v_max;
+
+    std::lock_guard<std::mutex> guard(s->mutex);
+    *spilled = s->written;
+}
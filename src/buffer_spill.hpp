@@ -0,0 +1,64 @@
+#ifndef __IMGUI_BUFFER_SPILL_HPP__
+#define __IMGUI_BUFFER_SPILL_HPP__
+
+#include "buffer.hpp"
+
+/**
+ * @brief Start spilling ring buffer to file.
+ *
+ * Every \p segment elements appended are copied and written to the end of
+ * file on a background thread. Current elements are spilled immediately.
+ *
+ * @param[in] buf       Ring buffer, must not be spilling.
+ * @param[in] path      File path, truncated if exists.
+ * @param[in] segment   Elements per segment, in range [1, capacity].
+ * @return              0 if success, otherwise errno.
+ */
+AUTO_LOCAL int imgui_buffer_spill_open(imgui_buffer_t* buf, const char* path, size_t segment);
+
+/**
+ * @brief Wait for pending writes, close file and stop spilling.
+ * @param[in] buf       Buffer.
+ */
+AUTO_LOCAL void imgui_buffer_spill_close(imgui_buffer_t* buf);
+
+/**
+ * @brief Track appended element, and spill a segment if it is complete.
+ * @note Called after \p v is stored.
+ * @param[in] buf       Buffer.
+ * @param[in] v         Value just appended.
+ */
+AUTO_LOCAL void imgui_buffer_spill_push(imgui_buffer_t* buf, double v);
+
+/**
+ * @brief Spill elements that are not in a segment yet.
+ * @param[in] buf       Buffer.
+ */
+AUTO_LOCAL void imgui_buffer_spill_flush(imgui_buffer_t* buf);
+
+/**
+ * @brief Get elements [\p beg, \p end) of the whole history.
+ *
+ * Element 0 is the first element when spilling started. Old elements are
+ * read from file through a read-only mapping, recent elements from the ring.
+ * Result is kept until version or range changes.
+ *
+ * @param[in] buf       Buffer.
+ * @param[in] beg       First element.
+ * @param[in] end       One past last element, at most #imgui_buffer_spill_bounds() total.
+ * @return              Contiguous elements, valid until next call.
+ */
+AUTO_LOCAL const void* imgui_buffer_spill_read(imgui_buffer_t* buf, size_t beg, size_t end);
+
+/**
+ * @brief Get size and value range of the whole history.
+ * @param[in] buf       Buffer.
+ * @param[out] total    The number of elements appended since spilling started.
+ * @param[out] spilled  The number of elements written to file.
+ * @param[out] v_min    Minimum value.
+ * @param[out] v_max    Maximum value.
+ */
+AUTO_LOCAL void imgui_buffer_spill_bounds(imgui_buffer_t* buf, size_t* total, size_t* spilled,
+    double* v_min, double* v_max);
+
+#endif
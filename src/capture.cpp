@@ -0,0 +1,723 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+#include "capture.hpp"
+#include "lua_imgui.h"
+#include "thread_pool.hpp"
+
+/**
+ * @brief The number of pixel pack buffers in rotation.
+ */
+#define IMGUI_CAPTURE_SLOTS     3
+
+/**
+ * @brief Frames between starting a readback and mapping its buffer.
+ */
+#define IMGUI_CAPTURE_LATENCY   2
+
+/**
+ * @brief Stream frames waiting to be written. Frames beyond this are dropped
+ *   until the writer catches up.
+ */
+#define IMGUI_CAPTURE_STREAM_QUEUE  4
+
+#if defined(_WIN32)
+#   define IMGUI_CAPTURE_APIENTRY   __stdcall
+#else
+#   define IMGUI_CAPTURE_APIENTRY
+#endif
+
+#define IMGUI_GL_UNSIGNED_BYTE      0x1401
+#define IMGUI_GL_RGBA               0x1908
+#define IMGUI_GL_PACK_ALIGNMENT     0x0D05
+#define IMGUI_GL_PIXEL_PACK_BUFFER  0x88EB
+#define IMGUI_GL_STREAM_READ        0x88E1
+#define IMGUI_GL_MAP_READ_BIT       0x0001
+
+/**
+ * @brief OpenGL functions used by capture. ImGui only loads what its
+ *   renderer needs, so they are loaded here.
+ */
+typedef struct imgui_capture_gl
+{
+    void (IMGUI_CAPTURE_APIENTRY *GenBuffers)(int n, unsigned* buffers);
+    void (IMGUI_CAPTURE_APIENTRY *DeleteBuffers)(int n, const unsigned* buffers);
+    void (IMGUI_CAPTURE_APIENTRY *BindBuffer)(unsigned target, unsigned buffer);
+    void (IMGUI_CAPTURE_APIENTRY *BufferData)(unsigned target, ptrdiff_t size, const void* data, unsigned usage);
+    void* (IMGUI_CAPTURE_APIENTRY *MapBufferRange)(unsigned target, ptrdiff_t offset, ptrdiff_t length, unsigned access);
+    unsigned char (IMGUI_CAPTURE_APIENTRY *UnmapBuffer)(unsigned target);
+    void (IMGUI_CAPTURE_APIENTRY *PixelStorei)(unsigned pname, int param);
+    void (IMGUI_CAPTURE_APIENTRY *ReadPixels)(int x, int y, int width, int height, unsigned format, unsigned type, void* data);
+} imgui_capture_gl_t;
+
+typedef struct imgui_capture_slot
+{
+    unsigned                            pbo;
+    size_t                              capacity;   /**< Bytes allocated for #pbo. */
+    uint64_t                            frame;      /**< Frame readback started, 0 if idle. */
+    int                                 width;
+    int                                 height;
+    uint64_t                            stream;     /**< Stream generation, 0 if not streamed. */
+    std::vector<imgui_capture_result_t> requests;   /**< One-shot captures served by this readback. */
+} imgui_capture_slot_t;
+
+typedef struct imgui_capture_stream
+{
+    FILE*                               file;
+    uint64_t                            generation; /**< Nonzero while accepting frames. */
+    int                                 every;
+    int                                 width;      /**< Fixed by first frame, 0 before. */
+    int                                 height;
+    uint64_t                            written;
+    uint64_t                            dropped;    /**< Frames of other size, or while queue is full. */
+    bool                                header;     /**< Y4M header is written. */
+    bool                                draining;   /**< A task is writing #queue. */
+    std::deque<std::vector<uint8_t>*>   queue;
+} imgui_capture_stream_t;
+
+typedef struct imgui_capture
+{
+    /* Used by GUI thread only */
+    imgui_capture_gl_t                  gl;
+    bool                                gl_ok;
+    imgui_capture_slot_t                slots[IMGUI_CAPTURE_SLOTS];
+    uint64_t                            frame;
+    int                                 fps;
+
+    std::mutex                          mutex;
+    std::vector<imgui_capture_result_t> pending;    /**< Requested, readback not started. */
+    std::vector<imgui_capture_result_t> done;
+    imgui_capture_stream_t              stream;
+    uint64_t                            generation;
+} imgui_capture_t;
+
+typedef struct imgui_capture_png_job
+{
+    imgui_capture_result_t              result;
+    std::vector<uint8_t>                pixels;
+} imgui_capture_png_job_t;
+
+static imgui_capture_t s_capture;
+
+/*
+ * PNG encoding. There is no zlib, so deflate is a single block with fixed
+ * Huffman codes and greedy LZ77 matching, which already does well on UI
+ * screenshots because rows are filtered by the row above.
+ */
+
+static const uint16_t s_len_base[] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t s_len_extra[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t s_dist_base[] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+static const uint8_t s_dist_extra[] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+typedef struct imgui_capture_bits
+{
+    std::vector<uint8_t>*   out;
+    uint32_t                buf;
+    int                     cnt;
+} imgui_capture_bits_t;
+
+static void _capture_put_bits(imgui_capture_bits_t* b, uint32_t bits, int n)
+{
+    b->buf |= bits << b->cnt;
+    b->cnt += n;
+    while (b->cnt >= 8)
+    {
+        b->out->push_back((uint8_t)b->buf);
+        b->buf >>= 8;
+        b->cnt -= 8;
+    }
+}
+
+/**
+ * @brief Huffman codes are packed starting from the most significant bit.
+ */
+static void _capture_put_code(imgui_capture_bits_t* b, uint32_t code, int n)
+{
+    uint32_t rev = 0;
+    for (int i = 0; i < n; i++)
+    {
+        rev = (rev << 1) | ((code >> i) & 1);
+    }
+    _capture_put_bits(b, rev, n);
+}
+
+static void _capture_put_symbol(imgui_capture_bits_t* b, int sym)
+{
+    if (sym < 144)
+    {
+        _capture_put_code(b, 0x30 + sym, 8);
+    }
+    else if (sym < 256)
+    {
+        _capture_put_code(b, 0x190 + sym - 144, 9);
+    }
+    else if (sym < 280)
+    {
+        _capture_put_code(b, sym - 256, 7);
+    }
+    else
+    {
+        _capture_put_code(b, 0xC0 + sym - 280, 8);
+    }
+}
+
+static void _capture_put_match(imgui_capture_bits_t* b, int len, int dist)
+{
+    int li = 28;
+    while (s_len_base[li] > len)
+    {
+        li--;
+    }
+    _capture_put_symbol(b, 257 + li);
+    _capture_put_bits(b, len - s_len_base[li], s_len_extra[li]);
+
+    int di = 29;
+    while (s_dist_base[di] > dist)
+    {
+        di--;
+    }
+    _capture_put_code(b, di, 5);
+    _capture_put_bits(b, dist - s_dist_base[di], s_dist_extra[di]);
+}
+
+static void _capture_deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+{
+    const size_t window = 32768;
+    const int max_len = 258;
+    std::vector<uint32_t> head(1 << 15, UINT32_MAX);
+
+    imgui_capture_bits_t b = { &out, 0, 0 };
+    _capture_put_bits(&b, 1, 1);    /* BFINAL */
+    _capture_put_bits(&b, 1, 2);    /* Fixed Huffman */
+
+    size_t i = 0;
+    while (i < size)
+    {
+        int len = 0;
+        size_t cand = UINT32_MAX;
+        if (i + 3 <= size)
+        {
+            uint32_t h = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & 0x7FFF;
+            cand = head[h];
+            head[h] = (uint32_t)i;
+        }
+
+        if (cand != UINT32_MAX && i - cand <= window)
+        {
+            size_t limit = size - i < (size_t)max_len ? size - i : (size_t)max_len;
+            while ((size_t)len < limit && data[cand + len] == data[i + len])
+            {
+                len++;
+            }
+        }
+
+        if (len >= 3)
+        {
+            _capture_put_match(&b, len, (int)(i - cand));
+            for (size_t j = i + 1; j < i + len && j + 3 <= size; j++)
+            {
+                head[((data[j] << 10) ^ (data[j + 1] << 5) ^ data[j + 2]) & 0x7FFF] = (uint32_t)j;
+            }
+            i += len;
+            continue;
+        }
+
+        _capture_put_symbol(&b, data[i]);
+        i++;
+    }
+
+    _capture_put_symbol(&b, 256);
+    _capture_put_bits(&b, 0, 7);    /* Flush last byte */
+}
+
+static uint32_t _capture_crc(const uint8_t* data, size_t size, uint32_t crc)
+{
+    static uint32_t s_table[256];
+    static std::once_flag s_once;
+    std::call_once(s_once, [] {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            s_table[n] = c;
+        }
+    });
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = s_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void _capture_put_u32(std::vector<uint8_t>& out, uint32_t v)
+{
+    out.push_back((uint8_t)(v >> 24));
+    out.push_back((uint8_t)(v >> 16));
+    out.push_back((uint8_t)(v >> 8));
+    out.push_back((uint8_t)v);
+}
+
+static void _capture_put_chunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size)
+{
+    _capture_put_u32(out, (uint32_t)size);
+    size_t pos = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    _capture_put_u32(out, _capture_crc(out.data() + pos, size + 4, 0));
+}
+
+void imgui_capture_encode_png(const uint8_t* pixels, int width, int height, std::vector<uint8_t>& out)
+{
+    static const uint8_t s_signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.assign(s_signature, s_signature + sizeof(s_signature));
+
+    std::vector<uint8_t> ihdr;
+    _capture_put_u32(ihdr, (uint32_t)width);
+    _capture_put_u32(ihdr, (uint32_t)height);
+    ihdr.push_back(8);      /* Bit depth */
+    ihdr.push_back(6);      /* RGBA */
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    _capture_put_chunk(out, "IHDR", ihdr.data(), ihdr.size());
+
+    /* Every row uses Up filter */
+    const size_t stride = (size_t)width * 4;
+    std::vector<uint8_t> raw((stride + 1) * height);
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t* dst = &raw[(stride + 1) * y];
+        const uint8_t* row = pixels + stride * y;
+        dst[0] = 2;
+        for (size_t x = 0; x < stride; x++)
+        {
+            dst[1 + x] = (uint8_t)(row[x] - (y > 0 ? row[x - stride] : 0));
+        }
+    }
+
+    std::vector<uint8_t> z;
+    z.push_back(0x78);
+    z.push_back(0x01);
+    _capture_deflate(raw.data(), raw.size(), z);
+
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < raw.size(); i++)
+    {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    _capture_put_u32(z, (b << 16) | a);
+
+    _capture_put_chunk(out, "IDAT", z.data(), z.size());
+    _capture_put_chunk(out, "IEND", NULL, 0);
+}
+
+/*
+ * Workers.
+ */
+
+static void _capture_png_task(void* arg)
+{
+    imgui_capture_png_job_t* job = (imgui_capture_png_job_t*)arg;
+
+    std::vector<uint8_t> png;
+    imgui_capture_encode_png(job->pixels.data(), job->result.width, job->result.height, png);
+
+    FILE* file = fopen(job->result.path.c_str(), "wb");
+    if (file == NULL)
+    {
+        job->result.err = errno;
+    }
+    else
+    {
+        int ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+        if (fclose(file) != 0 || !ok)
+        {
+            job->result.err = errno != 0 ? errno : EIO;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(s_capture.mutex);
+        s_capture.done.push_back(std::move(job->result));
+    }
+    delete job;
+}
+
+/**
+ * @brief Convert RGBA frame to BT.601 limited range YUV 4:4:4 planes.
+ */
+static void _capture_write_y4m(FILE* file, const uint8_t* pixels, int width, int height)
+{
+    const size_t n = (size_t)width * height;
+    std::vector<uint8_t> planes(n * 3);
+    for (size_t i = 0; i < n; i++)
+    {
+        int r = pixels[i * 4 + 0], g = pixels[i * 4 + 1], b = pixels[i * 4 + 2];
+        planes[i] = (uint8_t)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        planes[n + i] = (uint8_t)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        planes[n * 2 + i] = (uint8_t)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    fputs("FRAME\n", file);
+    fwrite(planes.data(), 1, planes.size(), file);
+}
+
+/**
+ * @brief Write queued stream frames in order. Only one runs at a time.
+ */
+static void _capture_stream_task(void* arg)
+{
+    (void)arg;
+    imgui_capture_stream_t* s = &s_capture.stream;
+
+    for (;;)
+    {
+        std::vector<uint8_t>* frame;
+        {
+            std::lock_guard<std::mutex> guard(s_capture.mutex);
+            if (s->queue.empty())
+            {
+                s->draining = false;
+                if (s->generation == 0 && s->file != NULL)
+                {
+                    fclose(s->file);
+                    s->file = NULL;
+                }
+                return;
+            }
+            frame = s->queue.front();
+            s->queue.pop_front();
+        }
+
+        /* File, size and header are only changed while draining is set */
+        if (!s->header)
+        {
+            int fps = s_capture.fps != 0 ? s_capture.fps : 60;
+            fprintf(s->file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", s->width, s->height, fps);
+            s->header = true;
+        }
+        _capture_write_y4m(s->file, frame->data(), s->width, s->height);
+        delete frame;
+    }
+}
+
+/*
+ * GUI thread.
+ */
+
+static void _capture_stream_push(uint64_t generation, const std::vector<uint8_t>& pixels, int width, int height)
+{
+    imgui_capture_stream_t* s = &s_capture.stream;
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+
+    if (s->generation != generation)
+    {
+        return;
+    }
+    if (s->width == 0)
+    {
+        s->width = width;
+        s->height = height;
+    }
+    if (s->width != width || s->height != height || s->queue.size() >= IMGUI_CAPTURE_STREAM_QUEUE)
+    {
+        s->dropped++;
+        return;
+    }
+
+    s->queue.push_back(new std::vector<uint8_t>(pixels));
+    s->written++;
+    if (!s->draining)
+    {
+        s->draining = true;
+        imgui_pool_submit(_capture_stream_task, NULL);
+    }
+}
+
+/**
+ * @brief Map buffer of \p slot and hand pixels to whoever asked for them.
+ */
+static void _capture_collect(imgui_capture_slot_t* slot)
+{
+    const size_t stride = (size_t)slot->width * 4;
+    const size_t size = stride * slot->height;
+    std::vector<uint8_t> pixels;
+
+    s_capture.gl.BindBuffer(IMGUI_GL_PIXEL_PACK_BUFFER, slot->pbo);
+    const uint8_t* src = (const uint8_t*)s_capture.gl.MapBufferRange(IMGUI_GL_PIXEL_PACK_BUFFER, 0,
+        (ptrdiff_t)size, IMGUI_GL_MAP_READ_BIT);
+    if (src != NULL)
+    {
+        /* OpenGL rows start from bottom */
+        pixels.resize(size);
+        for (int y = 0; y < slot->height; y++)
+        {
+            memcpy(&pixels[stride * y], src + stride * (slot->height - 1 - y), stride);
+        }
+        s_capture.gl.UnmapBuffer(IMGUI_GL_PIXEL_PACK_BUFFER);
+    }
+    s_capture.gl.BindBuffer(IMGUI_GL_PIXEL_PACK_BUFFER, 0);
+    slot->frame = 0;
+
+    if (slot->stream != 0 && src != NULL)
+    {
+        _capture_stream_push(slot->stream, pixels, slot->width, slot->height);
+    }
+
+    for (size_t i = 0; i < slot->requests.size(); i++)
+    {
+        imgui_capture_result_t& req = slot->requests[i];
+        req.width = slot->width;
+        req.height = slot->height;
+
+        if (src == NULL)
+        {
+            req.err = EIO;
+        }
+        else if (!req.path.empty())
+        {
+            imgui_capture_png_job_t* job = new imgui_capture_png_job_t;
+            job->result = std::move(req);
+            job->pixels = pixels;
+            imgui_pool_submit(_capture_png_task, job);
+            continue;
+        }
+        else
+        {
+            req.pixels = pixels;
+        }
+
+        std::lock_guard<std::mutex> guard(s_capture.mutex);
+        s_capture.done.push_back(std::move(req));
+    }
+    slot->requests.clear();
+}
+
+void imgui_capture_init(imgui_capture_getproc_fn getproc, int fps)
+{
+    imgui_capture_gl_t* gl = &s_capture.gl;
+    *(void**)&gl->GenBuffers = getproc("glGenBuffers");
+    *(void**)&gl->DeleteBuffers = getproc("glDeleteBuffers");
+    *(void**)&gl->BindBuffer = getproc("glBindBuffer");
+    *(void**)&gl->BufferData = getproc("glBufferData");
+    *(void**)&gl->MapBufferRange = getproc("glMapBufferRange");
+    *(void**)&gl->UnmapBuffer = getproc("glUnmapBuffer");
+    *(void**)&gl->PixelStorei = getproc("glPixelStorei");
+    *(void**)&gl->ReadPixels = getproc("glReadPixels");
+
+    s_capture.gl_ok = gl->GenBuffers != NULL && gl->DeleteBuffers != NULL && gl->BindBuffer != NULL
+        && gl->BufferData != NULL && gl->MapBufferRange != NULL && gl->UnmapBuffer != NULL
+        && gl->PixelStorei != NULL && gl->ReadPixels != NULL;
+    s_capture.frame = 0;
+    s_capture.fps = fps;
+
+    for (int i = 0; i < IMGUI_CAPTURE_SLOTS; i++)
+    {
+        imgui_capture_slot_t* slot = &s_capture.slots[i];
+        slot->pbo = 0;
+        slot->capacity = 0;
+        slot->frame = 0;
+        if (s_capture.gl_ok)
+        {
+            gl->GenBuffers(1, &slot->pbo);
+        }
+    }
+}
+
+/**
+ * @brief Fail captures that cannot be served.
+ */
+static void _capture_cancel_pending(int err)
+{
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+    for (size_t i = 0; i < s_capture.pending.size(); i++)
+    {
+        s_capture.pending[i].err = err;
+        s_capture.done.push_back(std::move(s_capture.pending[i]));
+    }
+    s_capture.pending.clear();
+}
+
+void imgui_capture_exit(void)
+{
+    if (!s_capture.gl_ok)
+    {
+        _capture_cancel_pending(ENOTSUP);
+        return;
+    }
+
+    for (int i = 0; i < IMGUI_CAPTURE_SLOTS; i++)
+    {
+        imgui_capture_slot_t* slot = &s_capture.slots[i];
+        if (slot->frame != 0)
+        {
+            _capture_collect(slot);
+        }
+        s_capture.gl.DeleteBuffers(1, &slot->pbo);
+        slot->pbo = 0;
+    }
+    s_capture.gl_ok = false;
+
+    _capture_cancel_pending(ECANCELED);
+}
+
+void imgui_capture_frame(int width, int height)
+{
+    if (!s_capture.gl_ok)
+    {
+        _capture_cancel_pending(ENOTSUP);
+        return;
+    }
+    s_capture.frame++;
+
+    imgui_capture_slot_t* idle = NULL;
+    imgui_capture_slot_t* oldest = NULL;
+    for (int i = 0; i < IMGUI_CAPTURE_SLOTS; i++)
+    {
+        imgui_capture_slot_t* slot = &s_capture.slots[i];
+        if (slot->frame != 0 && s_capture.frame - slot->frame >= IMGUI_CAPTURE_LATENCY)
+        {
+            _capture_collect(slot);
+        }
+
+        if (slot->frame == 0)
+        {
+            idle = idle != NULL ? idle : slot;
+        }
+        else if (oldest == NULL || slot->frame < oldest->frame)
+        {
+            oldest = slot;
+        }
+    }
+
+    uint64_t stream = 0;
+    std::vector<imgui_capture_result_t> requests;
+    {
+        std::lock_guard<std::mutex> guard(s_capture.mutex);
+        requests.swap(s_capture.pending);
+        if (s_capture.stream.generation != 0 && s_capture.frame % s_capture.stream.every == 0)
+        {
+            stream = s_capture.stream.generation;
+        }
+    }
+    if ((requests.empty() && stream == 0) || width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    if (idle == NULL)
+    {
+        /* All buffers in flight, wait for the oldest one */
+        _capture_collect(oldest);
+        idle = oldest;
+    }
+
+    size_t size = (size_t)width * height * 4;
+    s_capture.gl.BindBuffer(IMGUI_GL_PIXEL_PACK_BUFFER, idle->pbo);
+    if (idle->capacity < size)
+    {
+        s_capture.gl.BufferData(IMGUI_GL_PIXEL_PACK_BUFFER, (ptrdiff_t)size, NULL, IMGUI_GL_STREAM_READ);
+        idle->capacity = size;
+    }
+    s_capture.gl.PixelStorei(IMGUI_GL_PACK_ALIGNMENT, 1);
+    s_capture.gl.ReadPixels(0, 0, width, height, IMGUI_GL_RGBA, IMGUI_GL_UNSIGNED_BYTE, NULL);
+    s_capture.gl.BindBuffer(IMGUI_GL_PIXEL_PACK_BUFFER, 0);
+
+    idle->frame = s_capture.frame;
+    idle->width = width;
+    idle->height = height;
+    idle->stream = stream;
+    idle->requests.swap(requests);
+}
+
+/*
+ * Lua thread.
+ */
+
+void imgui_capture_request(const char* path, int ref)
+{
+    imgui_capture_result_t req;
+    req.ref = ref;
+    req.path = path != NULL ? path : "";
+    req.err = 0;
+    req.width = 0;
+    req.height = 0;
+
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+    s_capture.pending.push_back(std::move(req));
+}
+
+int imgui_capture_stream_start(const char* path, int every)
+{
+    imgui_capture_stream_t* s = &s_capture.stream;
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+
+    /* Previous stream may still be writing */
+    if (s->file != NULL)
+    {
+        return EBUSY;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return errno;
+    }
+
+    s->file = file;
+    s->generation = ++s_capture.generation;
+    s->every = every > 0 ? every : 1;
+    s->width = 0;
+    s->height = 0;
+    s->written = 0;
+    s->dropped = 0;
+    s->header = false;
+    return 0;
+}
+
+void imgui_capture_stream_stop(uint64_t* written, uint64_t* dropped)
+{
+    imgui_capture_stream_t* s = &s_capture.stream;
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+
+    *written = s->written;
+    *dropped = s->dropped;
+
+    s->generation = 0;
+    if (!s->draining && s->file != NULL)
+    {
+        fclose(s->file);
+        s->file = NULL;
+    }
+}
+
+void imgui_capture_take(std::vector<imgui_capture_result_t>& results)
+{
+    std::lock_guard<std::mutex> guard(s_capture.mutex);
+    for (size_t i = 0; i < s_capture.done.size(); i++)
+    {
+        results.push_back(std::move(s_capture.done[i]));
+    }
+    s_capture.done.clear();
+}
@@ -0,0 +1,94 @@
+#ifndef __IMGUI_CAPTURE_HPP__
+#define __IMGUI_CAPTURE_HPP__
+
+#include <autodo.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Look up an OpenGL function.
+ */
+typedef void* (*imgui_capture_getproc_fn)(const char* name);
+
+/**
+ * @brief A finished capture, handed back to Lua thread.
+ */
+typedef struct imgui_capture_result
+{
+    int                     ref;        /**< Callback reference, or #IMGUI_CAPTURE_NOREF. */
+    std::string             path;       /**< File path, empty if pixels are returned. */
+    int                     err;        /**< errno of writing file. */
+    int                     width;
+    int                     height;
+    std::vector<uint8_t>    pixels;     /**< RGBA, top row first. Empty if written to file. */
+} imgui_capture_result_t;
+
+/**
+ * @brief No callback attached.
+ */
+#define IMGUI_CAPTURE_NOREF     (-2)
+
+/**
+ * @brief Load OpenGL functions and create pixel pack buffers.
+ * @note Called on GUI thread with OpenGL context current.
+ * @param[in] getproc   OpenGL function loader.
+ * @param[in] fps       Frame rate written to Y4M header, 0 if not limited.
+ */
+AUTO_LOCAL void imgui_capture_init(imgui_capture_getproc_fn getproc, int fps);
+
+/**
+ * @brief Finish pending readbacks and release pixel pack buffers.
+ * @note Called on GUI thread with OpenGL context current.
+ */
+AUTO_LOCAL void imgui_capture_exit(void);
+
+/**
+ * @brief Start readback of current back buffer if requested, and collect
+ *   readbacks started two frames ago.
+ * @note Called on GUI thread after rendering and before swapping buffers.
+ * @param[in] width     Framebuffer width.
+ * @param[in] height    Framebuffer height.
+ */
+AUTO_LOCAL void imgui_capture_frame(int width, int height);
+
+/**
+ * @brief Capture next frame.
+ * @param[in] path      Write PNG file to path, or NULL to return pixels.
+ * @param[in] ref       Callback reference, or #IMGUI_CAPTURE_NOREF.
+ */
+AUTO_LOCAL void imgui_capture_request(const char* path, int ref);
+
+/**
+ * @brief Start writing every \p every frame to a Y4M file.
+ * @param[in] path      File path, truncated if exists.
+ * @param[in] every     Capture one frame out of every \p every frames.
+ * @return              0 if success, EBUSY if a stream is open, otherwise errno.
+ */
+AUTO_LOCAL int imgui_capture_stream_start(const char* path, int every);
+
+/**
+ * @brief Stop writing Y4M file. File is closed after queued frames are written.
+ * @param[out] written  Frames written or queued.
+ * @param[out] dropped  Frames dropped because framebuffer size changed, or the
+ *   writer fell behind.
+ */
+AUTO_LOCAL void imgui_capture_stream_stop(uint64_t* written, uint64_t* dropped);
+
+/**
+ * @brief Take finished captures.
+ * @param[out] results  Finished captures are appended.
+ */
+AUTO_LOCAL void imgui_capture_take(std::vector<imgui_capture_result_t>& results);
+
+/**
+ * @brief Encode RGBA pixels as PNG.
+ * @param[in] pixels    RGBA pixels, top row first.
+ * @param[in] width     Image width.
+ * @param[in] height    Image height.
+ * @param[out] out      PNG file content.
+ */
+AUTO_LOCAL void imgui_capture_encode_png(const uint8_t* pixels, int width, int height,
+    std::vector<uint8_t>& out);
+
+#endif
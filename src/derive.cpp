@@ -0,0 +1,356 @@
+#include <math.h>
+#include <atomic>
+#include <complex>
+#include <deque>
+#include <mutex>
+#include "derive.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Moving extreme by monotonic queue of (index, value).
+ */
+typedef std::deque<std::pair<uint64_t, double> > imgui_derive_extreme_t;
+
+struct imgui_derive
+{
+    imgui_derive_param_t    param;
+    std::atomic<int>        refcnt;
+
+    /* Shared, protected by #mutex */
+    std::mutex              mutex;
+    std::vector<double>     input;      /**< Samples not taken by worker yet. */
+    std::vector<double>     output[2];  /**< Results not collected yet. */
+    bool                    replace;    /**< Whether #output replaces previous results. */
+    bool                    reset;      /**< Whether worker state must be reset. */
+    bool                    running;    /**< Whether a worker is scheduled. */
+    uint64_t                generation; /**< Changed on reset, stale results are dropped. */
+
+    /* Worker only */
+    uint64_t                n;          /**< The number of samples processed. */
+    double                  prev;       /**< Last sample, or EMA value. */
+    double                  sum;        /**< Window sum, or decimation accumulator. */
+    size_t                  pos;        /**< Next slot in #ring. */
+    size_t                  filled;     /**< Valid samples in #ring, or samples in decimation block. */
+    size_t                  since;      /**< Samples since last FFT. */
+    std::vector<double>     ring;       /**< Last samples of window. */
+    imgui_derive_extreme_t  lo;
+    imgui_derive_extreme_t  hi;
+    std::vector<double>     hann;       /**< FFT window function. */
+    std::vector<std::complex<double> > spectrum;
+};
+
+static void _derive_reset(imgui_derive_t* derive)
+{
+    derive->n = 0;
+    derive->prev = 0;
+    derive->sum = 0;
+    derive->pos = 0;
+    derive->filled = 0;
+    derive->since = 0;
+    derive->lo.clear();
+    derive->hi.clear();
+}
+
+static void _derive_extreme_push(imgui_derive_extreme_t& q, uint64_t idx, double v, size_t window, bool is_max)
+{
+    while (!q.empty() && (is_max ? q.back().second <= v : q.back().second >= v))
+    {
+        q.pop_back();
+    }
+    q.push_back(std::make_pair(idx, v));
+    while (q.front().first + window <= idx)
+    {
+        q.pop_front();
+    }
+}
+
+/**
+ * @brief In-place iterative radix-2 FFT.
+ */
+static void _derive_fft(std::vector<std::complex<double> >& a)
+{
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; i++)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        const double angle = -2 * M_PI / len;
+        const std::complex<double> wlen(cos(angle), sin(angle));
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w(1, 0);
+            for (size_t k = 0; k < len / 2; k++)
+            {
+                std::complex<double> u = a[i + k];
+                std::complex<double> v = a[i + k + len / 2] * w;
+                a[i + k] = u + v;
+                a[i + k + len / 2] = u - v;
+                w *= wlen;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Amplitude spectrum of the window, oldest sample first.
+ */
+static void _derive_spectrum(imgui_derive_t* derive, std::vector<double>& out)
+{
+    const size_t n = derive->param.window;
+    double gain = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double w = derive->hann[i];
+        derive->spectrum[i] = std::complex<double>(derive->ring[(derive->pos + i) % n] * w, 0);
+        gain += w;
+    }
+    _derive_fft(derive->spectrum);
+
+    /* Scale so a sine of amplitude A peaks at about A */
+    out.resize(n / 2 + 1);
+    for (size_t k = 0; k <= n / 2; k++)
+    {
+        double scale = (k == 0 || k == n / 2) ? 1 / gain : 2 / gain;
+        out[k] = std::abs(derive->spectrum[k]) * scale;
+    }
+}
+
+/**
+ * @brief Process \p n samples.
+ * @return  Whether \p out replaces previous results.
+ */
+static bool _derive_process(imgui_derive_t* derive, const double* data, size_t n, std::vector<double> out[2])
+{
+    const imgui_derive_param_t* param = &derive->param;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        const double v = data[i];
+        switch (param->kind)
+        {
+        case IMGUI_DERIVE_MEAN:
+            if (derive->filled == param->window)
+            {
+                derive->sum -= derive->ring[derive->pos];
+            }
+            else
+            {
+                derive->filled++;
+            }
+            derive->ring[derive->pos] = v;
+            derive->sum += v;
+            if (++derive->pos == param->window)
+            {
+                /* Sum again once per window so rounding error does not accumulate */
+                derive->pos = 0;
+                derive->sum = 0;
+                for (size_t j = 0; j < param->window; j++)
+                {
+                    derive->sum += derive->ring[j];
+                }
+            }
+            out[0].push_back(derive->sum / derive->filled);
+            break;
+
+        case IMGUI_DERIVE_EMA:
+            derive->prev = derive->n == 0 ? v : derive->prev + param->alpha * (v - derive->prev);
+            out[0].push_back(derive->prev);
+            break;
+
+        case IMGUI_DERIVE_ENVELOPE:
+            _derive_extreme_push(derive->lo, derive->n, v, param->window, false);
+            _derive_extreme_push(derive->hi, derive->n, v, param->window, true);
+            out[0].push_back(derive->lo.front().second);
+            out[1].push_back(derive->hi.front().second);
+            break;
+
+        case IMGUI_DERIVE_DIFF:
+            out[0].push_back(derive->n == 0 ? 0 : (v - derive->prev) / param->dt);
+            derive->prev = v;
+            break;
+
+        case IMGUI_DERIVE_DECIMATE:
+            derive->sum += v;
+            if (++derive->filled == param->window)
+            {
+                out[0].push_back(derive->sum / param->window);
+                derive->sum = 0;
+                derive->filled = 0;
+            }
+            break;
+
+        case IMGUI_DERIVE_FFT:
+            derive->ring[derive->pos] = v;
+            derive->pos = derive->pos + 1 < param->window ? derive->pos + 1 : 0;
+            derive->filled += derive->filled < param->window ? 1 : 0;
+            derive->since++;
+            break;
+        }
+        derive->n++;
+    }
+
+    /* Only the newest spectrum is visible, so transform once per batch */
+    if (param->kind == IMGUI_DERIVE_FFT && derive->filled == param->window && derive->since >= param->hop)
+    {
+        derive->since = 0;
+        _derive_spectrum(derive, out[0]);
+        return true;
+    }
+    return false;
+}
+
+static void _derive_unref(imgui_derive_t* derive)
+{
+    if (derive->refcnt.fetch_sub(1) == 1)
+    {
+        delete derive;
+    }
+}
+
+/**
+ * @brief Drain input queue. Only one runs at a time for each derived series.
+ */
+static void _derive_task(void* arg)
+{
+    imgui_derive_t* derive = (imgui_derive_t*)arg;
+    std::vector<double> input;
+    std::vector<double> out[2];
+
+    for (;;)
+    {
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> guard(derive->mutex);
+            if (derive->input.empty() || derive->refcnt.load() == 1)
+            {
+                derive->running = false;
+                break;
+            }
+            input.swap(derive->input);
+            generation = derive->generation;
+            if (derive->reset)
+            {
+                derive->reset = false;
+                _derive_reset(derive);
+            }
+        }
+
+        out[0].clear();
+        out[1].clear();
+        bool replace = _derive_process(derive, input.data(), input.size(), out);
+        input.clear();
+
+        std::lock_guard<std::mutex> guard(derive->mutex);
+        if (derive->generation != generation)
+        {
+            continue;
+        }
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (replace)
+            {
+                derive->output[i].swap(out[i]);
+            }
+            else
+            {
+                derive->output[i].insert(derive->output[i].end(), out[i].begin(), out[i].end());
+            }
+        }
+        derive->replace = derive->replace || replace;
+    }
+
+    _derive_unref(derive);
+}
+
+imgui_derive_t* imgui_derive_create(const imgui_derive_param_t* param)
+{
+    imgui_derive_t* derive = new imgui_derive_t;
+    derive->param = *param;
+    derive->refcnt = 1;
+    derive->replace = false;
+    derive->reset = false;
+    derive->running = false;
+    derive->generation = 0;
+    _derive_reset(derive);
+
+    if (param->kind == IMGUI_DERIVE_MEAN || param->kind == IMGUI_DERIVE_FFT)
+    {
+        derive->ring.resize(param->window);
+    }
+    if (param->kind == IMGUI_DERIVE_FFT)
+    {
+        derive->hann.resize(param->window);
+        derive->spectrum.resize(param->window);
+        for (size_t i = 0; i < param->window; i++)
+        {
+            derive->hann[i] = 0.5 - 0.5 * cos(2 * M_PI * i / param->window);
+        }
+    }
+
+    return derive;
+}
+
+void imgui_derive_release(imgui_derive_t* derive)
+{
+    _derive_unref(derive);
+}
+
+size_t imgui_derive_outputs(imgui_derive_kind_t kind)
+{
+    return kind == IMGUI_DERIVE_ENVELOPE ? 2 : 1;
+}
+
+void imgui_derive_feed(imgui_derive_t* derive, const double* data, size_t n, bool reset)
+{
+    std::lock_guard<std::mutex> guard(derive->mutex);
+
+    if (reset)
+    {
+        derive->input.clear();
+        derive->output[0].clear();
+        derive->output[1].clear();
+        derive->replace = false;
+        derive->reset = true;
+        derive->generation++;
+    }
+    derive->input.insert(derive->input.end(), data, data + n);
+
+    if (!derive->running && !derive->input.empty())
+    {
+        derive->running = true;
+        derive->refcnt++;
+        imgui_pool_submit(_derive_task, derive);
+    }
+}
+
+bool imgui_derive_collect(imgui_derive_t* derive, std::vector<double> out[2], bool* replace)
+{
+    out[0].clear();
+    out[1].clear();
+
+    std::lock_guard<std::mutex> guard(derive->mutex);
+    out[0].swap(derive->output[0]);
+    out[1].swap(derive->output[1]);
+    *replace = derive->replace;
+    derive->replace = false;
+
+    return *replace || !out[0].empty() || !out[1].empty();
+}
+
+bool imgui_derive_busy(imgui_derive_t* derive)
+{
+    std::lock_guard<std::mutex> guard(derive->mutex);
+    return derive->running;
+}
@@ -0,0 +1,83 @@
+#ifndef __IMGUI_DERIVE_HPP__
+#define __IMGUI_DERIVE_HPP__
+
+#include <autodo.h>
+#include <vector>
+
+/**
+ * @brief Kind of derived series.
+ */
+typedef enum imgui_derive_kind
+{
+    IMGUI_DERIVE_MEAN,      /**< Moving average over #imgui_derive_param_t::window samples. */
+    IMGUI_DERIVE_EMA,       /**< Exponential moving average with #imgui_derive_param_t::alpha. */
+    IMGUI_DERIVE_ENVELOPE,  /**< Moving minimum and maximum, two outputs. */
+    IMGUI_DERIVE_DIFF,      /**< Difference to previous sample divided by #imgui_derive_param_t::dt. */
+    IMGUI_DERIVE_DECIMATE,  /**< Mean of every #imgui_derive_param_t::window samples. */
+    IMGUI_DERIVE_FFT,       /**< Amplitude spectrum of last #imgui_derive_param_t::window samples. */
+} imgui_derive_kind_t;
+
+typedef struct imgui_derive_param
+{
+    imgui_derive_kind_t kind;       /**< Kind. */
+    size_t              window;     /**< Window size, decimation factor, or FFT size (power of 2). */
+    size_t              hop;        /**< FFT is computed again after this many new samples. */
+    double              alpha;      /**< EMA smoothing factor in (0, 1]. */
+    double              dt;         /**< Sample interval for derivative. */
+} imgui_derive_param_t;
+
+/**
+ * @brief Derived series state, shared by Lua thread and workers.
+ */
+typedef struct imgui_derive imgui_derive_t;
+
+/**
+ * @brief Create derived series state.
+ * @param[in] param     Parameters, must be valid.
+ * @return              Derived series state.
+ */
+AUTO_LOCAL imgui_derive_t* imgui_derive_create(const imgui_derive_param_t* param);
+
+/**
+ * @brief Release derived series state.
+ *
+ * A running worker keeps the state alive until it finishes.
+ *
+ * @param[in] derive    Derived series state.
+ */
+AUTO_LOCAL void imgui_derive_release(imgui_derive_t* derive);
+
+/**
+ * @brief Get the number of outputs of \p kind.
+ * @param[in] kind      Kind.
+ * @return              1 or 2.
+ */
+AUTO_LOCAL size_t imgui_derive_outputs(imgui_derive_kind_t kind);
+
+/**
+ * @brief Queue new input samples and schedule a worker if none is running.
+ * @param[in] derive    Derived series state.
+ * @param[in] data      New samples.
+ * @param[in] n         The number of samples.
+ * @param[in] reset     Discard previous input, state and results not collected yet.
+ */
+AUTO_LOCAL void imgui_derive_feed(imgui_derive_t* derive, const double* data, size_t n, bool reset);
+
+/**
+ * @brief Take results computed since last call.
+ * @param[in] derive    Derived series state.
+ * @param[out] out      Results of each output, swapped with internal storage.
+ * @param[out] replace  Whether results replace previous output instead of
+ *   appending to it.
+ * @return              Whether there are any results.
+ */
+AUTO_LOCAL bool imgui_derive_collect(imgui_derive_t* derive, std::vector<double> out[2], bool* replace);
+
+/**
+ * @brief Check whether input is queued or being processed.
+ * @param[in] derive    Derived series state.
+ * @return              Whether a worker is scheduled.
+ */
+AUTO_LOCAL bool imgui_derive_busy(imgui_derive_t* derive);
+
+#endif
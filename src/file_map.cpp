@@ -0,0 +1,198 @@
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include "file_map.hpp"
+
+#if defined(_WIN32)
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#endif
+
+#if defined(_WIN32)
+
+int imgui_file_map(imgui_file_map_t* map, const char* path)
+{
+    memset(map, 0, sizeof(*map));
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return ENOENT;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return EIO;
+    }
+
+    map->file = file;
+    map->size = (size_t)size.QuadPart;
+    if (map->size == 0)
+    {
+        return 0;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return EIO;
+    }
+    map->mapping = mapping;
+    map->data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+    return map->data != NULL ? 0 : EIO;
+}
+
+void imgui_file_unmap(imgui_file_map_t* map)
+{
+    if (map->data != NULL)
+    {
+        UnmapViewOfFile(map->data);
+        map->data = NULL;
+    }
+    if (map->mapping != NULL)
+    {
+        CloseHandle(map->mapping);
+        map->mapping = NULL;
+    }
+    if (map->file != NULL)
+    {
+        CloseHandle(map->file);
+        map->file = NULL;
+    }
+}
+
+void imgui_file_advise(imgui_file_map_t* map, size_t offset, size_t size, int need)
+{
+    (void)map; (void)offset; (void)size; (void)need;
+}
+
+static size_t _page_size(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+void* imgui_page_alloc(size_t size)
+{
+    return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void imgui_page_free(void* addr, size_t size)
+{
+    (void)size;
+    VirtualFree(addr, 0, MEM_RELEASE);
+}
+
+static void _page_discard(void* addr, size_t size)
+{
+    /* Pages are still committed, but no longer need to be kept */
+    VirtualAlloc(addr, size, MEM_RESET, PAGE_READWRITE);
+}
+
+#else
+
+int imgui_file_map(imgui_file_map_t* map, const char* path)
+{
+    memset(map, 0, sizeof(*map));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return errno;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        int err = errno;
+        close(fd);
+        return err;
+    }
+
+    map->size = (size_t)st.st_size;
+    if (map->size != 0)
+    {
+        void* addr = mmap(NULL, map->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            int err = errno;
+            close(fd);
+            return err;
+        }
+        map->data = (const char*)addr;
+    }
+
+    /* The mapping keeps its own reference to the file */
+    close(fd);
+    return 0;
+}
+
+void imgui_file_unmap(imgui_file_map_t* map)
+{
+    if (map->data != NULL)
+    {
+        munmap((void*)map->data, map->size);
+        map->data = NULL;
+    }
+    map->size = 0;
+}
+
+void imgui_file_advise(imgui_file_map_t* map, size_t offset, size_t size, int need)
+{
+    if (map->data == NULL || offset >= map->size)
+    {
+        return;
+    }
+
+    /* madvise() requires page aligned address */
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t beg = offset / page * page;
+    size_t end = offset + size < map->size ? offset + size : map->size;
+
+    madvise((void*)(map->data + beg), end - beg, need ? MADV_WILLNEED : MADV_DONTNEED);
+}
+
+static size_t _page_size(void)
+{
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+void* imgui_page_alloc(size_t size)
+{
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return addr != MAP_FAILED ? addr : NULL;
+}
+
+void imgui_page_free(void* addr, size_t size)
+{
+    munmap(addr, size);
+}
+
+static void _page_discard(void* addr, size_t size)
+{
+    madvise(addr, size, MADV_DONTNEED);
+}
+
+#endif
+
+void imgui_page_discard(void* addr, size_t size)
+{
+    /* Neighbour pages may hold live data, so only whole pages are discarded */
+    size_t page = _page_size();
+    uintptr_t beg = ((uintptr_t)addr + page - 1) / page * page;
+    uintptr_t end = ((uintptr_t)addr + size) / page * page;
+    if (beg < end)
+    {
+        _page_discard((void*)beg, end - beg);
+    }
+}
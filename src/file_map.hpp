@@ -0,0 +1,68 @@
+#ifndef __IMGUI_FILE_MAP_HPP__
+#define __IMGUI_FILE_MAP_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Read-only memory mapping of a file.
+ */
+typedef struct imgui_file_map
+{
+    const char*     data;   /**< Mapped address, NULL if file is empty. */
+    size_t          size;   /**< File size in bytes. */
+#if defined(_WIN32)
+    void*           file;
+    void*           mapping;
+#endif
+} imgui_file_map_t;
+
+/**
+ * @brief Map the whole file \p path read-only.
+ * @param[out] map  Mapping object.
+ * @param[in] path  File path.
+ * @return          0 if success, otherwise errno.
+ */
+AUTO_LOCAL int imgui_file_map(imgui_file_map_t* map, const char* path);
+
+/**
+ * @brief Release mapping.
+ * @param[in] map   Mapping object.
+ */
+AUTO_LOCAL void imgui_file_unmap(imgui_file_map_t* map);
+
+/**
+ * @brief Tell the system that range [offset, offset+size) will be accessed
+ *   soon, or not needed anymore.
+ * @param[in] map       Mapping object.
+ * @param[in] offset    Start position in bytes.
+ * @param[in] size      Size in bytes.
+ * @param[in] need      Boolean.
+ */
+AUTO_LOCAL void imgui_file_advise(imgui_file_map_t* map, size_t offset, size_t size, int need);
+
+/**
+ * @brief Reserve anonymous memory. Pages take physical memory when they are
+ *   first written.
+ * @param[in] size  Size in bytes.
+ * @return          Address, or NULL if failed.
+ */
+AUTO_LOCAL void* imgui_page_alloc(size_t size);
+
+/**
+ * @brief Release memory from #imgui_page_alloc().
+ * @param[in] addr  Address.
+ * @param[in] size  Size in bytes, same as allocated.
+ */
+AUTO_LOCAL void imgui_page_free(void* addr, size_t size);
+
+/**
+ * @brief Give back physical memory of pages entirely inside [addr, addr+size).
+ *
+ * The range stays valid, but its content is undefined until written again.
+ *
+ * @param[in] addr  Start address.
+ * @param[in] size  Size in bytes.
+ */
+AUTO_LOCAL void imgui_page_discard(void* addr, size_t size);
+
+#endif
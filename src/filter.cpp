@@ -0,0 +1,388 @@
+#include <ctype.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "filter.hpp"
+#include "lua_imgui.h"
+#include "thread_pool.hpp"
+
+/**
+ * @brief The number of strings, or previous hits, searched by each task.
+ */
+#define IMGUI_FILTER_CHUNK  16384
+
+struct imgui_filter
+{
+    std::vector<char>           arena;      /**< Strings back to back. */
+    std::vector<char>           folded;     /**< #arena in ASCII lower case. */
+    std::vector<size_t>         offsets;    /**< Start of each string, plus end of arena. */
+
+    std::vector<std::string>    include;    /**< Include terms, lower case if #icase. */
+    std::vector<std::string>    exclude;    /**< Exclude terms, lower case if #icase. */
+    auto_regex_code_t*          code;       /**< Compiled regex, or NULL. */
+    bool                        icase;
+
+    std::vector<uint32_t>       hits;       /**< Passing strings of [0, #searched). */
+    size_t                      searched;   /**< The number of strings covered by #hits. */
+    bool                        refine;     /**< Whether #hits is a superset of result. */
+};
+
+typedef struct imgui_filter_job
+{
+    imgui_filter_t*                     filter;
+    const std::vector<uint32_t>*        candidates; /**< Strings to test, NULL for a range. */
+    size_t                              beg;        /**< First string of range. */
+    size_t                              end;        /**< One past last string of range. */
+    std::vector<std::vector<uint32_t> > parts;      /**< Result of each task. */
+} imgui_filter_job_t;
+
+static const char* _filter_base(const imgui_filter_t* filter)
+{
+    return filter->icase ? filter->folded.data() : filter->arena.data();
+}
+
+static bool _filter_find(const char* data, size_t size, const std::string& term)
+{
+    return size >= term.size() && api->misc->search(data, size, term.data(), term.size()) >= 0;
+}
+
+/**
+ * @brief Test one string.
+ */
+static bool _filter_test(const imgui_filter_t* filter, size_t idx)
+{
+    const size_t beg = filter->offsets[idx];
+    const size_t len = filter->offsets[idx + 1] - beg;
+
+    if (filter->code != NULL)
+    {
+        size_t groups[2];
+        return api->regex->match(filter->code, filter->arena.data() + beg, len, groups, 1) > 0;
+    }
+
+    const char* str = _filter_base(filter) + beg;
+    for (size_t i = 0; i < filter->exclude.size(); i++)
+    {
+        if (_filter_find(str, len, filter->exclude[i]))
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < filter->include.size(); i++)
+    {
+        if (_filter_find(str, len, filter->include[i]))
+        {
+            return true;
+        }
+    }
+    return filter->include.empty();
+}
+
+/**
+ * @brief Search \p term over the arena of strings [beg, end) in one pass and
+ *   set \p bit in mark of every string containing it.
+ */
+static void _filter_scan(const imgui_filter_t* filter, size_t beg, size_t end, const std::string& term,
+    uint8_t* mark, uint8_t bit)
+{
+    const char* base = _filter_base(filter);
+    const size_t* offsets = filter->offsets.data();
+    size_t pos = offsets[beg];
+    size_t idx = beg;
+    const size_t stop = offsets[end];
+
+    while (stop - pos >= term.size())
+    {
+        ssize_t ret = api->misc->search(base + pos, stop - pos, term.data(), term.size());
+        if (ret < 0)
+        {
+            break;
+        }
+
+        /* Hits only move forward, so walking offsets is cheaper than bisecting */
+        size_t at = pos + (size_t)ret;
+        while (offsets[idx + 1] <= at)
+        {
+            idx++;
+        }
+
+        /* Hit may cross a string boundary, then retry from next byte */
+        if (at + term.size() <= offsets[idx + 1])
+        {
+            mark[idx - beg] |= bit;
+            pos = offsets[idx + 1];
+        }
+        else
+        {
+            pos = at + 1;
+        }
+    }
+}
+
+static void _filter_range_task(void* arg, size_t task)
+{
+    imgui_filter_job_t* job = (imgui_filter_job_t*)arg;
+    const imgui_filter_t* filter = job->filter;
+    const size_t beg = job->beg + task * IMGUI_FILTER_CHUNK;
+    const size_t end = std::min(beg + IMGUI_FILTER_CHUNK, job->end);
+    std::vector<uint32_t>& out = job->parts[task];
+
+    if (filter->code != NULL)
+    {
+        for (size_t i = beg; i < end; i++)
+        {
+            if (_filter_test(filter, i))
+            {
+                out.push_back((uint32_t)i);
+            }
+        }
+        return;
+    }
+
+    /* Bit 0 for include, bit 1 for exclude */
+    std::vector<uint8_t> mark(end - beg, 0);
+    for (size_t i = 0; i < filter->include.size(); i++)
+    {
+        _filter_scan(filter, beg, end, filter->include[i], mark.data(), 1);
+    }
+    for (size_t i = 0; i < filter->exclude.size(); i++)
+    {
+        _filter_scan(filter, beg, end, filter->exclude[i], mark.data(), 2);
+    }
+
+    const uint8_t want = filter->include.empty() ? 0 : 1;
+    for (size_t i = beg; i < end; i++)
+    {
+        if ((mark[i - beg] & 3) == want)
+        {
+            out.push_back((uint32_t)i);
+        }
+    }
+}
+
+static void _filter_candidate_task(void* arg, size_t task)
+{
+    imgui_filter_job_t* job = (imgui_filter_job_t*)arg;
+    const std::vector<uint32_t>& candidates = *job->candidates;
+    const size_t beg = task * IMGUI_FILTER_CHUNK;
+    const size_t end = std::min(beg + IMGUI_FILTER_CHUNK, candidates.size());
+
+    for (size_t i = beg; i < end; i++)
+    {
+        if (_filter_test(job->filter, candidates[i]))
+        {
+            job->parts[task].push_back(candidates[i]);
+        }
+    }
+}
+
+/**
+ * @brief Run tasks and append their results to hits in order.
+ */
+static void _filter_run(imgui_filter_t* filter, imgui_filter_job_t* job, size_t num_task, imgui_pool_fn fn)
+{
+    job->parts.resize(num_task);
+    imgui_pool_parallel(num_task, fn, job);
+
+    for (size_t i = 0; i < num_task; i++)
+    {
+        filter->hits.insert(filter->hits.end(), job->parts[i].begin(), job->parts[i].end());
+    }
+}
+
+/**
+ * @brief Check whether every string containing \p term also contains one of
+ *   \p terms.
+ */
+static bool _filter_implies(const std::string& term, const std::vector<std::string>& terms)
+{
+    for (size_t i = 0; i < terms.size(); i++)
+    {
+        if (term.find(terms[i]) != std::string::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether new terms only remove strings from old result.
+ */
+static bool _filter_narrows(const std::vector<std::string>& old_include, const std::vector<std::string>& old_exclude,
+    const std::vector<std::string>& new_include, const std::vector<std::string>& new_exclude)
+{
+    /* A string rejected by an old exclude term must still be rejected */
+    for (size_t i = 0; i < old_exclude.size(); i++)
+    {
+        if (!_filter_implies(old_exclude[i], new_exclude))
+        {
+            return false;
+        }
+    }
+
+    /* A string accepted by a new include term must contain an old one */
+    if (old_include.empty())
+    {
+        return true;
+    }
+    if (new_include.empty())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < new_include.size(); i++)
+    {
+        if (!_filter_implies(new_include[i], old_include))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+imgui_filter_t* imgui_filter_create(void)
+{
+    imgui_filter_t* filter = new imgui_filter_t;
+    filter->offsets.push_back(0);
+    filter->code = NULL;
+    filter->icase = true;
+    filter->searched = 0;
+    filter->refine = false;
+    return filter;
+}
+
+void imgui_filter_destroy(imgui_filter_t* filter)
+{
+    if (filter->code != NULL)
+    {
+        api->regex->destroy(filter->code);
+    }
+    delete filter;
+}
+
+void imgui_filter_push(imgui_filter_t* filter, const char* str, size_t len)
+{
+    filter->arena.insert(filter->arena.end(), str, str + len);
+    for (size_t i = 0; i < len; i++)
+    {
+        filter->folded.push_back((char)tolower((unsigned char)str[i]));
+    }
+    filter->offsets.push_back(filter->arena.size());
+}
+
+void imgui_filter_clear(imgui_filter_t* filter)
+{
+    filter->arena.clear();
+    filter->folded.clear();
+    filter->offsets.resize(1);
+    filter->hits.clear();
+    filter->searched = 0;
+    filter->refine = false;
+}
+
+size_t imgui_filter_size(const imgui_filter_t* filter)
+{
+    return filter->offsets.size() - 1;
+}
+
+const char* imgui_filter_at(const imgui_filter_t* filter, size_t idx, size_t* len)
+{
+    *len = filter->offsets[idx + 1] - filter->offsets[idx];
+    return filter->arena.data() + filter->offsets[idx];
+}
+
+int imgui_filter_set(imgui_filter_t* filter, const char* query, bool regex, bool icase)
+{
+    std::vector<std::string> include, exclude;
+    auto_regex_code_t* code = NULL;
+
+    if (regex)
+    {
+        if (*query != '\0' && (code = api->regex->create(query, strlen(query))) == NULL)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        for (const char* p = query; *p != '\0';)
+        {
+            const char* comma = strchr(p, ',');
+            const char* end = comma != NULL ? comma : p + strlen(p);
+            std::string term(p, end);
+            p = comma != NULL ? comma + 1 : end;
+
+            size_t first = term.find_first_not_of(' ');
+            size_t last = term.find_last_not_of(' ');
+            term = first == std::string::npos ? std::string() : term.substr(first, last - first + 1);
+            if (icase)
+            {
+                std::transform(term.begin(), term.end(), term.begin(), [](char c) { return (char)tolower((unsigned char)c); });
+            }
+
+            if (term.size() > 1 && term[0] == '-')
+            {
+                exclude.push_back(term.substr(1));
+            }
+            else if (!term.empty() && term != "-")
+            {
+                include.push_back(term);
+            }
+        }
+    }
+
+    /*
+     * Previous hits can be refined only if text terms narrow the result.
+     * Testing strings one by one is slower than scanning the arena, so it
+     * only pays off if most strings are already rejected.
+     */
+    bool refine = !regex && filter->code == NULL && icase == filter->icase
+        && filter->hits.size() < filter->searched / 2
+        && _filter_narrows(filter->include, filter->exclude, include, exclude);
+
+    if (filter->code != NULL)
+    {
+        api->regex->destroy(filter->code);
+    }
+    filter->code = code;
+    filter->include.swap(include);
+    filter->exclude.swap(exclude);
+    filter->icase = icase;
+    filter->refine = refine;
+    if (!refine)
+    {
+        filter->hits.clear();
+        filter->searched = 0;
+    }
+    return 0;
+}
+
+const std::vector<uint32_t>& imgui_filter_hits(imgui_filter_t* filter)
+{
+    imgui_filter_job_t job;
+    job.filter = filter;
+
+    if (filter->refine)
+    {
+        std::vector<uint32_t> candidates;
+        candidates.swap(filter->hits);
+        job.candidates = &candidates;
+        _filter_run(filter, &job, (candidates.size() + IMGUI_FILTER_CHUNK - 1) / IMGUI_FILTER_CHUNK,
+            _filter_candidate_task);
+        filter->refine = false;
+    }
+
+    const size_t size = imgui_filter_size(filter);
+    if (filter->searched < size)
+    {
+        job.parts.clear();
+        job.candidates = NULL;
+        job.beg = filter->searched;
+        job.end = size;
+        _filter_run(filter, &job, (size - filter->searched + IMGUI_FILTER_CHUNK - 1) / IMGUI_FILTER_CHUNK,
+            _filter_range_task);
+        filter->searched = size;
+    }
+
+    return filter->hits;
+}
@@ -0,0 +1,86 @@
+#ifndef __IMGUI_FILTER_HPP__
+#define __IMGUI_FILTER_HPP__
+
+#include <autodo.h>
+#include <vector>
+
+/**
+ * @brief Filter over a list of strings.
+ *
+ * Strings are stored back to back in an arena, so a term is searched over a
+ * whole chunk of strings at once by `api->misc->search`, then each hit is
+ * mapped back to its string.
+ */
+typedef struct imgui_filter imgui_filter_t;
+
+/**
+ * @brief Create filter.
+ * @return  Filter object.
+ */
+AUTO_LOCAL imgui_filter_t* imgui_filter_create(void);
+
+/**
+ * @brief Destroy filter.
+ * @param[in] filter    Filter object.
+ */
+AUTO_LOCAL void imgui_filter_destroy(imgui_filter_t* filter);
+
+/**
+ * @brief Append a string.
+ * @param[in] filter    Filter object.
+ * @param[in] str       String.
+ * @param[in] len       Length in bytes.
+ */
+AUTO_LOCAL void imgui_filter_push(imgui_filter_t* filter, const char* str, size_t len);
+
+/**
+ * @brief Remove all strings.
+ * @param[in] filter    Filter object.
+ */
+AUTO_LOCAL void imgui_filter_clear(imgui_filter_t* filter);
+
+/**
+ * @brief Get the number of strings.
+ * @param[in] filter    Filter object.
+ * @return              The number of strings.
+ */
+AUTO_LOCAL size_t imgui_filter_size(const imgui_filter_t* filter);
+
+/**
+ * @brief Get string.
+ * @param[in] filter    Filter object.
+ * @param[in] idx       String index.
+ * @param[out] len      Length in bytes.
+ * @return              String, not NUL terminated. Valid until next append.
+ */
+AUTO_LOCAL const char* imgui_filter_at(const imgui_filter_t* filter, size_t idx, size_t* len);
+
+/**
+ * @brief Set query.
+ *
+ * Text query has the same syntax as `ImGuiTextFilter`: terms are separated
+ * by comma, and a term starting with `-` excludes strings. A string passes
+ * if it matches no exclude term, and any include term if there is one.
+ *
+ * If every string passing the new query also passes the old one, such as
+ * typing more characters, only previous hits are searched.
+ *
+ * @param[in] filter    Filter object.
+ * @param[in] query     Query.
+ * @param[in] regex     Whether query is a regular expression.
+ * @param[in] icase     Whether text query ignores ASCII case.
+ * @return              0 if success, or -1 if regex does not compile.
+ */
+AUTO_LOCAL int imgui_filter_set(imgui_filter_t* filter, const char* query, bool regex, bool icase);
+
+/**
+ * @brief Get strings passing query, in insertion order.
+ *
+ * Strings appended since last call are searched on demand.
+ *
+ * @param[in] filter    Filter object.
+ * @return              Index of passing strings, valid until next call.
+ */
+AUTO_LOCAL const std::vector<uint32_t>& imgui_filter_hits(imgui_filter_t* filter);
+
+#endif
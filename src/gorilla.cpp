@@ -0,0 +1,251 @@
+#include <string.h>
+#include "gorilla.hpp"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+typedef struct gorilla_writer
+{
+    std::vector<uint64_t>*  words;
+    size_t                  pos;        /**< Bit position. */
+} gorilla_writer_t;
+
+typedef struct gorilla_reader
+{
+    const uint64_t*         words;
+    size_t                  pos;        /**< Bit position. */
+} gorilla_reader_t;
+
+static int _gorilla_clz(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return 63 - (int)idx;
+#else
+    return __builtin_clzll(x);
+#endif
+}
+
+static int _gorilla_ctz(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, x);
+    return (int)idx;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+static uint64_t _gorilla_mask(int n)
+{
+    return n >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+}
+
+static uint64_t _gorilla_bits_of(double v)
+{
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+static double _gorilla_double_of(uint64_t u)
+{
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Write low \p n bits of \p v.
+ */
+static void _gorilla_put(gorilla_writer_t* w, uint64_t v, int n)
+{
+    while (n > 0)
+    {
+        size_t word = w->pos / 64;
+        int room = 64 - (int)(w->pos % 64);
+        int take = n < room ? n : room;
+
+        if (word == w->words->size())
+        {
+            w->words->push_back(0);
+        }
+
+        uint64_t chunk = (v >> (n - take)) & _gorilla_mask(take);
+        (*w->words)[word] |= chunk << (room - take);
+        w->pos += take;
+        n -= take;
+    }
+}
+
+static uint64_t _gorilla_get(gorilla_reader_t* r, int n)
+{
+    uint64_t ret = 0;
+    while (n > 0)
+    {
+        size_t word = r->pos / 64;
+        int room = 64 - (int)(r->pos % 64);
+        int take = n < room ? n : room;
+
+        uint64_t chunk = (r->words[word] >> (room - take)) & _gorilla_mask(take);
+        ret = take >= 64 ? chunk : ((ret << take) | chunk);
+        r->pos += take;
+        n -= take;
+    }
+    return ret;
+}
+
+/**
+ * @brief Read up to \p n leading one bits, stop at first zero.
+ * @return The number of one bits.
+ */
+static int _gorilla_get_prefix(gorilla_reader_t* r, int n)
+{
+    int i = 0;
+    for (; i < n; i++)
+    {
+        if (_gorilla_get(r, 1) == 0)
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief Delta-of-delta buckets: control bits and value width.
+ */
+static const struct
+{
+    int64_t     bias;
+    int         width;
+} s_gorilla_dod_bucket[] = {
+    { 63,   7 },
+    { 255,  9 },
+    { 2047, 12 },
+};
+
+static void _gorilla_put_tick(gorilla_writer_t* w, int64_t dod)
+{
+    if (dod == 0)
+    {
+        _gorilla_put(w, 0, 1);
+        return;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t bias = s_gorilla_dod_bucket[i].bias;
+        if (dod >= -bias && dod <= bias + 1)
+        {
+            /* Prefix is (i + 1) one bits followed by a zero bit */
+            _gorilla_put(w, _gorilla_mask(i + 1) << 1, i + 2);
+            _gorilla_put(w, (uint64_t)(dod + bias), s_gorilla_dod_bucket[i].width);
+            return;
+        }
+    }
+
+    _gorilla_put(w, 0xf, 4);
+    _gorilla_put(w, (uint64_t)dod, 64);
+}
+
+static int64_t _gorilla_get_tick(gorilla_reader_t* r)
+{
+    int prefix = _gorilla_get_prefix(r, 4);
+    if (prefix == 0)
+    {
+        return 0;
+    }
+    if (prefix == 4)
+    {
+        return (int64_t)_gorilla_get(r, 64);
+    }
+
+    int64_t bias = s_gorilla_dod_bucket[prefix - 1].bias;
+    return (int64_t)_gorilla_get(r, s_gorilla_dod_bucket[prefix - 1].width) - bias;
+}
+
+void imgui_gorilla_encode(imgui_gorilla_block_t* block, const int64_t* ticks,
+    const double* values, size_t count)
+{
+    block->count = count;
+    block->first_tick = ticks[0];
+    block->last_tick = ticks[count - 1];
+    block->first_value = values[0];
+    block->last_value = values[count - 1];
+    block->bits.clear();
+
+    gorilla_writer_t w = { &block->bits, 0 };
+    int64_t prev_delta = 0;
+    int prev_lead = -1, prev_trail = 0;
+
+    for (size_t i = 1; i < count; i++)
+    {
+        int64_t delta = ticks[i] - ticks[i - 1];
+        _gorilla_put_tick(&w, delta - prev_delta);
+        prev_delta = delta;
+
+        uint64_t x = _gorilla_bits_of(values[i]) ^ _gorilla_bits_of(values[i - 1]);
+        if (x == 0)
+        {
+            _gorilla_put(&w, 0, 1);
+            continue;
+        }
+
+        int lead = _gorilla_clz(x);
+        int trail = _gorilla_ctz(x);
+        lead = lead > 31 ? 31 : lead;
+
+        /* Meaningful bits fit in previous window */
+        if (prev_lead >= 0 && lead >= prev_lead && trail >= prev_trail)
+        {
+            _gorilla_put(&w, 0x2, 2);
+            _gorilla_put(&w, x >> prev_trail, 64 - prev_lead - prev_trail);
+            continue;
+        }
+
+        int sig = 64 - lead - trail;
+        _gorilla_put(&w, 0x3, 2);
+        _gorilla_put(&w, (uint64_t)lead, 5);
+        _gorilla_put(&w, (uint64_t)(sig & 63), 6);
+        _gorilla_put(&w, x >> trail, sig);
+        prev_lead = lead;
+        prev_trail = trail;
+    }
+
+    block->bits.shrink_to_fit();
+}
+
+void imgui_gorilla_decode(const imgui_gorilla_block_t* block, int64_t* ticks, double* values)
+{
+    gorilla_reader_t r = { block->bits.data(), 0 };
+    int64_t prev_delta = 0;
+    int prev_lead = 0, prev_trail = 0;
+
+    ticks[0] = block->first_tick;
+    values[0] = block->first_value;
+    uint64_t prev = _gorilla_bits_of(block->first_value);
+
+    for (size_t i = 1; i < block->count; i++)
+    {
+        prev_delta += _gorilla_get_tick(&r);
+        ticks[i] = ticks[i - 1] + prev_delta;
+
+        if (_gorilla_get(&r, 1) != 0)
+        {
+            if (_gorilla_get(&r, 1) != 0)
+            {
+                prev_lead = (int)_gorilla_get(&r, 5);
+                int sig = (int)_gorilla_get(&r, 6);
+                sig = sig == 0 ? 64 : sig;
+                prev_trail = 64 - prev_lead - sig;
+            }
+            int sig = 64 - prev_lead - prev_trail;
+            prev ^= _gorilla_get(&r, sig) << prev_trail;
+        }
+        values[i] = _gorilla_double_of(prev);
+    }
+}
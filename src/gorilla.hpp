@@ -0,0 +1,45 @@
+#ifndef __IMGUI_GORILLA_HPP__
+#define __IMGUI_GORILLA_HPP__
+
+#include <autodo.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief A sealed block of samples, compressed with Gorilla encoding.
+ *
+ * Timestamps are integer ticks stored as delta-of-delta, and values are XOR
+ * of consecutive IEEE 754 doubles. Both are interleaved in one bit stream.
+ *
+ * First and last sample are kept in the header, so a block can be located
+ * and used as plot margin without decoding.
+ */
+typedef struct imgui_gorilla_block
+{
+    size_t                  count;      /**< The number of samples. */
+    int64_t                 first_tick; /**< Timestamp of first sample. */
+    int64_t                 last_tick;  /**< Timestamp of last sample. */
+    double                  first_value;/**< Value of first sample. */
+    double                  last_value; /**< Value of last sample. */
+    std::vector<uint64_t>   bits;       /**< Bit stream, MSB first. */
+} imgui_gorilla_block_t;
+
+/**
+ * @brief Compress samples into block.
+ * @param[out] block    Block to fill.
+ * @param[in] ticks     Timestamps, must not be decreasing.
+ * @param[in] values    Values.
+ * @param[in] count     The number of samples, must not be 0.
+ */
+AUTO_LOCAL void imgui_gorilla_encode(imgui_gorilla_block_t* block, const int64_t* ticks,
+    const double* values, size_t count);
+
+/**
+ * @brief Decompress all samples of block.
+ * @param[in] block     Block.
+ * @param[out] ticks    Timestamps, at least `block->count` elements.
+ * @param[out] values   Values, at least `block->count` elements.
+ */
+AUTO_LOCAL void imgui_gorilla_decode(const imgui_gorilla_block_t* block, int64_t* ticks, double* values);
+
+#endif
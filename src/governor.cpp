@@ -0,0 +1,140 @@
+#include <imgui.h>
+#include "governor.hpp"
+
+/**
+ * @brief Weight of newest frame in smoothed frame cost.
+ */
+#define IMGUI_GOVERNOR_ALPHA        0.1
+
+/**
+ * @brief Frames to wait after a transition before stepping down again.
+ */
+#define IMGUI_GOVERNOR_DOWN_FRAMES  15
+
+/**
+ * @brief Frames of headroom required before stepping up.
+ */
+#define IMGUI_GOVERNOR_UP_FRAMES    120
+
+/**
+ * @brief Smoothed cost below this fraction of budget is headroom.
+ */
+#define IMGUI_GOVERNOR_HEADROOM     0.5
+
+typedef struct imgui_governor
+{
+    int                 enabled;
+    int                 level;
+    int                 pinned;
+    double              cost;       /**< Smoothed frame cost in nanoseconds. */
+    uint64_t            budget;
+    uint64_t            changes;
+    int                 frames;     /**< Frames since last transition. */
+
+    int                 applied;    /**< Level applied to style, -1 if none. */
+    ImGuiStyle          saved;      /**< Style before level 1 is applied. */
+} imgui_governor_t;
+
+static imgui_governor_t s_governor = {
+    0, 0, -1, 0, 0, 0, 0, -1, ImGuiStyle(),
+};
+
+/**
+ * @brief Change style to match current level, original values are restored
+ *   when stepping back.
+ */
+static void _governor_apply(void)
+{
+    int level = imgui_governor_level();
+    if (level == s_governor.applied)
+    {
+        return;
+    }
+
+    ImGuiStyle& style = ImGui::GetStyle();
+    if (s_governor.applied <= 0)
+    {
+        s_governor.saved = style;
+    }
+
+    style.AntiAliasedLines = level >= 1 ? false : s_governor.saved.AntiAliasedLines;
+    style.AntiAliasedLinesUseTex = level >= 1 ? false : s_governor.saved.AntiAliasedLinesUseTex;
+    style.AntiAliasedFill = level >= 1 ? false : s_governor.saved.AntiAliasedFill;
+    style.CircleTessellationMaxError = level >= 2
+        ? s_governor.saved.CircleTessellationMaxError * 4 : s_governor.saved.CircleTessellationMaxError;
+
+    if (s_governor.applied >= 0)
+    {
+        s_governor.changes++;
+    }
+    s_governor.applied = level;
+}
+
+void imgui_governor_enable(int enable)
+{
+    s_governor.enabled = enable;
+    s_governor.pinned = -1;
+    s_governor.level = 0;
+    s_governor.cost = 0;
+    s_governor.frames = 0;
+    s_governor.applied = -1;
+}
+
+void imgui_governor_update(uint64_t cost, uint64_t budget)
+{
+    s_governor.cost = s_governor.cost == 0 ? (double)cost
+        : s_governor.cost + ((double)cost - s_governor.cost) * IMGUI_GOVERNOR_ALPHA;
+    s_governor.budget = budget;
+    s_governor.frames++;
+
+    if (s_governor.enabled && budget != 0)
+    {
+        int level = s_governor.level;
+        if (s_governor.cost > (double)budget && s_governor.frames >= IMGUI_GOVERNOR_DOWN_FRAMES)
+        {
+            level = level < IMGUI_GOVERNOR_LEVEL_MAX ? level + 1 : level;
+        }
+        else if (s_governor.cost < (double)budget * IMGUI_GOVERNOR_HEADROOM
+            && s_governor.frames >= IMGUI_GOVERNOR_UP_FRAMES)
+        {
+            level = level > 0 ? level - 1 : level;
+        }
+
+        if (level != s_governor.level)
+        {
+            s_governor.level = level;
+            s_governor.frames = 0;
+        }
+    }
+
+    _governor_apply();
+}
+
+void imgui_governor_pin(int level)
+{
+    s_governor.pinned = level;
+}
+
+int imgui_governor_level(void)
+{
+    if (s_governor.pinned >= 0)
+    {
+        return s_governor.pinned;
+    }
+    return s_governor.enabled ? s_governor.level : 0;
+}
+
+int imgui_governor_downsample(void)
+{
+    int level = imgui_governor_level();
+    return level >= 4 ? 4 : (level >= 3 ? 2 : 1);
+}
+
+void imgui_governor_stats(imgui_governor_stats_t* stats)
+{
+    stats->level = imgui_governor_level();
+    stats->pinned = s_governor.pinned;
+    stats->frame_ms = s_governor.cost / 1000 / 1000;
+    stats->budget_ms = (double)s_governor.budget / 1000 / 1000;
+    stats->changes = s_governor.changes;
+}
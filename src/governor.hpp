@@ -0,0 +1,71 @@
+#ifndef __IMGUI_GOVERNOR_HPP__
+#define __IMGUI_GOVERNOR_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Highest (cheapest) quality level.
+ *
+ * + 0: Full quality.
+ * + 1: Anti-aliased lines and fills are disabled.
+ * + 2: Markers and circles use fewer vertices.
+ * + 3: Plots submit every 2nd element, and unfocused window run at quarter rate.
+ * + 4: Plots submit every 4th element.
+ */
+#define IMGUI_GOVERNOR_LEVEL_MAX    4
+
+/**
+ * @brief Governor state visible to Lua.
+ */
+typedef struct imgui_governor_stats
+{
+    int         level;      /**< Current quality level. */
+    int         pinned;     /**< Level set by user, -1 if adaptive. */
+    double      frame_ms;   /**< Smoothed frame cost, excluding frame rate limit. */
+    double      budget_ms;  /**< Frame budget, 0 if frame rate is not limited. */
+    uint64_t    changes;    /**< The number of level transitions. */
+} imgui_governor_stats_t;
+
+/**
+ * @brief Enable or disable adaptive quality.
+ *
+ * When disabled, level is 0 unless pinned. Also reset state for a new
+ * ImGui context, including pinned level.
+ *
+ * @param[in] enable    Boolean.
+ */
+AUTO_LOCAL void imgui_governor_enable(int enable);
+
+/**
+ * @brief Record cost of last frame and step quality level.
+ * @note Called on GUI thread before user function runs.
+ * @param[in] cost      Frame cost in nanoseconds.
+ * @param[in] budget    Frame budget in nanoseconds, 0 if not limited.
+ */
+AUTO_LOCAL void imgui_governor_update(uint64_t cost, uint64_t budget);
+
+/**
+ * @brief Pin quality level.
+ * @param[in] level     Level in [0, #IMGUI_GOVERNOR_LEVEL_MAX], or -1 to adapt.
+ */
+AUTO_LOCAL void imgui_governor_pin(int level);
+
+/**
+ * @brief Get current quality level.
+ * @return              Level in [0, #IMGUI_GOVERNOR_LEVEL_MAX].
+ */
+AUTO_LOCAL int imgui_governor_level(void);
+
+/**
+ * @brief Get plot downsampling factor of current level.
+ * @return              1 if every element is submitted.
+ */
+AUTO_LOCAL int imgui_governor_downsample(void);
+
+/**
+ * @brief Get governor state.
+ * @param[out] stats    State.
+ */
+AUTO_LOCAL void imgui_governor_stats(imgui_governor_stats_t* stats);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef __IMGUI_GL_HPP__
+#define __IMGUI_GL_HPP__
+
+/**
+ * @brief OpenGL declarations for code that run inside ImDrawList callbacks.
+ *
+ * Callbacks are executed by the OpenGL3 backend on GUI thread, where the
+ * OpenGL context is current. Only OpenGL 1.1 functions can be called
+ * directly, later ones are not exported on every platform and must be loaded
+ * by the function loader of the backend.
+ */
+
+#if defined(_WIN32)
+#   include <windows.h>
+#endif
+
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+#endif
@@ -0,0 +1,374 @@
+#include <string.h>
+#include <vector>
+#include <implot.h>
+#include <implot_internal.h>
+#include "implot_cache.hpp"
+#include "ImGuiAdapter.hpp"
+#include "governor.hpp"
+#include "lua_imgui.h"
+
+/**
+ * @brief Unused entries are released after this number of frames.
+ */
+#define IMGUI_IMPLOT_CACHE_EXPIRE_FRAMES    120
+
+/**
+ * @brief Vertices that share one vertex offset. Indices are relative to the
+ *   first vertex of span.
+ */
+typedef struct imgui_implot_cache_span
+{
+    int                     vtx_beg;
+    int                     vtx_count;
+    int                     idx_beg;
+    int                     idx_count;
+} imgui_implot_cache_span_t;
+
+typedef struct imgui_implot_cache_sig
+{
+    imgui_implot_cache_kind_t   kind;
+    const void*                 source;     /**< Series source, NULL for Lua table. */
+    uint64_t                    version;    /**< Series version or content hash. */
+    const void*                 x_source;   /**< X series source, NULL for Lua table or index. */
+    uint64_t                    x_version;  /**< X series version or content hash, 0 for index. */
+    size_t                      beg;
+    size_t                      end;
+    ImPlotRange                 x;          /**< Axis limits. */
+    ImPlotRange                 y;
+    ImVec2                      rect_min;   /**< Plot rect. */
+    ImVec2                      rect_max;
+    ImGuiID                     style;      /**< Hash of ImPlotStyle. */
+    ImDrawListFlags             flags;      /**< Draw list flags, which include anti-aliasing. */
+    int                         quality;    /**< Governor quality level. */
+    ImU32                       color;      /**< Item color. */
+    bool                        hovered;    /**< Legend hovered, which highlight item. */
+} imgui_implot_cache_sig_t;
+
+typedef struct imgui_implot_cache_entry
+{
+    auto_map_node_t                         node;
+    ImGuiID                                 id;     /**< Plot item ID. */
+    int                                     frame;  /**< Last frame this entry is used. */
+    bool                                    valid;  /**< Whether geometry match signature. */
+
+    imgui_implot_cache_sig_t                sig;
+    std::vector<ImDrawVert>                 vtx;
+    std::vector<ImDrawIdx>                  idx;
+    std::vector<imgui_implot_cache_span_t>  spans;
+} imgui_implot_cache_entry_t;
+
+static auto_map_t   s_cache_map;
+static int          s_cache_map_init = 0;
+static int          s_cache_sweep_frame = -1;
+static uint64_t     s_cache_hits = 0;
+static uint64_t     s_cache_misses = 0;
+static size_t       s_cache_bytes = 0;
+
+static int _cache_cmp(const auto_map_node_t* key1, const auto_map_node_t* key2, void* arg)
+{
+    (void)arg;
+    const imgui_implot_cache_entry_t* e1 = container_of(key1, imgui_implot_cache_entry_t, node);
+    const imgui_implot_cache_entry_t* e2 = container_of(key2, imgui_implot_cache_entry_t, node);
+    if (e1->id == e2->id)
+    {
+        return 0;
+    }
+    return e1->id < e2->id ? -1 : 1;
+}
+
+static size_t _cache_entry_bytes(const imgui_implot_cache_entry_t* entry)
+{
+    return entry->vtx.size() * sizeof(ImDrawVert) + entry->idx.size() * sizeof(ImDrawIdx)
+        + entry->spans.size() * sizeof(imgui_implot_cache_span_t);
+}
+
+static void _cache_entry_clear(imgui_implot_cache_entry_t* entry)
+{
+    if (entry->valid)
+    {
+        s_cache_bytes -= _cache_entry_bytes(entry);
+    }
+    entry->vtx.clear();
+    entry->idx.clear();
+    entry->spans.clear();
+    entry->valid = false;
+}
+
+/**
+ * @brief Release entries that are not used for a while.
+ */
+static void _cache_sweep(void)
+{
+    int frame = ImGui::GetFrameCount();
+    if (s_cache_sweep_frame == frame)
+    {
+        return;
+    }
+    s_cache_sweep_frame = frame;
+
+    auto_map_node_t* it = api->map->begin(&s_cache_map);
+    while (it != NULL)
+    {
+        imgui_implot_cache_entry_t* entry = container_of(it, imgui_implot_cache_entry_t, node);
+        it = api->map->next(it);
+
+        /* Frame count restarts with a new ImGui context */
+        if (frame - entry->frame > IMGUI_IMPLOT_CACHE_EXPIRE_FRAMES || frame < entry->frame)
+        {
+            api->map->erase(&s_cache_map, &entry->node);
+            _cache_entry_clear(entry);
+            delete entry;
+        }
+    }
+}
+
+static imgui_implot_cache_entry_t* _cache_find(ImGuiID id)
+{
+    if (!s_cache_map_init)
+    {
+        api->map->init(&s_cache_map, _cache_cmp, NULL);
+        s_cache_map_init = 1;
+        ImGuiAdapterAtExit(imgui_implot_cache_clear);
+    }
+    _cache_sweep();
+
+    imgui_implot_cache_entry_t key;
+    key.id = id;
+
+    auto_map_node_t* it = api->map->find(&s_cache_map, &key.node);
+    if (it != NULL)
+    {
+        return container_of(it, imgui_implot_cache_entry_t, node);
+    }
+
+    imgui_implot_cache_entry_t* entry = new imgui_implot_cache_entry_t;
+    entry->id = id;
+    entry->frame = 0;
+    entry->valid = false;
+    api->map->insert(&s_cache_map, &entry->node);
+    return entry;
+}
+
+static bool _cache_sig_equal(const imgui_implot_cache_sig_t* a, const imgui_implot_cache_sig_t* b)
+{
+    return a->kind == b->kind && a->source == b->source && a->version == b->version
+        && a->x_source == b->x_source && a->x_version == b->x_version
+        && a->beg == b->beg && a->end == b->end
+        && a->x.Min == b->x.Min && a->x.Max == b->x.Max
+        && a->y.Min == b->y.Min && a->y.Max == b->y.Max
+        && a->rect_min.x == b->rect_min.x && a->rect_min.y == b->rect_min.y
+        && a->rect_max.x == b->rect_max.x && a->rect_max.y == b->rect_max.y
+        && a->style == b->style && a->flags == b->flags && a->quality == b->quality
+        && a->color == b->color && a->hovered == b->hovered;
+}
+
+static ImPlotCol _cache_recolor(imgui_implot_cache_kind_t kind)
+{
+    switch (kind)
+    {
+    case IMGUI_IMPLOT_CACHE_BARS:       return ImPlotCol_Fill;
+    case IMGUI_IMPLOT_CACHE_SCATTER:    return ImPlotCol_MarkerOutline;
+    case IMGUI_IMPLOT_CACHE_SHADED:     return ImPlotCol_Fill;
+    default:                            break;
+    }
+    return ImPlotCol_Line;
+}
+
+/**
+ * @brief Append cached geometry into plot draw list.
+ */
+static void _cache_draw(const imgui_implot_cache_entry_t* entry)
+{
+    ImDrawList* dl = ImPlot::GetPlotDrawList();
+    for (size_t i = 0; i < entry->spans.size(); i++)
+    {
+        const imgui_implot_cache_span_t* span = &entry->spans[i];
+
+        /* May start a new command with vertex offset, which is what we want */
+        dl->PrimReserve(span->idx_count, span->vtx_count);
+        memcpy(dl->_VtxWritePtr, &entry->vtx[span->vtx_beg], sizeof(ImDrawVert) * span->vtx_count);
+
+        unsigned int base = dl->_VtxCurrentIdx;
+        const ImDrawIdx* src = &entry->idx[span->idx_beg];
+        for (int k = 0; k < span->idx_count; k++)
+        {
+            dl->_IdxWritePtr[k] = (ImDrawIdx)(src[k] + base);
+        }
+
+        dl->_VtxWritePtr += span->vtx_count;
+        dl->_IdxWritePtr += span->idx_count;
+        dl->_VtxCurrentIdx += span->vtx_count;
+    }
+}
+
+bool imgui_implot_cache_replay(imgui_implot_capture_t* cap, const char* label_id,
+    imgui_implot_cache_kind_t kind, const imgui_series_t* xs, const imgui_series_t* values,
+    size_t beg, size_t end)
+{
+    cap->entry = NULL;
+
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    ImPlotItem* item = ImPlot::GetItem(label_id);
+
+    /*
+     * New item has no color yet, and fitting changes limits. Lua table and
+     * bare string do not track changes, and hashing them costs as much as
+     * plotting, so they are never cached.
+     */
+    if (item == NULL || !item->Show || plot->FitThisFrame
+        || values->vtbl == NULL || (xs != NULL && xs->vtbl == NULL))
+    {
+        s_cache_misses++;
+        return false;
+    }
+
+    imgui_implot_cache_sig_t sig;
+    sig.kind = kind;
+    sig.source = values->self;
+    sig.version = values->version;
+    sig.x_source = xs != NULL ? xs->self : NULL;
+    sig.x_version = xs != NULL ? xs->version : 0;
+    sig.beg = beg;
+    sig.end = end;
+    sig.x = plot->Axes[plot->CurrentX].Range;
+    sig.y = plot->Axes[plot->CurrentY].Range;
+    sig.rect_min = plot->PlotRect.Min;
+    sig.rect_max = plot->PlotRect.Max;
+    sig.style = ImHashData(&ImPlot::GetStyle(), sizeof(ImPlotStyle));
+    sig.flags = ImPlot::GetPlotDrawList()->Flags;
+    sig.quality = imgui_governor_level();
+    sig.color = item->Color;
+    sig.hovered = item->LegendHovered;
+
+    imgui_implot_cache_entry_t* entry = _cache_find(ImHashStr(label_id, 0, plot->ID));
+    entry->frame = ImGui::GetFrameCount();
+
+    if (entry->valid && sig.version != 0 && (xs == NULL || sig.x_version != 0)
+        && _cache_sig_equal(&entry->sig, &sig))
+    {
+        s_cache_hits++;
+        if (ImPlot::BeginItem(label_id, 0, _cache_recolor(kind)))
+        {
+            _cache_draw(entry);
+            ImPlot::EndItem();
+        }
+        return true;
+    }
+
+    s_cache_misses++;
+    _cache_entry_clear(entry);
+    entry->sig = sig;
+
+    ImDrawList* dl = ImPlot::GetPlotDrawList();
+    cap->entry = entry;
+    cap->vtx_size = dl->VtxBuffer.Size;
+    cap->idx_size = dl->IdxBuffer.Size;
+    cap->cmd_size = dl->CmdBuffer.Size;
+    return false;
+}
+
+void imgui_implot_cache_store(imgui_implot_capture_t* cap)
+{
+    imgui_implot_cache_entry_t* entry = cap->entry;
+    if (entry == NULL)
+    {
+        return;
+    }
+
+    /*
+     * Walk commands touched by the item, and group indices by vertex offset.
+     * The command that was current before the item may have been extended.
+     */
+    ImDrawList* dl = ImPlot::GetPlotDrawList();
+    int cmd_beg = cap->cmd_size > 0 ? cap->cmd_size - 1 : 0;
+    ImTextureID texture = dl->CmdBuffer.Size > cmd_beg ? dl->CmdBuffer[cmd_beg].TextureId : NULL;
+
+    std::vector<unsigned int> offsets;
+    for (int c = cmd_beg; c < dl->CmdBuffer.Size; c++)
+    {
+        const ImDrawCmd& cmd = dl->CmdBuffer[c];
+        int idx_beg = (int)cmd.IdxOffset > cap->idx_size ? (int)cmd.IdxOffset : cap->idx_size;
+        int idx_end = (int)(cmd.IdxOffset + cmd.ElemCount);
+        if (idx_end <= idx_beg)
+        {
+            continue;
+        }
+
+        /* Callbacks and other textures cannot be replayed as plain vertices */
+        if (cmd.UserCallback != NULL || cmd.TextureId != texture)
+        {
+            _cache_entry_clear(entry);
+            return;
+        }
+
+        if (entry->spans.empty() || offsets.back() != cmd.VtxOffset)
+        {
+            imgui_implot_cache_span_t span;
+            span.vtx_beg = (int)cmd.VtxOffset > cap->vtx_size ? (int)cmd.VtxOffset : cap->vtx_size;
+            span.vtx_count = 0;
+            span.idx_beg = idx_beg;
+            span.idx_count = 0;
+            entry->spans.push_back(span);
+            offsets.push_back(cmd.VtxOffset);
+        }
+        entry->spans.back().idx_count = idx_end - entry->spans.back().idx_beg;
+    }
+
+    /* Convert spans into local storage */
+    for (size_t i = 0; i < entry->spans.size(); i++)
+    {
+        imgui_implot_cache_span_t* span = &entry->spans[i];
+        int vtx_end = i + 1 < entry->spans.size() ? entry->spans[i + 1].vtx_beg : dl->VtxBuffer.Size;
+        int vtx_count = vtx_end - span->vtx_beg;
+        unsigned int shift = (unsigned int)span->vtx_beg - offsets[i];
+
+        int local_vtx = (int)entry->vtx.size();
+        int local_idx = (int)entry->idx.size();
+        entry->vtx.insert(entry->vtx.end(), dl->VtxBuffer.Data + span->vtx_beg, dl->VtxBuffer.Data + vtx_end);
+        for (int k = 0; k < span->idx_count; k++)
+        {
+            unsigned int v = (unsigned int)dl->IdxBuffer.Data[span->idx_beg + k] - shift;
+            if (v >= (unsigned int)vtx_count)
+            {
+                /* Refer to vertex outside of item */
+                _cache_entry_clear(entry);
+                return;
+            }
+            entry->idx.push_back((ImDrawIdx)v);
+        }
+
+        span->vtx_beg = local_vtx;
+        span->vtx_count = vtx_count;
+        span->idx_beg = local_idx;
+    }
+
+    entry->valid = true;
+    s_cache_bytes += _cache_entry_bytes(entry);
+}
+
+void imgui_implot_cache_stats(uint64_t* hits, uint64_t* misses, size_t* bytes)
+{
+    *hits = s_cache_hits;
+    *misses = s_cache_misses;
+    *bytes = s_cache_bytes;
+}
+
+void imgui_implot_cache_clear(void)
+{
+    if (!s_cache_map_init)
+    {
+        return;
+    }
+
+    auto_map_node_t* it = api->map->begin(&s_cache_map);
+    while (it != NULL)
+    {
+        imgui_implot_cache_entry_t* entry = container_of(it, imgui_implot_cache_entry_t, node);
+        it = api->map->next(it);
+
+        api->map->erase(&s_cache_map, &entry->node);
+        _cache_entry_clear(entry);
+        delete entry;
+    }
+    s_cache_sweep_frame = -1;
+}
@@ -0,0 +1,78 @@
+#ifndef __IMPLOT_CACHE_HPP__
+#define __IMPLOT_CACHE_HPP__
+
+#include "series.hpp"
+
+/**
+ * @brief Plot item kind, part of cache key.
+ */
+typedef enum imgui_implot_cache_kind
+{
+    IMGUI_IMPLOT_CACHE_BARS,
+    IMGUI_IMPLOT_CACHE_LINE,
+    IMGUI_IMPLOT_CACHE_SCATTER,
+    IMGUI_IMPLOT_CACHE_SHADED,
+    IMGUI_IMPLOT_CACHE_STAIRS,
+    IMGUI_IMPLOT_CACHE_STEMS,
+} imgui_implot_cache_kind_t;
+
+struct imgui_implot_cache_entry;
+
+/**
+ * @brief Capture state between #imgui_implot_cache_replay() and
+ *   #imgui_implot_cache_store().
+ */
+typedef struct imgui_implot_capture
+{
+    struct imgui_implot_cache_entry*    entry;      /**< Entry to store into, NULL if not cacheable. */
+    int                                 vtx_size;   /**< VtxBuffer size before item is drawn. */
+    int                                 idx_size;   /**< IdxBuffer size before item is drawn. */
+    int                                 cmd_size;   /**< CmdBuffer size before item is drawn. */
+} imgui_implot_capture_t;
+
+/**
+ * @brief Replay cached geometry of plot item if nothing changed.
+ *
+ * The cache key is item kind, source and version of series (content hash for
+ * Lua table), visible range, axis limits, plot rect, style, quality level
+ * and item color.
+ *
+ * On hit, the item is submitted with cached vertices and nothing else need
+ * to be done. On miss, caller must draw the item by itself and then call
+ * #imgui_implot_cache_store().
+ *
+ * @param[out] cap      Capture state.
+ * @param[in] label_id  Item label.
+ * @param[in] kind      Item kind.
+ * @param[in] xs        X series, or NULL if X is element index.
+ * @param[in] values    Series.
+ * @param[in] beg       First element to draw.
+ * @param[in] end       One past last element to draw.
+ * @return              true if hit.
+ */
+AUTO_LOCAL bool imgui_implot_cache_replay(imgui_implot_capture_t* cap, const char* label_id,
+    imgui_implot_cache_kind_t kind, const imgui_series_t* xs, const imgui_series_t* values,
+    size_t beg, size_t end);
+
+/**
+ * @brief Store geometry drawn since #imgui_implot_cache_replay().
+ * @param[in] cap   Capture state.
+ */
+AUTO_LOCAL void imgui_implot_cache_store(imgui_implot_capture_t* cap);
+
+/**
+ * @brief Get cache statistics.
+ * @param[out] hits     The number of cache hits since start.
+ * @param[out] misses   The number of cache misses since start.
+ * @param[out] bytes    Memory used by cached geometry.
+ */
+AUTO_LOCAL void imgui_implot_cache_stats(uint64_t* hits, uint64_t* misses, size_t* bytes);
+
+/**
+ * @brief Release all cached geometry.
+ *
+ * Called when the loop ends and when the module is unloaded.
+ */
+AUTO_LOCAL void imgui_implot_cache_clear(void);
+
+#endif
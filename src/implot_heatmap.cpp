@@ -0,0 +1,348 @@
+#include <stddef.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <implot.h>
+#include <implot_internal.h>
+#include "implot_heatmap.hpp"
+#include "ImGuiAdapter.hpp"
+#include "imgui_gl.hpp"
+#include "lua_imgui.h"
+#include "series.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Maximum texture width or height. Larger matrix is downsampled.
+ */
+#define IMGUI_HEATMAP_MAX_TEXTURE   4096
+
+/**
+ * @brief Unused heatmap textures are released after this number of frames.
+ */
+#define IMGUI_HEATMAP_EXPIRE_FRAMES 120
+
+/**
+ * @brief Number of texture rows baked by a task.
+ */
+#define IMGUI_HEATMAP_BAKE_ROWS     64
+
+typedef struct imgui_heatmap
+{
+    auto_map_node_t     node;
+    ImGuiID             id;         /**< Plot item ID. */
+    int                 frame;      /**< Last frame this heatmap is drawn. */
+
+    GLuint              texture;    /**< OpenGL texture, 0 if not created. */
+    int                 tex_w;      /**< Texture width. */
+    int                 tex_h;      /**< Texture height. */
+
+    struct
+    {
+        const void*     data;       /**< Series source, NULL for Lua table. */
+        uint64_t        version;    /**< Series version or content hash. */
+        int             rows;
+        int             cols;
+        double          scale_min;
+        double          scale_max;
+        ImPlotColormap  cmap;
+    } sig;                          /**< What the texture is baked from. */
+
+    ImU32*              pixels;     /**< Baked pixels waiting for upload. */
+    int                 width;      /**< Baked width. */
+    int                 height;     /**< Baked height. */
+} imgui_heatmap_t;
+
+typedef struct imgui_heatmap_bake
+{
+    imgui_heatmap_t*        hm;
+    const imgui_series_t*   values;
+    double                  scale_min;
+    double                  scale_max;
+    ImU32                   lut[256];
+} imgui_heatmap_bake_t;
+
+static auto_map_t   s_heatmap_map;
+static int          s_heatmap_map_init = 0;
+static int          s_heatmap_sweep_frame = -1;
+
+static int _heatmap_cmp(const auto_map_node_t* key1, const auto_map_node_t* key2, void* arg)
+{
+    (void)arg;
+    const imgui_heatmap_t* hm1 = container_of(key1, imgui_heatmap_t, node);
+    const imgui_heatmap_t* hm2 = container_of(key2, imgui_heatmap_t, node);
+    if (hm1->id == hm2->id)
+    {
+        return 0;
+    }
+    return hm1->id < hm2->id ? -1 : 1;
+}
+
+/**
+ * @brief Upload baked pixels. Called by renderer on GUI thread.
+ */
+static void _heatmap_upload(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+    (void)parent_list;
+    imgui_heatmap_t* hm = (imgui_heatmap_t*)cmd->UserCallbackData;
+    if (hm->pixels == NULL)
+    {
+        return;
+    }
+
+    if (hm->texture == 0)
+    {
+        glGenTextures(1, &hm->texture);
+    }
+    glBindTexture(GL_TEXTURE_2D, hm->texture);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    if (hm->tex_w == hm->width && hm->tex_h == hm->height)
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, hm->width, hm->height,
+            GL_RGBA, GL_UNSIGNED_BYTE, hm->pixels);
+    }
+    else
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, hm->width, hm->height, 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, hm->pixels);
+        hm->tex_w = hm->width;
+        hm->tex_h = hm->height;
+    }
+
+    free(hm->pixels);
+    hm->pixels = NULL;
+}
+
+/**
+ * @brief Release heatmap. Called by renderer on GUI thread.
+ */
+static void _heatmap_destroy(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+    (void)parent_list;
+    imgui_heatmap_t* hm = (imgui_heatmap_t*)cmd->UserCallbackData;
+
+    if (hm->texture != 0)
+    {
+        glDeleteTextures(1, &hm->texture);
+    }
+    free(hm->pixels);
+    free(hm);
+}
+
+/**
+ * @brief Release heatmaps that are not drawn for a while.
+ */
+static void _heatmap_sweep(void)
+{
+    int frame = ImGui::GetFrameCount();
+    if (s_heatmap_sweep_frame == frame)
+    {
+        return;
+    }
+    s_heatmap_sweep_frame = frame;
+
+    auto_map_node_t* it = api->map->begin(&s_heatmap_map);
+    while (it != NULL)
+    {
+        imgui_heatmap_t* hm = container_of(it, imgui_heatmap_t, node);
+        it = api->map->next(it);
+
+        if (frame - hm->frame > IMGUI_HEATMAP_EXPIRE_FRAMES)
+        {
+            api->map->erase(&s_heatmap_map, &hm->node);
+            ImGui::GetForegroundDrawList()->AddCallback(_heatmap_destroy, hm);
+        }
+    }
+}
+
+/**
+ * @brief Release all heatmaps when the loop ends. Textures belong to the
+ *   OpenGL context of that loop.
+ */
+static void _heatmap_exit(void)
+{
+    if (!s_heatmap_map_init)
+    {
+        return;
+    }
+
+    auto_map_node_t* it = api->map->begin(&s_heatmap_map);
+    while (it != NULL)
+    {
+        imgui_heatmap_t* hm = container_of(it, imgui_heatmap_t, node);
+        it = api->map->next(it);
+
+        api->map->erase(&s_heatmap_map, &hm->node);
+        if (hm->texture != 0)
+        {
+            glDeleteTextures(1, &hm->texture);
+        }
+        free(hm->pixels);
+        free(hm);
+    }
+    s_heatmap_sweep_frame = -1;
+}
+
+static imgui_heatmap_t* _heatmap_find(ImGuiID id)
+{
+    if (!s_heatmap_map_init)
+    {
+        api->map->init(&s_heatmap_map, _heatmap_cmp, NULL);
+        s_heatmap_map_init = 1;
+        ImGuiAdapterAtExit(_heatmap_exit);
+    }
+    _heatmap_sweep();
+
+    imgui_heatmap_t key;
+    key.id = id;
+
+    auto_map_node_t* it = api->map->find(&s_heatmap_map, &key.node);
+    if (it != NULL)
+    {
+        return container_of(it, imgui_heatmap_t, node);
+    }
+
+    imgui_heatmap_t* hm = (imgui_heatmap_t*)calloc(1, sizeof(imgui_heatmap_t));
+    hm->id = id;
+    api->map->insert(&s_heatmap_map, &hm->node);
+    return hm;
+}
+
+static void _heatmap_bake_task(void* arg, size_t idx)
+{
+    imgui_heatmap_bake_t* bake = (imgui_heatmap_bake_t*)arg;
+    imgui_heatmap_t* hm = bake->hm;
+    const imgui_series_t* values = bake->values;
+    double range = bake->scale_max - bake->scale_min;
+
+    int y_beg = (int)idx * IMGUI_HEATMAP_BAKE_ROWS;
+    int y_end = y_beg + IMGUI_HEATMAP_BAKE_ROWS < hm->height ? y_beg + IMGUI_HEATMAP_BAKE_ROWS : hm->height;
+
+    for (int y = y_beg; y < y_end; y++)
+    {
+        size_t row = (size_t)y * hm->sig.rows / hm->height;
+        for (int x = 0; x < hm->width; x++)
+        {
+            size_t col = (size_t)x * hm->sig.cols / hm->width;
+            size_t i = (row * hm->sig.cols + col + values->offset) % values->count;
+
+            /* Missing cells are transparent */
+            double v = imgui_series_get(values, i);
+            if (!isfinite(v))
+            {
+                hm->pixels[(size_t)y * hm->width + x] = 0;
+                continue;
+            }
+
+            /* Written so that NaN from an infinite scale also maps to 0 */
+            double t = range > 0 ? (v - bake->scale_min) / range : 0.0;
+            t = t > 0 ? (t < 1 ? t : 1) : 0;
+            hm->pixels[(size_t)y * hm->width + x] = bake->lut[(int)(t * 255.0 + 0.5)];
+        }
+    }
+}
+
+static void _heatmap_bake(imgui_heatmap_t* hm, const imgui_series_t* values)
+{
+    imgui_heatmap_bake_t bake;
+    bake.hm = hm;
+    bake.values = values;
+    bake.scale_min = hm->sig.scale_min;
+    bake.scale_max = hm->sig.scale_max;
+
+    /* Automatic color scaling, the same as ImPlot::PlotHeatmap() */
+    if (bake.scale_min == 0 && bake.scale_max == 0)
+    {
+        bake.scale_min = DBL_MAX;
+        bake.scale_max = -DBL_MAX;
+        for (size_t i = 0; i < values->count; i++)
+        {
+            double v = imgui_series_get(values, i);
+            if (!isfinite(v))
+            {
+                continue;
+            }
+            bake.scale_min = v < bake.scale_min ? v : bake.scale_min;
+            bake.scale_max = v > bake.scale_max ? v : bake.scale_max;
+        }
+    }
+
+    for (int i = 0; i < 256; i++)
+    {
+        ImVec4 color = ImPlot::SampleColormap(i / 255.0f, hm->sig.cmap);
+        bake.lut[i] = ImGui::ColorConvertFloat4ToU32(color);
+    }
+
+    hm->width = hm->sig.cols < IMGUI_HEATMAP_MAX_TEXTURE ? hm->sig.cols : IMGUI_HEATMAP_MAX_TEXTURE;
+    hm->height = hm->sig.rows < IMGUI_HEATMAP_MAX_TEXTURE ? hm->sig.rows : IMGUI_HEATMAP_MAX_TEXTURE;
+
+    free(hm->pixels);
+    hm->pixels = (ImU32*)malloc(sizeof(ImU32) * hm->width * hm->height);
+
+    size_t num_task = (hm->height + IMGUI_HEATMAP_BAKE_ROWS - 1) / IMGUI_HEATMAP_BAKE_ROWS;
+    imgui_pool_parallel(num_task, _heatmap_bake_task, &bake);
+}
+
+int imgui_implot_plot_heatmap_texture(lua_State* L)
+{
+    const char* label_id = api->lua->L_checklstring(L, 1, NULL);
+    int rows = (int)api->lua->L_checkinteger(L, 3);
+    int cols = (int)api->lua->L_checkinteger(L, 4);
+    double scale_min = api->lua->type(L, 5) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 5) : 0.0;
+    double scale_max = api->lua->type(L, 6) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 6) : 0.0;
+
+    imgui_series_t values;
+    imgui_series_check(L, 2, &values);
+
+    if (rows <= 0 || cols <= 0 || values.count != (size_t)rows * cols)
+    {
+        imgui_series_release(&values);
+        return api->lua->L_error(L, "table size(%d) not match with rows*cols(%d)", (int)values.count, rows * cols);
+    }
+
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    imgui_heatmap_t* hm = _heatmap_find(ImHashStr(label_id, 0, plot->ID));
+    hm->frame = ImGui::GetFrameCount();
+
+    /* Lua table and bare string have no version, so they are baked every frame */
+    const void* source = values.self;
+    uint64_t version = values.version;
+    ImPlotColormap cmap = ImPlot::GetStyle().Colormap;
+
+    if (hm->sig.data != source || hm->sig.version != version || hm->sig.version == 0
+        || hm->sig.rows != rows || hm->sig.cols != cols || hm->sig.cmap != cmap
+        || hm->sig.scale_min != scale_min || hm->sig.scale_max != scale_max)
+    {
+        hm->sig.data = source;
+        hm->sig.version = version;
+        hm->sig.rows = rows;
+        hm->sig.cols = cols;
+        hm->sig.scale_min = scale_min;
+        hm->sig.scale_max = scale_max;
+        hm->sig.cmap = cmap;
+
+        imgui_series_prepare(&values, 0, values.count);
+        _heatmap_bake(hm, &values);
+    }
+    imgui_series_release(&values);
+
+    if (hm->pixels != NULL)
+    {
+        ImPlot::GetPlotDrawList()->AddCallback(_heatmap_upload, hm);
+    }
+
+    /* Texture is created on first render, so nothing to draw until then */
+    if (hm->texture == 0)
+    {
+        ImPlot::PlotDummy(label_id);
+        return 0;
+    }
+
+    ImPlot::PlotImage(label_id, (ImTextureID)(intptr_t)hm->texture,
+        ImPlotPoint(0, 0), ImPlotPoint(1, 1));
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef __IMPLOT_HEATMAP_HPP__
+#define __IMPLOT_HEATMAP_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Plot heatmap as a single textured quad.
+ *
+ * [1]: string label_id
+ * [2]: series values, row-major
+ * [3]: integer rows
+ * [4]: integer cols
+ * [5]: number scale_min, optional
+ * [6]: number scale_max, optional
+ *
+ * @param[in] L     Lua VM.
+ * @return          Always 0.
+ */
+AUTO_LOCAL int imgui_implot_plot_heatmap_texture(lua_State* L);
+
+#endif
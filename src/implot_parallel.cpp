@@ -0,0 +1,380 @@
+#include <math.h>
+#include <vector>
+#include <implot.h>
+#include <implot_internal.h>
+#include "implot_parallel.hpp"
+#include "governor.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Number of primitives tessellated by a task.
+ *
+ * A chunk is reserved by a single PrimReserve(), and must stay below 64K
+ * vertices for 16-bit indices.
+ */
+#define IMGUI_PARALLEL_CHUNK_PRIMS      4096
+
+/**
+ * @brief Number of vertices of a circle marker.
+ */
+#define IMGUI_PARALLEL_CIRCLE_SEGMENTS  8
+
+typedef enum imgui_parallel_shape
+{
+    IMGUI_PARALLEL_LINE,
+    IMGUI_PARALLEL_SQUARE,
+    IMGUI_PARALLEL_CIRCLE,
+} imgui_parallel_shape_t;
+
+typedef double (*imgui_parallel_get_fn)(const imgui_series_t* series, size_t idx);
+
+typedef struct imgui_parallel_chunk
+{
+    size_t                  beg;        /**< First primitive. */
+    size_t                  end;        /**< One past last primitive. */
+    size_t                  count;      /**< The number of visible primitives. */
+    int                     vtx_pos;    /**< Position in VtxBuffer. */
+    int                     idx_pos;    /**< Position in IdxBuffer. */
+    unsigned int            vtx_base;   /**< Index of first vertex. */
+} imgui_parallel_chunk_t;
+
+typedef struct imgui_parallel_job
+{
+    const imgui_series_t*   xs;
+    const imgui_series_t*   ys;
+    double                  x0;         /**< X of element 0 if X is element index. */
+    size_t                  beg;        /**< First element. */
+    size_t                  last;       /**< Last element. */
+    size_t                  step;       /**< Elements per primitive, for downsampling. */
+    imgui_parallel_get_fn   get_x;
+    imgui_parallel_get_fn   get_y;
+    const ImPlotAxis*       x_axis;
+    const ImPlotAxis*       y_axis;
+
+    imgui_parallel_shape_t  shape;
+    ImRect                  clip;       /**< Plot area, expanded by primitive size. */
+    float                   size;       /**< Half of line weight or marker radius. */
+    ImU32                   col;
+    ImVec2                  uv;         /**< White pixel. */
+    ImVec2                  circle[IMGUI_PARALLEL_CIRCLE_SEGMENTS];
+    int                     vtx_per_prim;
+    int                     idx_per_prim;
+
+    ImDrawList*             dl;
+    std::vector<imgui_parallel_chunk_t> chunks;
+} imgui_parallel_job_t;
+
+/**
+ * @brief Read element with ring offset applied.
+ */
+template <typename T>
+static double _parallel_get(const imgui_series_t* series, size_t idx)
+{
+    idx += series->offset;
+    idx = idx < series->count ? idx : idx - series->count;
+    return (double)*(const T*)((const char*)series->data + idx * series->stride);
+}
+
+static double _parallel_get_index(const imgui_series_t* series, size_t idx)
+{
+    (void)series;
+    return (double)idx;
+}
+
+static imgui_parallel_get_fn _parallel_getter(const imgui_series_t* series)
+{
+    if (series == NULL)
+    {
+        return _parallel_get_index;
+    }
+    IMGUI_DTYPE_DISPATCH(series->type, T, return _parallel_get<T>);
+    return _parallel_get_index;
+}
+
+static bool _parallel_point(const imgui_parallel_job_t* job, size_t idx, ImVec2* p)
+{
+    double x = job->x0 + job->get_x(job->xs, idx);
+    double y = job->get_y(job->ys, idx);
+    if (!isfinite(x) || !isfinite(y))
+    {
+        return false;
+    }
+    p->x = job->x_axis->PlotToPixels(x);
+    p->y = job->y_axis->PlotToPixels(y);
+    return true;
+}
+
+/**
+ * @brief Get element of primitive \p prim. The last element is always drawn.
+ */
+static size_t _parallel_elem(const imgui_parallel_job_t* job, size_t prim)
+{
+    size_t idx = job->beg + prim * job->step;
+    return idx < job->last ? idx : job->last;
+}
+
+/**
+ * @brief Get pixel position of primitive \p idx if it is visible.
+ *
+ * Both count pass and write pass use this, so they always agree on the
+ * number of primitives.
+ */
+static bool _parallel_visible(const imgui_parallel_job_t* job, size_t idx, ImVec2* p0, ImVec2* p1)
+{
+    const ImRect& clip = job->clip;
+    if (!_parallel_point(job, _parallel_elem(job, idx), p0))
+    {
+        return false;
+    }
+
+    if (job->shape != IMGUI_PARALLEL_LINE)
+    {
+        return clip.Contains(*p0);
+    }
+
+    if (!_parallel_point(job, _parallel_elem(job, idx + 1), p1))
+    {
+        return false;
+    }
+    return !((p0->x < clip.Min.x && p1->x < clip.Min.x) || (p0->x > clip.Max.x && p1->x > clip.Max.x)
+        || (p0->y < clip.Min.y && p1->y < clip.Min.y) || (p0->y > clip.Max.y && p1->y > clip.Max.y));
+}
+
+static void _parallel_count_task(void* arg, size_t idx)
+{
+    imgui_parallel_job_t* job = (imgui_parallel_job_t*)arg;
+    imgui_parallel_chunk_t* chunk = &job->chunks[idx];
+
+    ImVec2 p0, p1;
+    chunk->count = 0;
+    for (size_t i = chunk->beg; i < chunk->end; i++)
+    {
+        chunk->count += _parallel_visible(job, i, &p0, &p1);
+    }
+}
+
+static void _parallel_write_task(void* arg, size_t idx)
+{
+    imgui_parallel_job_t* job = (imgui_parallel_job_t*)arg;
+    imgui_parallel_chunk_t* chunk = &job->chunks[idx];
+    if (chunk->count == 0)
+    {
+        return;
+    }
+
+    ImDrawVert* vtx = job->dl->VtxBuffer.Data + chunk->vtx_pos;
+    ImDrawIdx* idx_ptr = job->dl->IdxBuffer.Data + chunk->idx_pos;
+    unsigned int base = chunk->vtx_base;
+    const float s = job->size;
+    const ImVec2 uv = job->uv;
+    const ImU32 col = job->col;
+
+    ImVec2 p0, p1;
+    for (size_t i = chunk->beg; i < chunk->end; i++)
+    {
+        if (!_parallel_visible(job, i, &p0, &p1))
+        {
+            continue;
+        }
+
+        switch (job->shape)
+        {
+        case IMGUI_PARALLEL_LINE:
+        {
+            float dx = p1.x - p0.x, dy = p1.y - p0.y;
+            float len2 = dx * dx + dy * dy;
+            float inv = len2 > 0 ? s / sqrtf(len2) : 0;
+            float nx = -dy * inv, ny = dx * inv;
+            vtx[0].pos = ImVec2(p0.x + nx, p0.y + ny);
+            vtx[1].pos = ImVec2(p1.x + nx, p1.y + ny);
+            vtx[2].pos = ImVec2(p1.x - nx, p1.y - ny);
+            vtx[3].pos = ImVec2(p0.x - nx, p0.y - ny);
+            break;
+        }
+
+        case IMGUI_PARALLEL_SQUARE:
+            vtx[0].pos = ImVec2(p0.x - s, p0.y - s);
+            vtx[1].pos = ImVec2(p0.x + s, p0.y - s);
+            vtx[2].pos = ImVec2(p0.x + s, p0.y + s);
+            vtx[3].pos = ImVec2(p0.x - s, p0.y + s);
+            break;
+
+        case IMGUI_PARALLEL_CIRCLE:
+            for (int k = 0; k < IMGUI_PARALLEL_CIRCLE_SEGMENTS; k++)
+            {
+                vtx[k].pos = ImVec2(p0.x + job->circle[k].x, p0.y + job->circle[k].y);
+            }
+            break;
+        }
+
+        for (int k = 0; k < job->vtx_per_prim; k++)
+        {
+            vtx[k].uv = uv;
+            vtx[k].col = col;
+        }
+
+        /* Triangle fan, quad is a fan of 4 vertices */
+        for (int k = 1; k < job->vtx_per_prim - 1; k++)
+        {
+            idx_ptr[0] = (ImDrawIdx)(base);
+            idx_ptr[1] = (ImDrawIdx)(base + k);
+            idx_ptr[2] = (ImDrawIdx)(base + k + 1);
+            idx_ptr += 3;
+        }
+
+        vtx += job->vtx_per_prim;
+        base += job->vtx_per_prim;
+    }
+}
+
+/**
+ * @brief Fit axes to data. Only called when plot is fitting, where the whole
+ *   series is submitted.
+ */
+static void _parallel_fit(const imgui_series_t* xs, const imgui_series_t* ys, double x0,
+    size_t beg, size_t end)
+{
+    imgui_stats_t x_stats, y_stats;
+    imgui_stats_summary(ys, &y_stats);
+    if (xs != NULL)
+    {
+        imgui_stats_summary(xs, &x_stats);
+    }
+    else
+    {
+        x_stats.min = x0 + (double)beg;
+        x_stats.max = x0 + (double)(end - 1);
+    }
+
+    ImPlot::FitPoint(ImPlotPoint(x_stats.min, y_stats.min));
+    ImPlot::FitPoint(ImPlotPoint(x_stats.max, y_stats.max));
+}
+
+static bool _parallel_plot(const char* label_id, const imgui_series_t* xs, const imgui_series_t* ys,
+    double x0, size_t beg, size_t end, bool line)
+{
+    if (end - beg < IMGUI_IMPLOT_PARALLEL_MIN || imgui_pool_concurrency() == 0)
+    {
+        return false;
+    }
+
+    /* Chunks are reserved separately, so vertex offset must be available */
+    ImDrawList* dl = ImPlot::GetPlotDrawList();
+    if (sizeof(ImDrawIdx) == 2 && !(dl->Flags & ImDrawListFlags_AllowVtxOffset))
+    {
+        return false;
+    }
+
+    /* Line markers are left to ImPlot */
+    if (line && ImPlot::GetStyle().Marker != ImPlotMarker_None)
+    {
+        return false;
+    }
+
+    if (!ImPlot::BeginItem(label_id, 0, line ? ImPlotCol_Line : ImPlotCol_MarkerFill))
+    {
+        return true;
+    }
+    if (ImPlot::FitThisFrame())
+    {
+        _parallel_fit(xs, ys, xs != NULL ? 0 : x0, beg, end);
+    }
+
+    const ImPlotNextItemData& s = ImPlot::GetItemData();
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+
+    imgui_parallel_job_t job;
+    job.xs = xs;
+    job.ys = ys;
+    job.x0 = xs != NULL ? 0 : x0;
+    job.get_x = _parallel_getter(xs);
+    job.get_y = _parallel_getter(ys);
+    job.x_axis = &plot->Axes[plot->CurrentX];
+    job.y_axis = &plot->Axes[plot->CurrentY];
+    job.uv = dl->_Data->TexUvWhitePixel;
+    job.dl = dl;
+
+    if (line)
+    {
+        job.shape = IMGUI_PARALLEL_LINE;
+        job.size = s.LineWeight * 0.5f;
+        job.col = ImGui::GetColorU32(s.Colors[ImPlotCol_Line]);
+        job.vtx_per_prim = 4;
+    }
+    else
+    {
+        job.shape = s.Marker == ImPlotMarker_Square || imgui_governor_level() >= 2
+            ? IMGUI_PARALLEL_SQUARE : IMGUI_PARALLEL_CIRCLE;
+        job.size = s.MarkerSize;
+        job.col = ImGui::GetColorU32(s.Colors[ImPlotCol_MarkerFill]);
+        job.vtx_per_prim = job.shape == IMGUI_PARALLEL_SQUARE ? 4 : IMGUI_PARALLEL_CIRCLE_SEGMENTS;
+        for (int k = 0; k < IMGUI_PARALLEL_CIRCLE_SEGMENTS; k++)
+        {
+            float a = k * 2 * 3.14159265f / IMGUI_PARALLEL_CIRCLE_SEGMENTS;
+            job.circle[k] = ImVec2(cosf(a) * job.size, sinf(a) * job.size);
+        }
+    }
+    job.idx_per_prim = (job.vtx_per_prim - 2) * 3;
+    job.clip = ImRect(ImVec2(plot->PlotRect.Min.x - job.size, plot->PlotRect.Min.y - job.size),
+        ImVec2(plot->PlotRect.Max.x + job.size, plot->PlotRect.Max.y + job.size));
+
+    /* A line of N points has N-1 segments */
+    job.beg = beg;
+    job.last = end - 1;
+    job.step = (size_t)imgui_governor_downsample();
+    size_t num_prims = line ? end - beg - 1 : end - beg;
+    num_prims = (num_prims + job.step - 1) / job.step;
+    for (size_t i = 0; i < num_prims; i += IMGUI_PARALLEL_CHUNK_PRIMS)
+    {
+        imgui_parallel_chunk_t chunk;
+        chunk.beg = i;
+        chunk.end = i + IMGUI_PARALLEL_CHUNK_PRIMS < num_prims ? i + IMGUI_PARALLEL_CHUNK_PRIMS : num_prims;
+        chunk.count = 0;
+        chunk.vtx_pos = chunk.idx_pos = 0;
+        chunk.vtx_base = 0;
+        job.chunks.push_back(chunk);
+    }
+
+    imgui_pool_parallel(job.chunks.size(), _parallel_count_task, &job);
+
+    /*
+     * Reserve every chunk in order, so the draw list start a new command with
+     * vertex offset whenever 16-bit indices would overflow. Buffers may grow
+     * on each reserve, so only positions are recorded.
+     */
+    for (size_t i = 0; i < job.chunks.size(); i++)
+    {
+        imgui_parallel_chunk_t* chunk = &job.chunks[i];
+        if (chunk->count == 0)
+        {
+            continue;
+        }
+        int vtx_count = (int)chunk->count * job.vtx_per_prim;
+        int idx_count = (int)chunk->count * job.idx_per_prim;
+        dl->PrimReserve(idx_count, vtx_count);
+        chunk->vtx_pos = dl->VtxBuffer.Size - vtx_count;
+        chunk->idx_pos = dl->IdxBuffer.Size - idx_count;
+        chunk->vtx_base = dl->_VtxCurrentIdx;
+        dl->_VtxCurrentIdx += vtx_count;
+    }
+    dl->_VtxWritePtr = dl->VtxBuffer.Data + dl->VtxBuffer.Size;
+    dl->_IdxWritePtr = dl->IdxBuffer.Data + dl->IdxBuffer.Size;
+
+    imgui_pool_parallel(job.chunks.size(), _parallel_write_task, &job);
+
+    ImPlot::EndItem();
+    return true;
+}
+
+bool imgui_implot_parallel_line(const char* label_id,
+    const imgui_series_t* xs, const imgui_series_t* ys, double x0, size_t beg, size_t end)
+{
+    return _parallel_plot(label_id, xs, ys, x0, beg, end, true);
+}
+
+bool imgui_implot_parallel_scatter(const char* label_id,
+    const imgui_series_t* xs, const imgui_series_t* ys, double x0, size_t beg, size_t end)
+{
+    return _parallel_plot(label_id, xs, ys, x0, beg, end, false);
+}
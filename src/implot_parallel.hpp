@@ -0,0 +1,37 @@
+#ifndef __IMPLOT_PARALLEL_HPP__
+#define __IMPLOT_PARALLEL_HPP__
+
+#include "series.hpp"
+
+/**
+ * @brief Minimum number of elements to use parallel tessellation.
+ */
+#define IMGUI_IMPLOT_PARALLEL_MIN   16384
+
+/**
+ * @brief Plot line with vertices generated on worker pool.
+ *
+ * Elements in [beg, end) are drawn. If \p xs is NULL, element index plus
+ * \p x0 is used as X value.
+ *
+ * @param[in] label_id  Item label.
+ * @param[in] xs        X series, or NULL.
+ * @param[in] ys        Y series.
+ * @param[in] x0        X of element 0 if \p xs is NULL.
+ * @param[in] beg       First element.
+ * @param[in] end       One past last element.
+ * @return              false if series is too small or current draw list
+ *                      does not support it. Nothing is submitted in this
+ *                      case and caller should use ImPlot instead.
+ */
+AUTO_LOCAL bool imgui_implot_parallel_line(const char* label_id,
+    const imgui_series_t* xs, const imgui_series_t* ys, double x0, size_t beg, size_t end);
+
+/**
+ * @brief Plot scatter with vertices generated on worker pool.
+ * @see #imgui_implot_parallel_line()
+ */
+AUTO_LOCAL bool imgui_implot_parallel_scatter(const char* label_id,
+    const imgui_series_t* xs, const imgui_series_t* ys, double x0, size_t beg, size_t end);
+
+#endif
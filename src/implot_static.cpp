@@ -0,0 +1,523 @@
+#include <stddef.h>
+#include <string.h>
+#include <implot.h>
+#include <implot_internal.h>
+#include "implot_static.hpp"
+#include "ImGuiAdapter.hpp"
+#include "imgui_gl.hpp"
+#include "lua_imgui.h"
+#include "series.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Unused vertex buffers are released after this number of frames.
+ */
+#define IMGUI_STATIC_EXPIRE_FRAMES  120
+
+/**
+ * @brief Number of vertices converted by a task.
+ */
+#define IMGUI_STATIC_CHUNK_SIZE     65536
+
+/**
+ * @brief OpenGL 2.0 and 3.0 functions used by static lines, loaded by
+ *   #imgui_implot_static_init().
+ */
+#define IMGUI_STATIC_GL_FUNCS(X)\
+    X(PFNGLATTACHSHADERPROC, AttachShader)\
+    X(PFNGLBINDATTRIBLOCATIONPROC, BindAttribLocation)\
+    X(PFNGLBINDBUFFERPROC, BindBuffer)\
+    X(PFNGLBINDVERTEXARRAYPROC, BindVertexArray)\
+    X(PFNGLBUFFERDATAPROC, BufferData)\
+    X(PFNGLCOMPILESHADERPROC, CompileShader)\
+    X(PFNGLCREATEPROGRAMPROC, CreateProgram)\
+    X(PFNGLCREATESHADERPROC, CreateShader)\
+    X(PFNGLDELETEBUFFERSPROC, DeleteBuffers)\
+    X(PFNGLDELETEPROGRAMPROC, DeleteProgram)\
+    X(PFNGLDELETESHADERPROC, DeleteShader)\
+    X(PFNGLDELETEVERTEXARRAYSPROC, DeleteVertexArrays)\
+    X(PFNGLDETACHSHADERPROC, DetachShader)\
+    X(PFNGLENABLEVERTEXATTRIBARRAYPROC, EnableVertexAttribArray)\
+    X(PFNGLGENBUFFERSPROC, GenBuffers)\
+    X(PFNGLGENVERTEXARRAYSPROC, GenVertexArrays)\
+    X(PFNGLGETPROGRAMIVPROC, GetProgramiv)\
+    X(PFNGLGETUNIFORMLOCATIONPROC, GetUniformLocation)\
+    X(PFNGLLINKPROGRAMPROC, LinkProgram)\
+    X(PFNGLSHADERSOURCEPROC, ShaderSource)\
+    X(PFNGLUNIFORM4FPROC, Uniform4f)\
+    X(PFNGLUSEPROGRAMPROC, UseProgram)\
+    X(PFNGLVERTEXATTRIBPOINTERPROC, VertexAttribPointer)
+
+typedef struct imgui_static_gl
+{
+#define IMGUI_STATIC_GL_FIELD(type, name)   type name;
+    IMGUI_STATIC_GL_FUNCS(IMGUI_STATIC_GL_FIELD)
+#undef IMGUI_STATIC_GL_FIELD
+} imgui_static_gl_t;
+
+struct imgui_static_line;
+
+/**
+ * @brief Parameters of one draw command.
+ */
+typedef struct imgui_static_draw
+{
+    struct imgui_static_line*   line;
+    float                       transform[4];   /**< Vertex to pixel: scale x/y, offset x/y. */
+    float                       color[4];       /**< Line color. */
+    float                       display[4];     /**< Display position and size. */
+    float                       fb_scale[2];    /**< Framebuffer scale. */
+    float                       width;          /**< Line width in framebuffer pixels. */
+} imgui_static_draw_t;
+
+typedef struct imgui_static_line
+{
+    auto_map_node_t     node;
+    ImGuiID             id;         /**< Plot item ID. */
+    int                 frame;      /**< Last frame this line is drawn. */
+
+    GLuint              vao;        /**< Vertex array, 0 if not created. Only used on GUI thread. */
+    GLuint              vbo;        /**< Vertex buffer, 0 if not created. Only used on GUI thread. */
+    GLsizei             num_vertex; /**< The number of vertices in buffer. Only used on GUI thread. */
+
+    struct
+    {
+        const void*     data;       /**< Series source, NULL for Lua table. */
+        uint64_t        version;    /**< Series version or content hash. */
+        size_t          count;
+    } sig;                          /**< What the vertex buffer is built from. */
+
+    float*              vertices;   /**< Vertices waiting for upload, (x, y) pairs. */
+    size_t              count;      /**< The number of vertices waiting for upload. */
+    double              origin_x;   /**< Vertices are relative to origin to keep float precision. */
+    double              origin_y;
+    double              y_min;      /**< Value range, for fitting. */
+    double              y_max;
+
+    imgui_static_draw_t draw;       /**< Draw parameters of current frame. */
+} imgui_static_line_t;
+
+typedef struct imgui_static_build
+{
+    imgui_static_line_t*    line;
+    const imgui_series_t*   values;
+} imgui_static_build_t;
+
+static auto_map_t   s_static_map;
+static int          s_static_map_init = 0;
+static int          s_static_sweep_frame = -1;
+
+static imgui_static_gl_t s_static_gl;
+static bool         s_static_gl_ok = false;
+static float        s_static_width_max = 1.0f;  /**< Widest line the driver can draw. */
+
+static GLuint       s_static_program = 0;
+static GLint        s_static_loc_transform = -1;
+static GLint        s_static_loc_display = -1;
+static GLint        s_static_loc_color = -1;
+
+static const char* s_static_vs =
+    "#version 130\n"
+    "in vec2 Position;\n"
+    "uniform vec4 Transform;\n"
+    "uniform vec4 Display;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 px = Position * Transform.xy + Transform.zw;\n"
+    "    vec2 ndc = (px - Display.xy) / Display.zw * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* s_static_fs =
+    "#version 130\n"
+    "uniform vec4 Color;\n"
+    "out vec4 Out_Color;\n"
+    "void main()\n"
+    "{\n"
+    "    Out_Color = Color;\n"
+    "}\n";
+
+static int _static_cmp(const auto_map_node_t* key1, const auto_map_node_t* key2, void* arg)
+{
+    (void)arg;
+    const imgui_static_line_t* l1 = container_of(key1, imgui_static_line_t, node);
+    const imgui_static_line_t* l2 = container_of(key2, imgui_static_line_t, node);
+    if (l1->id == l2->id)
+    {
+        return 0;
+    }
+    return l1->id < l2->id ? -1 : 1;
+}
+
+/**
+ * @brief Compile shader program on first use. Called on GUI thread.
+ * @return  Whether program is available.
+ */
+static bool _static_program(void)
+{
+    if (s_static_program != 0)
+    {
+        return true;
+    }
+
+    GLint ok = 0;
+    GLuint vs = s_static_gl.CreateShader(GL_VERTEX_SHADER);
+    s_static_gl.ShaderSource(vs, 1, &s_static_vs, NULL);
+    s_static_gl.CompileShader(vs);
+
+    GLuint fs = s_static_gl.CreateShader(GL_FRAGMENT_SHADER);
+    s_static_gl.ShaderSource(fs, 1, &s_static_fs, NULL);
+    s_static_gl.CompileShader(fs);
+
+    GLuint program = s_static_gl.CreateProgram();
+    s_static_gl.AttachShader(program, vs);
+    s_static_gl.AttachShader(program, fs);
+    s_static_gl.BindAttribLocation(program, 0, "Position");
+    s_static_gl.LinkProgram(program);
+    s_static_gl.GetProgramiv(program, GL_LINK_STATUS, &ok);
+
+    s_static_gl.DetachShader(program, vs);
+    s_static_gl.DetachShader(program, fs);
+    s_static_gl.DeleteShader(vs);
+    s_static_gl.DeleteShader(fs);
+
+    if (!ok)
+    {
+        s_static_gl.DeleteProgram(program);
+        return false;
+    }
+
+    s_static_program = program;
+    s_static_loc_transform = s_static_gl.GetUniformLocation(program, "Transform");
+    s_static_loc_display = s_static_gl.GetUniformLocation(program, "Display");
+    s_static_loc_color = s_static_gl.GetUniformLocation(program, "Color");
+    return true;
+}
+
+/**
+ * @brief Upload pending vertices. Called by renderer on GUI thread.
+ */
+static void _static_upload(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+    (void)parent_list;
+    imgui_static_line_t* line = (imgui_static_line_t*)cmd->UserCallbackData;
+    if (line->vertices == NULL)
+    {
+        return;
+    }
+
+    if (line->vao == 0)
+    {
+        s_static_gl.GenVertexArrays(1, &line->vao);
+        s_static_gl.GenBuffers(1, &line->vbo);
+        s_static_gl.BindVertexArray(line->vao);
+        s_static_gl.BindBuffer(GL_ARRAY_BUFFER, line->vbo);
+        s_static_gl.EnableVertexAttribArray(0);
+        s_static_gl.VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, NULL);
+    }
+
+    s_static_gl.BindBuffer(GL_ARRAY_BUFFER, line->vbo);
+    s_static_gl.BufferData(GL_ARRAY_BUFFER, sizeof(float) * 2 * line->count, line->vertices, GL_STATIC_DRAW);
+    line->num_vertex = (GLsizei)line->count;
+
+    free(line->vertices);
+    line->vertices = NULL;
+}
+
+/**
+ * @brief Draw line. Called by renderer on GUI thread.
+ */
+static void _static_draw(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+    (void)parent_list;
+    const imgui_static_draw_t* draw = (const imgui_static_draw_t*)cmd->UserCallbackData;
+    const imgui_static_line_t* line = draw->line;
+
+    if (line->num_vertex < 2 || !_static_program())
+    {
+        return;
+    }
+
+    /* The backend does not apply clip rect of callback command */
+    float fb_height = draw->display[3] * draw->fb_scale[1];
+    float clip_min_x = (cmd->ClipRect.x - draw->display[0]) * draw->fb_scale[0];
+    float clip_min_y = (cmd->ClipRect.y - draw->display[1]) * draw->fb_scale[1];
+    float clip_max_x = (cmd->ClipRect.z - draw->display[0]) * draw->fb_scale[0];
+    float clip_max_y = (cmd->ClipRect.w - draw->display[1]) * draw->fb_scale[1];
+    if (clip_max_x <= clip_min_x || clip_max_y <= clip_min_y)
+    {
+        return;
+    }
+    glScissor((int)clip_min_x, (int)(fb_height - clip_max_y),
+        (int)(clip_max_x - clip_min_x), (int)(clip_max_y - clip_min_y));
+
+    s_static_gl.UseProgram(s_static_program);
+    s_static_gl.Uniform4f(s_static_loc_transform, draw->transform[0], draw->transform[1],
+        draw->transform[2], draw->transform[3]);
+    s_static_gl.Uniform4f(s_static_loc_display, draw->display[0], draw->display[1],
+        draw->display[2], draw->display[3]);
+    s_static_gl.Uniform4f(s_static_loc_color, draw->color[0], draw->color[1], draw->color[2], draw->color[3]);
+    s_static_gl.BindVertexArray(line->vao);
+    glLineWidth(draw->width);
+    glDrawArrays(GL_LINE_STRIP, 0, line->num_vertex);
+    glLineWidth(1.0f);
+}
+
+/**
+ * @brief Release line. Called by renderer on GUI thread.
+ */
+static void _static_destroy(const ImDrawList* parent_list, const ImDrawCmd* cmd)
+{
+    (void)parent_list;
+    imgui_static_line_t* line = (imgui_static_line_t*)cmd->UserCallbackData;
+
+    if (line->vao != 0)
+    {
+        s_static_gl.DeleteVertexArrays(1, &line->vao);
+        s_static_gl.DeleteBuffers(1, &line->vbo);
+    }
+    free(line->vertices);
+    free(line);
+}
+
+/**
+ * @brief Release lines that are not drawn for a while.
+ */
+static void _static_sweep(void)
+{
+    int frame = ImGui::GetFrameCount();
+    if (s_static_sweep_frame == frame)
+    {
+        return;
+    }
+    s_static_sweep_frame = frame;
+
+    auto_map_node_t* it = api->map->begin(&s_static_map);
+    while (it != NULL)
+    {
+        imgui_static_line_t* line = container_of(it, imgui_static_line_t, node);
+        it = api->map->next(it);
+
+        if (frame - line->frame > IMGUI_STATIC_EXPIRE_FRAMES)
+        {
+            api->map->erase(&s_static_map, &line->node);
+            ImGui::GetForegroundDrawList()->AddCallback(_static_destroy, line);
+        }
+    }
+}
+
+/**
+ * @brief Release all lines and shader program when the loop ends. They belong
+ *   to the OpenGL context of that loop.
+ */
+static void _static_exit(void)
+{
+    if (s_static_map_init)
+    {
+        auto_map_node_t* it = api->map->begin(&s_static_map);
+        while (it != NULL)
+        {
+            imgui_static_line_t* line = container_of(it, imgui_static_line_t, node);
+            it = api->map->next(it);
+
+            api->map->erase(&s_static_map, &line->node);
+            if (line->vao != 0)
+            {
+                s_static_gl.DeleteVertexArrays(1, &line->vao);
+                s_static_gl.DeleteBuffers(1, &line->vbo);
+            }
+            free(line->vertices);
+            free(line);
+        }
+    }
+    s_static_sweep_frame = -1;
+
+    if (s_static_program != 0)
+    {
+        s_static_gl.DeleteProgram(s_static_program);
+        s_static_program = 0;
+        s_static_loc_transform = -1;
+        s_static_loc_display = -1;
+        s_static_loc_color = -1;
+    }
+}
+
+static imgui_static_line_t* _static_find(ImGuiID id)
+{
+    if (!s_static_map_init)
+    {
+        api->map->init(&s_static_map, _static_cmp, NULL);
+        s_static_map_init = 1;
+        ImGuiAdapterAtExit(_static_exit);
+    }
+    _static_sweep();
+
+    imgui_static_line_t key;
+    key.id = id;
+
+    auto_map_node_t* it = api->map->find(&s_static_map, &key.node);
+    if (it != NULL)
+    {
+        return container_of(it, imgui_static_line_t, node);
+    }
+
+    imgui_static_line_t* line = (imgui_static_line_t*)calloc(1, sizeof(imgui_static_line_t));
+    line->id = id;
+    api->map->insert(&s_static_map, &line->node);
+    return line;
+}
+
+static void _static_build_task(void* arg, size_t idx)
+{
+    imgui_static_build_t* build = (imgui_static_build_t*)arg;
+    imgui_static_line_t* line = build->line;
+    const imgui_series_t* values = build->values;
+
+    size_t beg = idx * IMGUI_STATIC_CHUNK_SIZE;
+    size_t end = beg + IMGUI_STATIC_CHUNK_SIZE < line->count ? beg + IMGUI_STATIC_CHUNK_SIZE : line->count;
+
+    float* dst = line->vertices + beg * 2;
+    for (size_t i = beg; i < end; i++)
+    {
+        size_t j = (i + values->offset) % values->count;
+        *dst++ = (float)((double)i - line->origin_x);
+        *dst++ = (float)(imgui_series_get(values, j) - line->origin_y);
+    }
+}
+
+/**
+ * @brief Convert series into vertices relative to the center of data.
+ */
+static void _static_build(imgui_static_line_t* line, const imgui_series_t* values)
+{
+    imgui_stats_t stats;
+    imgui_stats_summary(values, &stats);
+
+    line->count = values->count;
+    line->origin_x = (double)(values->count / 2);
+    line->origin_y = (stats.min + stats.max) / 2;
+    line->y_min = stats.min;
+    line->y_max = stats.max;
+
+    free(line->vertices);
+    line->vertices = (float*)malloc(sizeof(float) * 2 * (line->count ? line->count : 1));
+
+    imgui_static_build_t build;
+    build.line = line;
+    build.values = values;
+    imgui_pool_parallel((line->count + IMGUI_STATIC_CHUNK_SIZE - 1) / IMGUI_STATIC_CHUNK_SIZE,
+        _static_build_task, &build);
+}
+
+/**
+ * @brief Plot by ImPlot, used when axis transform is not linear, or the line
+ *   is wider than the driver can draw.
+ */
+static void _static_fallback(const char* label_id, imgui_series_t* values)
+{
+    imgui_series_prepare(values, 0, values->count);
+    IMGUI_DTYPE_DISPATCH(values->type, T,
+        ImPlot::PlotLine(label_id, (const T*)values->data, (int)values->count,
+            1.0, 0.0, 0, (int)values->offset, (int)values->stride));
+}
+
+void imgui_implot_static_init(void* (*getproc)(const char* name))
+{
+    s_static_gl_ok = true;
+#define IMGUI_STATIC_GL_LOAD(type, name)\
+    *(void**)&s_static_gl.name = getproc("gl" #name);\
+    s_static_gl_ok = s_static_gl_ok && s_static_gl.name != NULL;
+    IMGUI_STATIC_GL_FUNCS(IMGUI_STATIC_GL_LOAD)
+#undef IMGUI_STATIC_GL_LOAD
+
+    /* Core profile may only support width 1 */
+    GLfloat range[2] = { 1.0f, 1.0f };
+    glGetFloatv(GL_ALIASED_LINE_WIDTH_RANGE, range);
+    s_static_width_max = range[1] >= 1.0f ? range[1] : 1.0f;
+}
+
+int imgui_implot_plot_line_static(lua_State* L)
+{
+    const char* label_id = api->lua->L_checklstring(L, 1, NULL);
+
+    imgui_series_t values;
+    imgui_series_check(L, 2, &values);
+
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    const ImPlotAxis& x_axis = plot->Axes[plot->CurrentX];
+    const ImPlotAxis& y_axis = plot->Axes[plot->CurrentY];
+    const ImVec2& fb_scale = ImGui::GetIO().DisplayFramebufferScale;
+    const float weight = ImPlot::GetCurrentContext()->NextItemData.LineWeight >= 0
+        ? ImPlot::GetCurrentContext()->NextItemData.LineWeight : ImPlot::GetStyle().LineWeight;
+    const float width = weight * (fb_scale.x > fb_scale.y ? fb_scale.x : fb_scale.y);
+    /* Lua table and bare string have no version to decide when to upload */
+    if (!s_static_gl_ok || width > s_static_width_max || values.vtbl == NULL
+        || x_axis.Scale != ImPlotScale_Linear || y_axis.Scale != ImPlotScale_Linear)
+    {
+        _static_fallback(label_id, &values);
+        imgui_series_release(&values);
+        return 0;
+    }
+
+    imgui_static_line_t* line = _static_find(ImHashStr(label_id, 0, plot->ID));
+    line->frame = ImGui::GetFrameCount();
+
+    const void* source = values.self;
+    uint64_t version = values.version;
+    if (line->sig.data != source || line->sig.version != version || line->sig.version == 0
+        || line->sig.count != values.count)
+    {
+        line->sig.data = source;
+        line->sig.version = version;
+        line->sig.count = values.count;
+
+        imgui_series_prepare(&values, 0, values.count);
+        _static_build(line, &values);
+    }
+    imgui_series_release(&values);
+
+    if (!ImPlot::BeginItem(label_id, 0, ImPlotCol_Line))
+    {
+        return 0;
+    }
+    if (ImPlot::FitThisFrame() && line->sig.count > 0)
+    {
+        ImPlot::FitPoint(ImPlotPoint(0, line->y_min));
+        ImPlot::FitPoint(ImPlotPoint((double)(line->sig.count - 1), line->y_max));
+    }
+
+    /* pixel = PixelMin + ScaleToPixel * (origin + v - Range.Min) */
+    imgui_static_draw_t* draw = &line->draw;
+    draw->line = line;
+    draw->transform[0] = (float)x_axis.ScaleToPixel;
+    draw->transform[1] = (float)y_axis.ScaleToPixel;
+    draw->transform[2] = (float)(x_axis.PixelMin + x_axis.ScaleToPixel * (line->origin_x - x_axis.Range.Min));
+    draw->transform[3] = (float)(y_axis.PixelMin + y_axis.ScaleToPixel * (line->origin_y - y_axis.Range.Min));
+
+    const ImPlotNextItemData& s = ImPlot::GetItemData();
+    draw->color[0] = s.Colors[ImPlotCol_Line].x;
+    draw->color[1] = s.Colors[ImPlotCol_Line].y;
+    draw->color[2] = s.Colors[ImPlotCol_Line].z;
+    draw->color[3] = s.Colors[ImPlotCol_Line].w;
+
+    const ImGuiViewport* viewport = ImGui::GetMainViewport();
+    draw->display[0] = viewport->Pos.x;
+    draw->display[1] = viewport->Pos.y;
+    draw->display[2] = viewport->Size.x;
+    draw->display[3] = viewport->Size.y;
+    draw->fb_scale[0] = fb_scale.x;
+    draw->fb_scale[1] = fb_scale.y;
+    draw->width = width;
+
+    ImDrawList* draw_list = ImPlot::GetPlotDrawList();
+    if (line->vertices != NULL)
+    {
+        draw_list->AddCallback(_static_upload, line);
+    }
+    draw_list->AddCallback(_static_draw, draw);
+    draw_list->AddCallback(ImDrawCallback_ResetRenderState, NULL);
+
+    ImPlot::EndItem();
+    return 0;
+}
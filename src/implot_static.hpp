@@ -0,0 +1,24 @@
+#ifndef __IMPLOT_STATIC_HPP__
+#define __IMPLOT_STATIC_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Load OpenGL functions and query line width range.
+ * @note Called on GUI thread with OpenGL context current.
+ * @param[in] getproc   OpenGL function loader.
+ */
+AUTO_LOCAL void imgui_implot_static_init(void* (*getproc)(const char* name));
+
+/**
+ * @brief Plot line from a GPU vertex buffer.
+ *
+ * [1]: string label_id
+ * [2]: series values
+ *
+ * @param[in] L     Lua VM.
+ * @return          Always 0.
+ */
+AUTO_LOCAL int imgui_implot_plot_line_static(lua_State* L);
+
+#endif
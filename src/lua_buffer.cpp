@@ -0,0 +1,373 @@
+#include <errno.h>
+#include <string.h>
+#include "lua_buffer.h"
+#include "lua_imgui.h"
+#include "buffer.hpp"
+#include "buffer_spill.hpp"
+
+#define IMGUI_BUFFER_MIN_CAPACITY   64
+
+static void _buffer_store(imgui_buffer_t* buf, size_t idx, double v)
+{
+    char* addr = buf->data + idx * buf->elem_size;
+    IMGUI_DTYPE_DISPATCH(buf->type, T, *(T*)addr = imgui_dtype_cast<T>(v));
+}
+
+/**
+ * @brief Convert logical index (0 is oldest) to storage index.
+ */
+static size_t _buffer_index(const imgui_buffer_t* buf, size_t idx)
+{
+    idx += buf->head;
+    return idx < buf->capacity ? idx : idx - buf->capacity;
+}
+
+static void _buffer_view(void* self, imgui_series_t* series)
+{
+    imgui_buffer_t* buf = (imgui_buffer_t*)self;
+    series->data = buf->data;
+    series->count = buf->size;
+    series->offset = buf->head;
+    series->stride = buf->elem_size;
+    series->type = buf->type;
+    series->version = buf->version;
+}
+
+static const imgui_series_vtbl_t s_buffer_vtbl = {
+    "buffer",
+    _buffer_view,
+    NULL,
+};
+
+imgui_buffer_t* imgui_buffer_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_buffer");
+    return (imgui_buffer_t*)api->lua->touserdata(L, arg);
+}
+
+imgui_buffer_t* imgui_buffer_test_spill(lua_State* L, int arg)
+{
+    if (imgui_series_test(L, arg) != &s_buffer_vtbl)
+    {
+        return NULL;
+    }
+    imgui_buffer_t* buf = (imgui_buffer_t*)api->lua->touserdata(L, arg);
+    return buf->spill != NULL ? buf : NULL;
+}
+
+void imgui_buffer_window(imgui_buffer_t* buf, size_t beg, size_t end, imgui_series_t* series)
+{
+    memset(series, 0, sizeof(*series));
+    series->data = imgui_buffer_spill_read(buf, beg, end);
+    series->count = end - beg;
+    series->stride = buf->elem_size;
+    series->type = buf->type;
+    series->version = buf->version;
+    series->vtbl = &s_buffer_vtbl;
+    series->self = buf;
+}
+
+int imgui_buffer_push(imgui_buffer_t* buf, double v)
+{
+    if (buf->ring)
+    {
+        buf->total++;
+        if (buf->size < buf->capacity)
+        {
+            _buffer_store(buf, buf->size++, v);
+        }
+        else
+        {
+            _buffer_store(buf, buf->head, v);
+            buf->head = buf->head + 1 < buf->capacity ? buf->head + 1 : 0;
+        }
+        if (buf->spill != NULL)
+        {
+            imgui_buffer_spill_push(buf, v);
+        }
+        return 0;
+    }
+
+    if (buf->size == buf->capacity)
+    {
+        size_t capacity = buf->capacity * 2;
+        capacity = capacity > IMGUI_BUFFER_MIN_CAPACITY ? capacity : IMGUI_BUFFER_MIN_CAPACITY;
+        char* data = (char*)realloc(buf->data, capacity * buf->elem_size);
+        if (data == NULL)
+        {
+            return ENOMEM;
+        }
+        buf->data = data;
+        buf->capacity = capacity;
+    }
+    buf->total++;
+    _buffer_store(buf, buf->size++, v);
+    return 0;
+}
+
+void* imgui_buffer_at(imgui_buffer_t* buf, size_t idx)
+{
+    return buf->data + _buffer_index(buf, idx) * buf->elem_size;
+}
+
+void imgui_buffer_clear(imgui_buffer_t* buf)
+{
+    if (buf->spill != NULL)
+    {
+        /* Elements that are not spilled yet would be lost otherwise */
+        imgui_buffer_spill_flush(buf);
+    }
+    buf->size = 0;
+    buf->head = 0;
+    buf->epoch++;
+}
+
+void imgui_buffer_touch(imgui_buffer_t* buf)
+{
+    buf->version = imgui_series_next_version();
+}
+
+static int _buffer_gc(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    imgui_buffer_spill_close(buf);
+    if (buf->data != NULL)
+    {
+        free(buf->data);
+        buf->data = NULL;
+    }
+    return 0;
+}
+
+static void _buffer_append_value(lua_State* L, imgui_buffer_t* buf, double v)
+{
+    if (imgui_buffer_push(buf, v) != 0)
+    {
+        /* Values appended so far are kept and must be visible */
+        imgui_buffer_touch(buf);
+        api->lua->L_error(L, "append failed: %s", strerror(ENOMEM));
+    }
+}
+
+/**
+ * @brief Append values.
+ *
+ * [1]: buffer
+ * [2+]: number or table of numbers
+ */
+static int _buffer_append(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    int sp = api->lua->gettop(L);
+
+    for (int i = 2; i <= sp; i++)
+    {
+        if (api->lua->type(L, i) != AUTO_LUA_TTABLE)
+        {
+            _buffer_append_value(L, buf, api->lua->L_checknumber(L, i));
+            continue;
+        }
+
+        int64_t len = api->lua->L_len(L, i);
+        for (int64_t j = 1; j <= len; j++)
+        {
+            api->lua->geti(L, i, j);
+            _buffer_append_value(L, buf, api->lua->tonumber(L, -1));
+            api->lua->pop(L, 1);
+        }
+    }
+
+    imgui_buffer_touch(buf);
+    return 0;
+}
+
+static int _buffer_set(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    int64_t idx = api->lua->L_checkinteger(L, 2);
+    double v = api->lua->L_checknumber(L, 3);
+
+    if (idx < 1 || (size_t)idx > buf->size)
+    {
+        return api->lua->L_error(L, "index %d out of range [1, %d]", (int)idx, (int)buf->size);
+    }
+
+    _buffer_store(buf, _buffer_index(buf, idx - 1), v);
+    buf->epoch++;
+    imgui_buffer_touch(buf);
+    return 0;
+}
+
+static int _buffer_get(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    int64_t idx = api->lua->L_checkinteger(L, 2);
+
+    if (idx < 1 || (size_t)idx > buf->size)
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    imgui_series_t series;
+    memset(&series, 0, sizeof(series));
+    _buffer_view(buf, &series);
+
+    api->lua->pushnumber(L, imgui_series_get(&series, _buffer_index(buf, idx - 1)));
+    return 1;
+}
+
+static int _buffer_size(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    api->lua->pushinteger(L, buf->size);
+    return 1;
+}
+
+static int _buffer_capacity(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    api->lua->pushinteger(L, buf->capacity);
+    return 1;
+}
+
+static int _buffer_clear(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    imgui_buffer_clear(buf);
+    imgui_buffer_touch(buf);
+    return 0;
+}
+
+/**
+ * @brief Spill ring buffer to file.
+ *
+ * [1]: buffer
+ * [2]: string path
+ * [3]: integer elements per segment, default a quarter of capacity
+ */
+static int _buffer_spill(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    const char* path = api->lua->L_checklstring(L, 2, NULL);
+    int64_t segment = api->lua->type(L, 3) == AUTO_LUA_TNUMBER
+        ? api->lua->tointeger(L, 3) : (int64_t)(buf->capacity / 4);
+    segment = segment > 0 ? segment : 1;
+
+    if (!buf->ring)
+    {
+        return api->lua->L_error(L, "only ring buffer can spill");
+    }
+    if (buf->spill != NULL)
+    {
+        return api->lua->L_error(L, "buffer is already spilling");
+    }
+    if ((size_t)segment > buf->capacity)
+    {
+        return api->lua->L_error(L, "segment %d larger than capacity %d", (int)segment, (int)buf->capacity);
+    }
+
+    int ret = imgui_buffer_spill_open(buf, path, (size_t)segment);
+    if (ret != 0)
+    {
+        return api->lua->L_error(L, "open `%s` failed: %s", path, strerror(ret));
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the number of elements since spilling started, and how many of
+ *   them are written to file.
+ */
+static int _buffer_spilled(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    if (buf->spill == NULL)
+    {
+        return 0;
+    }
+
+    size_t total, spilled;
+    double v_min, v_max;
+    imgui_buffer_spill_bounds(buf, &total, &spilled, &v_min, &v_max);
+    api->lua->pushinteger(L, (int64_t)total);
+    api->lua->pushinteger(L, (int64_t)spilled);
+    return 2;
+}
+
+static int _buffer_version(lua_State* L)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)buf->version);
+    return 1;
+}
+
+imgui_buffer_t* imgui_buffer_new(lua_State* L, imgui_dtype_t type, size_t capacity)
+{
+    imgui_buffer_t* buf = (imgui_buffer_t*)api->lua->newuserdatauv(L, sizeof(imgui_buffer_t), 0);
+    memset(buf, 0, sizeof(*buf));
+    buf->type = type;
+    buf->elem_size = imgui_dtype_size(type);
+    buf->ring = capacity > 0;
+    buf->capacity = capacity;
+    buf->data = capacity > 0 ? (char*)malloc(capacity * buf->elem_size) : NULL;
+    imgui_buffer_touch(buf);
+
+    imgui_series_bind(L, &s_buffer_vtbl);
+
+    static const auto_luaL_Reg s_buffer_meta[] = {
+        { "__gc",       _buffer_gc },
+        { "__len",      _buffer_size },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_buffer_method[] = {
+        { "append",     _buffer_append },
+        { "capacity",   _buffer_capacity },
+        { "clear",      _buffer_clear },
+        { "get",        _buffer_get },
+        { "set",        _buffer_set },
+        { "size",       _buffer_size },
+        { "spill",      _buffer_spill },
+        { "spilled",    _buffer_spilled },
+        { "version",    _buffer_version },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_buffer") != 0)
+    {
+        api->lua->L_setfuncs(L, s_buffer_meta, 0);
+        api->lua->L_newlib(L, s_buffer_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return buf;
+}
+
+/**
+ * @brief Create buffer.
+ *
+ * [1]: string type, default "f64"
+ * [2]: integer capacity, optional. If set, create a ring buffer.
+ */
+static int _buffer_new(lua_State* L)
+{
+    imgui_dtype_t type = imgui_dtype_check(L, 1, IMGUI_DTYPE_F64);
+    int64_t capacity = api->lua->type(L, 2) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 2) : 0;
+    if (capacity < 0)
+    {
+        return api->lua->L_error(L, "invalid capacity %d", (int)capacity);
+    }
+
+    imgui_buffer_new(L, type, (size_t)capacity);
+    return 1;
+}
+
+int imgui_luaopen_buffer(lua_State *L)
+{
+    static const auto_luaL_Reg s_buffer_method[] = {
+        { "new",        _buffer_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_buffer_method);
+    return 1;
+}
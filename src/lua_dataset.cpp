@@ -0,0 +1,792 @@
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <imgui.h>
+#include "lua_dataset.h"
+#include "lua_imgui.h"
+#include "file_map.hpp"
+#include "series.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Number of rows converted at once for CSV column.
+ */
+#define IMGUI_DATASET_BLOCK_ROWS    4096
+
+/**
+ * @brief Converted CSV blocks kept per dataset, 32 MiB of values. Blocks used
+ *   in current frame are never evicted, so this can be exceeded while a large
+ *   range is on screen.
+ */
+#define IMGUI_DATASET_CACHE_BLOCKS  1024
+
+/**
+ * @brief Maximum length of a numeric CSV field.
+ */
+#define IMGUI_DATASET_FIELD_MAX     64
+
+typedef enum imgui_dataset_kind
+{
+    IMGUI_DATASET_BINARY,
+    IMGUI_DATASET_CSV,
+} imgui_dataset_kind_t;
+
+typedef struct imgui_dataset_cache
+{
+    double*             values;     /**< Converted values, one per row, by #imgui_page_alloc(). */
+    uint8_t*            ready;      /**< Whether a block is converted. */
+    uint64_t*           used;       /**< Tick a block is last prepared. */
+} imgui_dataset_cache_t;
+
+typedef struct imgui_dataset
+{
+    imgui_file_map_t        map;
+    imgui_dataset_kind_t    kind;
+    size_t                  num_rows;
+    size_t                  num_cols;
+    uint64_t*               versions;   /**< Version of each column, content never change. */
+
+    struct
+    {
+        imgui_dtype_t       type;       /**< Element type. */
+        size_t              header;     /**< Bytes to skip. */
+        int                 epoch;      /**< Epoch of #cur. */
+        size_t              cur[2];     /**< Byte range prepared in this epoch, empty if beg >= end. */
+        size_t              prev[2];    /**< Byte range prepared in previous epoch. */
+    } binary;
+
+    struct
+    {
+        char                delimiter;  /**< Field delimiter. */
+        uint64_t*           rows;       /**< Row offsets, num_rows + 1 entries. */
+        char**              names;      /**< Column names, NULL if no header. */
+        imgui_dataset_cache_t* caches;  /**< Column caches, num_cols entries. */
+        size_t              resident;   /**< Converted blocks of all columns. */
+        uint64_t            tick;       /**< Incremented by every prepare. */
+        int                 epoch;      /**< Epoch of last prepare. */
+        uint64_t            epoch_tick; /**< Blocks used after this tick are in current epoch. */
+    } csv;
+} imgui_dataset_t;
+
+typedef struct imgui_dataset_column
+{
+    imgui_dataset_t*        dataset;
+    size_t                  col;
+} imgui_dataset_column_t;
+
+/**
+ * @brief Line breaks of a chunk.
+ *
+ * Whether a line break is inside a quoted field depends on quotes before the
+ * chunk, so breaks are split by parity of quotes before them in the chunk.
+ * If the chunk starts outside quotes, rows begin after breaks of even parity,
+ * otherwise after breaks of odd parity.
+ */
+typedef struct imgui_dataset_index_chunk
+{
+    size_t                  beg;
+    size_t                  end;
+    size_t                  quotes;     /**< The number of quotes in chunk. */
+    std::vector<uint64_t>   rows[2];    /**< Offset after line breaks, by quote parity. */
+} imgui_dataset_index_chunk_t;
+
+typedef struct imgui_dataset_index_job
+{
+    const char*                     data;
+    std::vector<imgui_dataset_index_chunk_t> chunks;
+} imgui_dataset_index_job_t;
+
+typedef struct imgui_dataset_convert_job
+{
+    imgui_dataset_t*        dataset;
+    size_t                  col;
+    std::vector<size_t>     blocks;
+} imgui_dataset_convert_job_t;
+
+/**
+ * @brief Find field \p col in row [p, e).
+ * @return  Boolean.
+ */
+static int _dataset_csv_field(const char* p, const char* e, char delimiter,
+    size_t col, const char** field_beg, const char** field_end)
+{
+    size_t idx = 0;
+    while (p <= e)
+    {
+        const char* fb = p;
+        int quoted = 0;
+        while (p < e && (quoted || (*p != '\n' && *p != '\r' && *p != delimiter)))
+        {
+            if (*p == '"')
+            {
+                quoted = !quoted;
+            }
+            p++;
+        }
+
+        if (idx == col)
+        {
+            if (p - fb >= 2 && *fb == '"' && p[-1] == '"')
+            {
+                fb++;
+                *field_end = p - 1;
+            }
+            else
+            {
+                *field_end = p;
+            }
+            *field_beg = fb;
+            return 1;
+        }
+
+        if (p >= e || *p != delimiter)
+        {
+            break;
+        }
+        p++;
+        idx++;
+    }
+    return 0;
+}
+
+static double _dataset_csv_number(const char* fb, const char* fe)
+{
+    /* Mapped file is not NUL-terminated, so strtod() cannot be used in place */
+    char buf[IMGUI_DATASET_FIELD_MAX];
+    size_t len = fe - fb;
+    if (len == 0 || len >= sizeof(buf))
+    {
+        return 0.0;
+    }
+    memcpy(buf, fb, len);
+    buf[len] = '\0';
+    return strtod(buf, NULL);
+}
+
+static void _dataset_csv_convert_block(imgui_dataset_t* ds, size_t col, size_t block)
+{
+    imgui_dataset_cache_t* cache = &ds->csv.caches[col];
+    size_t beg = block * IMGUI_DATASET_BLOCK_ROWS;
+    size_t end = beg + IMGUI_DATASET_BLOCK_ROWS;
+    end = end < ds->num_rows ? end : ds->num_rows;
+
+    for (size_t row = beg; row < end; row++)
+    {
+        const char* p = ds->map.data + ds->csv.rows[row];
+        const char* e = ds->map.data + ds->csv.rows[row + 1];
+        const char* fb; const char* fe;
+
+        cache->values[row] = _dataset_csv_field(p, e, ds->csv.delimiter, col, &fb, &fe) ?
+            _dataset_csv_number(fb, fe) : 0.0;
+    }
+
+    cache->ready[block] = 1;
+}
+
+static void _dataset_csv_convert_task(void* arg, size_t idx)
+{
+    imgui_dataset_convert_job_t* job = (imgui_dataset_convert_job_t*)arg;
+    _dataset_csv_convert_block(job->dataset, job->col, job->blocks[idx]);
+}
+
+static void _dataset_column_view(void* self, imgui_series_t* series)
+{
+    imgui_dataset_column_t* column = (imgui_dataset_column_t*)self;
+    imgui_dataset_t* ds = column->dataset;
+
+    series->count = ds->num_rows;
+    series->offset = 0;
+    series->version = ds->versions[column->col];
+
+    if (ds->kind == IMGUI_DATASET_BINARY)
+    {
+        size_t size = imgui_dtype_size(ds->binary.type);
+        series->data = ds->map.data + ds->binary.header + column->col * size;
+        series->stride = size * ds->num_cols;
+        series->type = ds->binary.type;
+        return;
+    }
+
+    series->data = ds->csv.caches[column->col].values;
+    series->stride = sizeof(double);
+    series->type = IMGUI_DTYPE_F64;
+}
+
+/**
+ * @brief Current epoch, which is the ImGui frame, or a new value for every
+ *   call outside of frame. Data prepared in current epoch is kept.
+ */
+static int _dataset_epoch(void)
+{
+    static int s_epoch = 0;
+    if (ImGui::GetCurrentContext() != NULL)
+    {
+        return ImGui::GetFrameCount();
+    }
+    return --s_epoch;
+}
+
+/**
+ * @brief Tell the system byte ranges not prepared for a whole epoch are not
+ *   needed, then prefetch [beg, end).
+ */
+static void _dataset_binary_advise(imgui_dataset_t* ds, size_t beg, size_t end, int epoch)
+{
+    size_t* cur = ds->binary.cur;
+    size_t* prev = ds->binary.prev;
+
+    if (ds->binary.epoch != epoch)
+    {
+        if (cur[0] >= cur[1])
+        {
+            imgui_file_advise(&ds->map, prev[0], prev[1] - prev[0], 0);
+        }
+        else
+        {
+            if (prev[0] < cur[0])
+            {
+                size_t e = prev[1] < cur[0] ? prev[1] : cur[0];
+                imgui_file_advise(&ds->map, prev[0], e - prev[0], 0);
+            }
+            if (prev[1] > cur[1])
+            {
+                size_t b = prev[0] > cur[1] ? prev[0] : cur[1];
+                imgui_file_advise(&ds->map, b, prev[1] - b, 0);
+            }
+        }
+        prev[0] = cur[0];
+        prev[1] = cur[1];
+        cur[0] = cur[1] = 0;
+        ds->binary.epoch = epoch;
+    }
+
+    /* Ranges of one epoch are merged into their hull */
+    if (cur[0] >= cur[1])
+    {
+        cur[0] = beg;
+        cur[1] = end;
+    }
+    else
+    {
+        cur[0] = beg < cur[0] ? beg : cur[0];
+        cur[1] = end > cur[1] ? end : cur[1];
+    }
+    imgui_file_advise(&ds->map, beg, end - beg, 1);
+}
+
+typedef struct imgui_dataset_block_ref
+{
+    uint64_t            used;
+    size_t              col;
+    size_t              block;
+} imgui_dataset_block_ref_t;
+
+/**
+ * @brief Release least recently used blocks not used in current epoch, until
+ *   \p incoming more blocks fit in #IMGUI_DATASET_CACHE_BLOCKS.
+ */
+static void _dataset_csv_evict(imgui_dataset_t* ds, size_t incoming)
+{
+    if (ds->csv.resident + incoming <= IMGUI_DATASET_CACHE_BLOCKS)
+    {
+        return;
+    }
+
+    size_t num_block = (ds->num_rows + IMGUI_DATASET_BLOCK_ROWS - 1) / IMGUI_DATASET_BLOCK_ROWS;
+    std::vector<imgui_dataset_block_ref_t> refs;
+    for (size_t col = 0; col < ds->num_cols; col++)
+    {
+        imgui_dataset_cache_t* cache = &ds->csv.caches[col];
+        for (size_t block = 0; cache->values != NULL && block < num_block; block++)
+        {
+            if (cache->ready[block] && cache->used[block] <= ds->csv.epoch_tick)
+            {
+                imgui_dataset_block_ref_t ref = { cache->used[block], col, block };
+                refs.push_back(ref);
+            }
+        }
+    }
+
+    std::sort(refs.begin(), refs.end(),
+        [](const imgui_dataset_block_ref_t& a, const imgui_dataset_block_ref_t& b) {
+            return a.used < b.used;
+        });
+
+    for (size_t i = 0; i < refs.size() && ds->csv.resident + incoming > IMGUI_DATASET_CACHE_BLOCKS; i++)
+    {
+        imgui_dataset_cache_t* cache = &ds->csv.caches[refs[i].col];
+        size_t beg = refs[i].block * IMGUI_DATASET_BLOCK_ROWS;
+        size_t end = beg + IMGUI_DATASET_BLOCK_ROWS < ds->num_rows ? beg + IMGUI_DATASET_BLOCK_ROWS : ds->num_rows;
+        imgui_page_discard(cache->values + beg, (end - beg) * sizeof(double));
+        cache->ready[refs[i].block] = 0;
+        ds->csv.resident--;
+    }
+}
+
+static void _dataset_column_prepare(void* self, size_t beg, size_t end)
+{
+    imgui_dataset_column_t* column = (imgui_dataset_column_t*)self;
+    imgui_dataset_t* ds = column->dataset;
+    int epoch = _dataset_epoch();
+
+    if (ds->kind == IMGUI_DATASET_BINARY)
+    {
+        size_t row_size = imgui_dtype_size(ds->binary.type) * ds->num_cols;
+        _dataset_binary_advise(ds, ds->binary.header + beg * row_size,
+            ds->binary.header + end * row_size, epoch);
+        return;
+    }
+
+    imgui_dataset_convert_job_t job;
+    job.dataset = ds;
+    job.col = column->col;
+
+    if (ds->csv.epoch != epoch)
+    {
+        ds->csv.epoch = epoch;
+        ds->csv.epoch_tick = ds->csv.tick;
+    }
+    ds->csv.tick++;
+
+    imgui_dataset_cache_t* cache = &ds->csv.caches[column->col];
+    size_t block_end = (end + IMGUI_DATASET_BLOCK_ROWS - 1) / IMGUI_DATASET_BLOCK_ROWS;
+    for (size_t block = beg / IMGUI_DATASET_BLOCK_ROWS; block < block_end; block++)
+    {
+        cache->used[block] = ds->csv.tick;
+        if (!cache->ready[block])
+        {
+            job.blocks.push_back(block);
+        }
+    }
+
+    _dataset_csv_evict(ds, job.blocks.size());
+    imgui_pool_parallel(job.blocks.size(), _dataset_csv_convert_task, &job);
+    ds->csv.resident += job.blocks.size();
+}
+
+static const imgui_series_vtbl_t s_dataset_column_vtbl = {
+    "dataset column",
+    _dataset_column_view,
+    _dataset_column_prepare,
+};
+
+static void _dataset_csv_index_task(void* arg, size_t idx)
+{
+    imgui_dataset_index_job_t* job = (imgui_dataset_index_job_t*)arg;
+    imgui_dataset_index_chunk_t* chunk = &job->chunks[idx];
+
+    const char* p = job->data + chunk->beg;
+    const char* e = job->data + chunk->end;
+    while (p < e)
+    {
+        const char* eol = (const char*)memchr(p, '\n', e - p);
+        const char* seg_end = eol != NULL ? eol : e;
+
+        /* Quotes are rare in numeric files, so count them by memchr() too */
+        while ((p = (const char*)memchr(p, '"', seg_end - p)) != NULL)
+        {
+            chunk->quotes++;
+            p++;
+        }
+
+        if (eol == NULL)
+        {
+            break;
+        }
+        p = eol + 1;
+        chunk->rows[chunk->quotes & 1].push_back(p - job->data);
+    }
+}
+
+/**
+ * @brief Build row offsets of CSV file.
+ *
+ * The file is split into chunks, and every chunk is scanned for line breaks
+ * by worker threads. Line breaks inside quoted fields do not start a row.
+ */
+static void _dataset_csv_index(imgui_dataset_t* ds, int header)
+{
+    size_t size = ds->map.size;
+    size_t num_chunk = (imgui_pool_concurrency() + 1) * 4;
+    size_t chunk_size = size / num_chunk + 1;
+
+    imgui_dataset_index_job_t job;
+    job.data = ds->map.data;
+    job.chunks.resize(num_chunk);
+    for (size_t i = 0; i < num_chunk; i++)
+    {
+        job.chunks[i].beg = i * chunk_size < size ? i * chunk_size : size;
+        job.chunks[i].end = (i + 1) * chunk_size < size ? (i + 1) * chunk_size : size;
+        job.chunks[i].quotes = 0;
+    }
+    imgui_pool_parallel(num_chunk, _dataset_csv_index_task, &job);
+
+    std::vector<uint64_t> rows;
+    rows.push_back(0);
+    size_t quoted = 0;
+    for (size_t i = 0; i < num_chunk; i++)
+    {
+        const std::vector<uint64_t>& breaks = job.chunks[i].rows[quoted];
+        rows.insert(rows.end(), breaks.begin(), breaks.end());
+        quoted ^= job.chunks[i].quotes & 1;
+    }
+
+    /* Last line has line break, or file is empty */
+    if (rows.back() == size)
+    {
+        rows.pop_back();
+    }
+
+    size_t skip = (header && rows.size() > 0) ? 1 : 0;
+    ds->num_rows = rows.size() - skip;
+    ds->csv.rows = (uint64_t*)malloc(sizeof(uint64_t) * (ds->num_rows + 1));
+    memcpy(ds->csv.rows, rows.data() + skip, sizeof(uint64_t) * ds->num_rows);
+    ds->csv.rows[ds->num_rows] = size;
+}
+
+/**
+ * @brief Count columns and parse names from first line.
+ */
+static void _dataset_csv_header(imgui_dataset_t* ds, int header)
+{
+    const char* p = ds->map.data;
+    const char* e = p + ds->map.size;
+
+    /* First line ends at the first line break outside quotes */
+    int quoted = 0;
+    for (const char* c = p; c < e; c++)
+    {
+        if (*c == '"')
+        {
+            quoted = !quoted;
+        }
+        else if (*c == '\n' && !quoted)
+        {
+            e = c;
+            break;
+        }
+    }
+
+    const char* fb; const char* fe;
+    while (_dataset_csv_field(p, e, ds->csv.delimiter, ds->num_cols, &fb, &fe))
+    {
+        ds->num_cols++;
+    }
+
+    if (!header)
+    {
+        return;
+    }
+
+    ds->csv.names = (char**)calloc(ds->num_cols, sizeof(char*));
+    for (size_t i = 0; i < ds->num_cols; i++)
+    {
+        _dataset_csv_field(p, e, ds->csv.delimiter, i, &fb, &fe);
+        ds->csv.names[i] = (char*)malloc(fe - fb + 1);
+        memcpy(ds->csv.names[i], fb, fe - fb);
+        ds->csv.names[i][fe - fb] = '\0';
+    }
+}
+
+static imgui_dataset_t* _dataset_check(lua_State* L, int idx)
+{
+    api->lua->L_checkudata(L, idx, "__atd_imgui_dataset");
+    return (imgui_dataset_t*)api->lua->touserdata(L, idx);
+}
+
+static int _dataset_gc(lua_State* L)
+{
+    imgui_dataset_t* ds = _dataset_check(L, 1);
+
+    if (ds->csv.caches != NULL)
+    {
+        for (size_t i = 0; i < ds->num_cols; i++)
+        {
+            if (ds->csv.caches[i].values != NULL)
+            {
+                imgui_page_free(ds->csv.caches[i].values, sizeof(double) * (ds->num_rows ? ds->num_rows : 1));
+            }
+            free(ds->csv.caches[i].ready);
+            free(ds->csv.caches[i].used);
+        }
+        free(ds->csv.caches);
+        ds->csv.caches = NULL;
+    }
+    if (ds->csv.names != NULL)
+    {
+        for (size_t i = 0; i < ds->num_cols; i++)
+        {
+            free(ds->csv.names[i]);
+        }
+        free(ds->csv.names);
+        ds->csv.names = NULL;
+    }
+    if (ds->csv.rows != NULL)
+    {
+        free(ds->csv.rows);
+        ds->csv.rows = NULL;
+    }
+    free(ds->versions);
+    ds->versions = NULL;
+    imgui_file_unmap(&ds->map);
+
+    return 0;
+}
+
+static int _dataset_rows(lua_State* L)
+{
+    imgui_dataset_t* ds = _dataset_check(L, 1);
+    api->lua->pushinteger(L, ds->num_rows);
+    return 1;
+}
+
+static int _dataset_columns(lua_State* L)
+{
+    imgui_dataset_t* ds = _dataset_check(L, 1);
+    api->lua->pushinteger(L, ds->num_cols);
+    return 1;
+}
+
+static size_t _dataset_check_column(lua_State* L, imgui_dataset_t* ds, int arg)
+{
+    if (api->lua->type(L, arg) == AUTO_LUA_TSTRING && ds->csv.names != NULL)
+    {
+        const char* name = api->lua->tostring(L, arg);
+        for (size_t i = 0; i < ds->num_cols; i++)
+        {
+            if (strcmp(ds->csv.names[i], name) == 0)
+            {
+                return i;
+            }
+        }
+        return api->lua->L_error(L, "column '%s' not found", name);
+    }
+
+    int64_t col = api->lua->L_checkinteger(L, arg);
+    if (col < 1 || (size_t)col > ds->num_cols)
+    {
+        return api->lua->L_error(L, "column %d out of range [1, %d]",
+            (int)col, (int)ds->num_cols);
+    }
+    return (size_t)col - 1;
+}
+
+static imgui_dataset_column_t* _dataset_column_check(lua_State* L, int idx)
+{
+    api->lua->L_checkudata(L, idx, "__atd_imgui_dataset_column");
+    return (imgui_dataset_column_t*)api->lua->touserdata(L, idx);
+}
+
+static int _dataset_column_size(lua_State* L)
+{
+    imgui_dataset_column_t* column = _dataset_column_check(L, 1);
+    api->lua->pushinteger(L, column->dataset->num_rows);
+    return 1;
+}
+
+static int _dataset_column_get(lua_State* L)
+{
+    imgui_dataset_column_t* column = _dataset_column_check(L, 1);
+    int64_t idx = api->lua->L_checkinteger(L, 2);
+    if (idx < 1 || (size_t)idx > column->dataset->num_rows)
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    imgui_series_t series;
+    memset(&series, 0, sizeof(series));
+    _dataset_column_view(column, &series);
+    _dataset_column_prepare(column, idx - 1, idx);
+
+    api->lua->pushnumber(L, imgui_series_get(&series, idx - 1));
+    return 1;
+}
+
+static int _dataset_column(lua_State* L)
+{
+    imgui_dataset_t* ds = _dataset_check(L, 1);
+    size_t col = _dataset_check_column(L, ds, 2);
+
+    if (ds->kind == IMGUI_DATASET_CSV && ds->csv.caches[col].values == NULL)
+    {
+        /*
+         * Values are reserved for every row, but only converted blocks take
+         * physical memory, and evicted blocks give it back.
+         */
+        size_t num_block = (ds->num_rows + IMGUI_DATASET_BLOCK_ROWS - 1) / IMGUI_DATASET_BLOCK_ROWS;
+        double* values = (double*)imgui_page_alloc(sizeof(double) * (ds->num_rows ? ds->num_rows : 1));
+        if (values == NULL)
+        {
+            return api->lua->L_error(L, "out of memory");
+        }
+        ds->csv.caches[col].values = values;
+        ds->csv.caches[col].ready = (uint8_t*)calloc(num_block ? num_block : 1, sizeof(uint8_t));
+        ds->csv.caches[col].used = (uint64_t*)calloc(num_block ? num_block : 1, sizeof(uint64_t));
+    }
+
+    imgui_dataset_column_t* column = (imgui_dataset_column_t*)api->lua->newuserdatauv(L, sizeof(imgui_dataset_column_t), 1);
+    column->dataset = ds;
+    column->col = col;
+
+    imgui_series_bind(L, &s_dataset_column_vtbl);
+
+    /* Keep dataset alive */
+    api->lua->pushvalue(L, 1);
+    api->lua->setiuservalue(L, -2, 1);
+
+    static const auto_luaL_Reg s_column_method[] = {
+        { "get",        _dataset_column_get },
+        { "size",       _dataset_column_size },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_dataset_column") != 0)
+    {
+        api->lua->L_newlib(L, s_column_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
+
+/**
+ * @brief Give every column its own version, so a version identifies the
+ *   column and not only the dataset.
+ */
+static void _dataset_versions(imgui_dataset_t* ds)
+{
+    ds->versions = (uint64_t*)malloc(sizeof(uint64_t) * (ds->num_cols ? ds->num_cols : 1));
+    for (size_t i = 0; i < ds->num_cols; i++)
+    {
+        ds->versions[i] = imgui_series_next_version();
+    }
+}
+
+static imgui_dataset_t* _dataset_new(lua_State* L, const char* path)
+{
+    imgui_dataset_t* ds = (imgui_dataset_t*)api->lua->newuserdatauv(L, sizeof(imgui_dataset_t), 0);
+    memset(ds, 0, sizeof(*ds));
+
+    static const auto_luaL_Reg s_dataset_meta[] = {
+        { "__gc",       _dataset_gc },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_dataset_method[] = {
+        { "column",     _dataset_column },
+        { "columns",    _dataset_columns },
+        { "rows",       _dataset_rows },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_dataset") != 0)
+    {
+        api->lua->L_setfuncs(L, s_dataset_meta, 0);
+        api->lua->L_newlib(L, s_dataset_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    int ret = imgui_file_map(&ds->map, path);
+    if (ret != 0)
+    {
+        api->lua->L_error(L, "open `%s` failed: %s", path, strerror(ret));
+    }
+
+    return ds;
+}
+
+/**
+ * @brief Map raw binary file.
+ *
+ * The file is a sequence of rows, each row contains \p columns elements of
+ * \p type.
+ *
+ * [1]: string path
+ * [2]: string type
+ * [3]: integer columns, default 1
+ * [4]: integer header bytes, default 0
+ */
+static int _dataset_mmap(lua_State* L)
+{
+    const char* path = api->lua->L_checkstring(L, 1);
+    imgui_dtype_t type = imgui_dtype_check(L, 2, IMGUI_DTYPE_F64);
+    int64_t columns = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 3) : 1;
+    int64_t header = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 4) : 0;
+    /* Elements are read through typed pointers, so they must be aligned */
+    if (columns < 1 || header < 0 || header % imgui_dtype_size(type) != 0)
+    {
+        return api->lua->L_error(L, "invalid layout: columns=%d, header=%d", (int)columns, (int)header);
+    }
+
+    imgui_dataset_t* ds = _dataset_new(L, path);
+    ds->kind = IMGUI_DATASET_BINARY;
+    ds->num_cols = columns;
+    ds->binary.type = type;
+    ds->binary.header = header;
+
+    size_t row_size = imgui_dtype_size(type) * columns;
+    ds->num_rows = ds->map.size > (size_t)header ? (ds->map.size - header) / row_size : 0;
+    _dataset_versions(ds);
+
+    return 1;
+}
+
+/**
+ * @brief Map CSV file.
+ *
+ * [1]: string path
+ * [2]: table options
+ *   + delimiter: string, default ","
+ *   + header: boolean, default true
+ */
+static int _dataset_csv(lua_State* L)
+{
+    const char* path = api->lua->L_checkstring(L, 1);
+
+    char delimiter = ',';
+    int header = 1;
+    if (api->lua->type(L, 2) == AUTO_LUA_TTABLE)
+    {
+        if (api->lua->getfield(L, 2, "delimiter") == AUTO_LUA_TSTRING)
+        {
+            size_t len;
+            const char* str = api->lua->tolstring(L, -1, &len);
+            if (len != 1 || *str == '"' || *str == '\n' || *str == '\r')
+            {
+                return api->lua->L_error(L, "invalid delimiter '%s'", str);
+            }
+            delimiter = *str;
+        }
+        api->lua->pop(L, 1);
+
+        if (api->lua->getfield(L, 2, "header") == AUTO_LUA_TBOOLEAN)
+        {
+            header = api->lua->toboolean(L, -1);
+        }
+        api->lua->pop(L, 1);
+    }
+
+    imgui_dataset_t* ds = _dataset_new(L, path);
+    ds->kind = IMGUI_DATASET_CSV;
+    ds->csv.delimiter = delimiter;
+
+    _dataset_csv_header(ds, header);
+    _dataset_csv_index(ds, header);
+    ds->csv.caches = (imgui_dataset_cache_t*)calloc(ds->num_cols ? ds->num_cols : 1,
+        sizeof(imgui_dataset_cache_t));
+    _dataset_versions(ds);
+
+    return 1;
+}
+
+int imgui_luaopen_dataset(lua_State *L)
+{
+    static const auto_luaL_Reg s_dataset_method[] = {
+        { "csv",        _dataset_csv },
+        { "mmap",       _dataset_mmap },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_dataset_method);
+    return 1;
+}
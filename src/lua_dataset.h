@@ -0,0 +1,20 @@
+#ifndef __LUA_DATASET_H__
+#define __LUA_DATASET_H__
+
+#include <autodo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Open ImGui extension dataset.
+ * @param[in] L     Lua VM.
+ * @return          Always 1.
+ */
+AUTO_LOCAL int imgui_luaopen_dataset(lua_State *L);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,303 @@
+#include <string.h>
+#include "lua_derive.h"
+#include "lua_imgui.h"
+#include "buffer.hpp"
+#include "derive.hpp"
+
+/**
+ * @brief Lua handle of a derived series.
+ *
+ * User values: 1 is source buffer, 2 and 3 are output buffers.
+ */
+typedef struct imgui_derive_ref
+{
+    imgui_derive_t*     derive;
+    imgui_buffer_t*     source;
+    imgui_buffer_t*     output[2];
+    size_t              num_output;
+    uint64_t            consumed;   /**< #imgui_buffer_t::total fed to worker. */
+    uint64_t            epoch;      /**< #imgui_buffer_t::epoch fed to worker. */
+} imgui_derive_ref_t;
+
+static const struct
+{
+    const char*         name;
+    imgui_derive_kind_t kind;
+} s_derive_kinds[] = {
+    { "decimate",   IMGUI_DERIVE_DECIMATE },
+    { "diff",       IMGUI_DERIVE_DIFF },
+    { "ema",        IMGUI_DERIVE_EMA },
+    { "envelope",   IMGUI_DERIVE_ENVELOPE },
+    { "fft",        IMGUI_DERIVE_FFT },
+    { "mean",       IMGUI_DERIVE_MEAN },
+};
+
+static imgui_derive_ref_t* _derive_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_derive");
+    return (imgui_derive_ref_t*)api->lua->touserdata(L, arg);
+}
+
+static double _derive_opt_number(lua_State* L, int idx, const char* name, double def)
+{
+    double ret = def;
+    if (api->lua->type(L, idx) == AUTO_LUA_TTABLE)
+    {
+        if (api->lua->getfield(L, idx, name) == AUTO_LUA_TNUMBER)
+        {
+            ret = api->lua->tonumber(L, -1);
+        }
+        api->lua->pop(L, 1);
+    }
+    return ret;
+}
+
+static int _derive_gc(lua_State* L)
+{
+    imgui_derive_ref_t* ref = _derive_check(L, 1);
+    if (ref->derive != NULL)
+    {
+        imgui_derive_release(ref->derive);
+        ref->derive = NULL;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append results of workers to output buffers.
+ * @note Results are owned here so they are released before raising error.
+ * @param[in] ref       Derived series.
+ * @param[out] changed  Set to true if output buffers changed.
+ * @return              0 if success, or errno.
+ */
+static int _derive_publish(imgui_derive_ref_t* ref, bool* changed)
+{
+    std::vector<double> results[2];
+    bool replace;
+    if (!imgui_derive_collect(ref->derive, results, &replace))
+    {
+        return 0;
+    }
+
+    int ret = 0;
+    for (size_t i = 0; i < ref->num_output; i++)
+    {
+        if (replace)
+        {
+            imgui_buffer_clear(ref->output[i]);
+        }
+        for (size_t j = 0; j < results[i].size() && ret == 0; j++)
+        {
+            ret = imgui_buffer_push(ref->output[i], results[i][j]);
+        }
+        imgui_buffer_touch(ref->output[i]);
+    }
+    *changed = true;
+    return ret;
+}
+
+/**
+ * @brief Publish results of workers to output buffers, then queue samples
+ *   appended to source since last update.
+ *
+ * Modification of existing source elements (`set()`, `clear()`, editing
+ * widgets) restarts computation from current source content.
+ *
+ * [1]: derived series
+ * Returns: boolean whether output buffers changed
+ */
+static int _derive_update(lua_State* L)
+{
+    imgui_derive_ref_t* ref = _derive_check(L, 1);
+    imgui_buffer_t* src = ref->source;
+    bool changed = false;
+
+    int ret = _derive_publish(ref, &changed);
+    if (ret != 0)
+    {
+        return api->lua->L_error(L, "publish results failed: %s", strerror(ret));
+    }
+
+    bool reset = src->epoch != ref->epoch;
+    if (reset)
+    {
+        for (size_t i = 0; i < ref->num_output; i++)
+        {
+            imgui_buffer_clear(ref->output[i]);
+            imgui_buffer_touch(ref->output[i]);
+        }
+        ref->epoch = src->epoch;
+        ref->consumed = src->total - src->size;
+        changed = true;
+    }
+
+    /* Elements overwritten by ring buffer before update are skipped */
+    size_t n = (size_t)(src->total - ref->consumed);
+    n = n < src->size ? n : src->size;
+    ref->consumed = src->total;
+    if (n == 0 && !reset)
+    {
+        api->lua->pushboolean(L, changed);
+        return 1;
+    }
+
+    std::vector<double> input(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const void* addr = imgui_buffer_at(src, src->size - n + i);
+        IMGUI_DTYPE_DISPATCH(src->type, T, input[i] = (double)*(const T*)addr);
+    }
+    imgui_derive_feed(ref->derive, input.data(), n, reset);
+
+    api->lua->pushboolean(L, changed);
+    return 1;
+}
+
+/**
+ * @brief Get output buffer.
+ *
+ * [1]: derived series
+ * [2]: integer index, optional. 1 for minimum and 2 for maximum of envelope.
+ * Returns: buffer
+ */
+static int _derive_output(lua_State* L)
+{
+    imgui_derive_ref_t* ref = _derive_check(L, 1);
+    int64_t idx = api->lua->type(L, 2) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 2) : 1;
+    if (idx < 1 || (size_t)idx > ref->num_output)
+    {
+        return api->lua->L_error(L, "output %d out of range [1, %d]", (int)idx, (int)ref->num_output);
+    }
+
+    api->lua->getiuservalue(L, 1, (int)idx + 1);
+    return 1;
+}
+
+/**
+ * @brief Check whether samples are still being processed.
+ *
+ * [1]: derived series
+ * Returns: boolean
+ */
+static int _derive_busy(lua_State* L)
+{
+    imgui_derive_ref_t* ref = _derive_check(L, 1);
+    api->lua->pushboolean(L, imgui_derive_busy(ref->derive));
+    return 1;
+}
+
+/**
+ * @brief Create a derived series of a buffer.
+ *
+ * [1]: buffer source
+ * [2]: string kind
+ * [3]: table options, optional
+ *   + window: integer, default 16. FFT size for `fft`, factor for `decimate`.
+ *   + alpha: number, EMA smoothing factor. Default from `span`.
+ *   + span: number, EMA span, alpha is `2 / (span + 1)`. Default 16.
+ *   + dt: number, sample interval of `diff`. Default 1.
+ *   + hop: integer, new samples between FFTs. Default `window / 4`.
+ *   + capacity: integer, output capacity. Default source capacity, divided
+ *     by window for `decimate`. Ignored by `fft`.
+ * Returns: derived series
+ */
+static int _derive_new(lua_State* L)
+{
+    imgui_buffer_t* src = imgui_buffer_check(L, 1);
+    const char* name = api->lua->L_checkstring(L, 2);
+
+    imgui_derive_param_t param;
+    memset(&param, 0, sizeof(param));
+
+    size_t i;
+    for (i = 0; i < sizeof(s_derive_kinds) / sizeof(s_derive_kinds[0]); i++)
+    {
+        if (strcmp(s_derive_kinds[i].name, name) == 0)
+        {
+            break;
+        }
+    }
+    if (i == sizeof(s_derive_kinds) / sizeof(s_derive_kinds[0]))
+    {
+        return api->lua->L_error(L, "unknown derived series `%s`", name);
+    }
+    param.kind = s_derive_kinds[i].kind;
+
+    int64_t window = (int64_t)_derive_opt_number(L, 3, "window", 16);
+    double span = _derive_opt_number(L, 3, "span", 16);
+    param.alpha = _derive_opt_number(L, 3, "alpha", 2 / (span + 1));
+    param.dt = _derive_opt_number(L, 3, "dt", 1);
+    int64_t hop = (int64_t)_derive_opt_number(L, 3, "hop", (double)(window / 4));
+
+    /* Spectrum is replaced as a whole, decimation produces fewer elements */
+    int64_t capacity = src->ring ? (int64_t)src->capacity : 0;
+    if (param.kind == IMGUI_DERIVE_DECIMATE && window > 0)
+    {
+        capacity = (capacity + window - 1) / window;
+    }
+    capacity = (int64_t)_derive_opt_number(L, 3, "capacity", (double)capacity);
+    capacity = param.kind == IMGUI_DERIVE_FFT ? 0 : capacity;
+
+    if (window < 1 || (param.kind == IMGUI_DERIVE_FFT && (window < 2 || (window & (window - 1)) != 0)))
+    {
+        return api->lua->L_error(L, "invalid window %d", (int)window);
+    }
+    if (!(param.alpha > 0 && param.alpha <= 1))
+    {
+        return api->lua->L_error(L, "alpha %f out of range (0, 1]", param.alpha);
+    }
+    if (param.dt == 0 || capacity < 0)
+    {
+        return api->lua->L_error(L, "invalid dt %f or capacity %d", param.dt, (int)capacity);
+    }
+    param.window = (size_t)window;
+    param.hop = hop > 0 ? (size_t)hop : 1;
+
+    imgui_derive_ref_t* ref = (imgui_derive_ref_t*)api->lua->newuserdatauv(L, sizeof(imgui_derive_ref_t), 3);
+    memset(ref, 0, sizeof(*ref));
+    ref->num_output = imgui_derive_outputs(param.kind);
+    ref->source = src;
+    /* Existing content is processed by first update */
+    ref->consumed = src->total - src->size;
+    ref->epoch = src->epoch;
+
+    api->lua->pushvalue(L, 1);
+    api->lua->setiuservalue(L, -2, 1);
+    for (i = 0; i < ref->num_output; i++)
+    {
+        ref->output[i] = imgui_buffer_new(L, IMGUI_DTYPE_F64, (size_t)capacity);
+        api->lua->setiuservalue(L, -2, (int)i + 2);
+    }
+
+    static const auto_luaL_Reg s_derive_meta[] = {
+        { "__gc",       _derive_gc },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_derive_method[] = {
+        { "busy",       _derive_busy },
+        { "output",     _derive_output },
+        { "update",     _derive_update },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_derive") != 0)
+    {
+        api->lua->L_setfuncs(L, s_derive_meta, 0);
+        api->lua->L_newlib(L, s_derive_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    ref->derive = imgui_derive_create(&param);
+
+    return 1;
+}
+
+int imgui_luaopen_derive(lua_State *L)
+{
+    static const auto_luaL_Reg s_derive_method[] = {
+        { "new",        _derive_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_derive_method);
+    return 1;
+}
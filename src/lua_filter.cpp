@@ -0,0 +1,322 @@
+#include <imgui.h>
+#include <imgui_stdlib.h>
+#include <string>
+#include "lua_filter.h"
+#include "lua_imgui.h"
+#include "filter.hpp"
+
+/**
+ * @brief Lua handle of a filter.
+ */
+typedef struct imgui_filter_ref
+{
+    imgui_filter_t*     filter;
+    std::string*        query;      /**< Text of input box. */
+    int64_t             selected;   /**< Selected string, or -1. */
+    bool                regex;
+    bool                icase;
+} imgui_filter_ref_t;
+
+static imgui_filter_ref_t* _filter_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_filter");
+    return (imgui_filter_ref_t*)api->lua->touserdata(L, arg);
+}
+
+static int _filter_gc(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    if (ref->filter != NULL)
+    {
+        imgui_filter_destroy(ref->filter);
+        ref->filter = NULL;
+    }
+    if (ref->query != NULL)
+    {
+        delete ref->query;
+        ref->query = NULL;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append strings.
+ *
+ * [1]: filter
+ * [2+]: string or table of strings
+ */
+static int _filter_append(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    int sp = api->lua->gettop(L);
+
+    for (int i = 2; i <= sp; i++)
+    {
+        size_t len;
+        if (api->lua->type(L, i) != AUTO_LUA_TTABLE)
+        {
+            const char* str = api->lua->L_checklstring(L, i, &len);
+            imgui_filter_push(ref->filter, str, len);
+            continue;
+        }
+
+        int64_t n = api->lua->L_len(L, i);
+        for (int64_t j = 1; j <= n; j++)
+        {
+            api->lua->geti(L, i, j);
+            const char* str = api->lua->tolstring(L, -1, &len);
+            if (str == NULL)
+            {
+                return api->lua->L_error(L, "element #%d of argument #%d is not a string", (int)j, i);
+            }
+            imgui_filter_push(ref->filter, str, len);
+            api->lua->pop(L, 1);
+        }
+    }
+    return 0;
+}
+
+static int _filter_clear(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    imgui_filter_clear(ref->filter);
+    ref->selected = -1;
+    return 0;
+}
+
+static int _filter_size(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_filter_size(ref->filter));
+    return 1;
+}
+
+/**
+ * @brief Get string.
+ *
+ * [1]: filter
+ * [2]: integer index in insertion order
+ * Returns: string, or nil if out of range
+ */
+static int _filter_get(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    int64_t idx = api->lua->L_checkinteger(L, 2);
+    if (idx < 1 || (size_t)idx > imgui_filter_size(ref->filter))
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    size_t len;
+    const char* str = imgui_filter_at(ref->filter, (size_t)idx - 1, &len);
+    api->lua->pushlstring(L, str, len);
+    return 1;
+}
+
+/**
+ * @brief Set query.
+ *
+ * [1]: filter
+ * [2]: string query
+ * [3]: table options, optional
+ *   + regex: boolean, default false
+ *   + icase: boolean, ignore ASCII case of text query, default true
+ * Returns: boolean, false if regex does not compile
+ */
+static int _filter_set(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    const char* query = api->lua->L_checkstring(L, 2);
+
+    if (api->lua->type(L, 3) == AUTO_LUA_TTABLE)
+    {
+        if (api->lua->getfield(L, 3, "regex") == AUTO_LUA_TBOOLEAN)
+        {
+            ref->regex = api->lua->toboolean(L, -1);
+        }
+        api->lua->pop(L, 1);
+
+        if (api->lua->getfield(L, 3, "icase") == AUTO_LUA_TBOOLEAN)
+        {
+            ref->icase = api->lua->toboolean(L, -1);
+        }
+        api->lua->pop(L, 1);
+    }
+
+    *ref->query = query;
+    api->lua->pushboolean(L, imgui_filter_set(ref->filter, query, ref->regex, ref->icase) == 0);
+    return 1;
+}
+
+/**
+ * @brief Get the number of strings passing query.
+ *
+ * [1]: filter
+ * Returns: integer
+ */
+static int _filter_count(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_filter_hits(ref->filter).size());
+    return 1;
+}
+
+/**
+ * @brief Get a string passing query.
+ *
+ * [1]: filter
+ * [2]: integer position in passing strings
+ * Returns: integer index in insertion order and string, or nil if out of range
+ */
+static int _filter_hit(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    int64_t pos = api->lua->L_checkinteger(L, 2);
+    const std::vector<uint32_t>& hits = imgui_filter_hits(ref->filter);
+    if (pos < 1 || (size_t)pos > hits.size())
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    size_t len;
+    const char* str = imgui_filter_at(ref->filter, hits[pos - 1], &len);
+    api->lua->pushinteger(L, (int64_t)hits[pos - 1] + 1);
+    api->lua->pushlstring(L, str, len);
+    return 2;
+}
+
+/**
+ * @brief Draw input box of query, like `ImGuiTextFilter::Draw()`.
+ *
+ * An invalid regex keeps previous result until it compiles.
+ *
+ * [1]: filter
+ * [2]: string label
+ * [3]: number width, optional
+ * Returns: boolean whether query changed
+ */
+static int _filter_input(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    const char* label = api->lua->L_checkstring(L, 2);
+
+    if (api->lua->type(L, 3) == AUTO_LUA_TNUMBER)
+    {
+        ImGui::SetNextItemWidth((float)api->lua->tonumber(L, 3));
+    }
+
+    bool changed = ImGui::InputText(label, ref->query);
+    if (changed)
+    {
+        imgui_filter_set(ref->filter, ref->query->c_str(), ref->regex, ref->icase);
+    }
+
+    api->lua->pushboolean(L, changed);
+    return 1;
+}
+
+/**
+ * @brief Draw strings passing query as a selectable list. Only visible
+ *   strings are drawn.
+ *
+ * [1]: filter
+ * [2]: string id
+ * [3]: number height, optional. Default fills remaining space.
+ * Returns: integer index in insertion order of clicked string, or nil
+ */
+static int _filter_draw(lua_State* L)
+{
+    imgui_filter_ref_t* ref = _filter_check(L, 1);
+    const char* id = api->lua->L_checkstring(L, 2);
+    float height = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 3) : 0.0f;
+    const std::vector<uint32_t>& hits = imgui_filter_hits(ref->filter);
+    int64_t clicked = -1;
+
+    if (ImGui::BeginChild(id, ImVec2(0.0f, height), true))
+    {
+        ImGuiListClipper clipper;
+        clipper.Begin((int)hits.size());
+        while (clipper.Step())
+        {
+            for (int pos = clipper.DisplayStart; pos < clipper.DisplayEnd; pos++)
+            {
+                size_t len;
+                const char* str = imgui_filter_at(ref->filter, hits[pos], &len);
+
+                /* Strings are not NUL terminated and may contain `##`, so draw text separately */
+                ImGui::PushID(pos);
+                float x = ImGui::GetCursorPosX();
+                if (ImGui::Selectable("##item", ref->selected == (int64_t)hits[pos]))
+                {
+                    clicked = hits[pos];
+                    ref->selected = clicked;
+                }
+                ImGui::SameLine(x);
+                ImGui::TextUnformatted(str, str + len);
+                ImGui::PopID();
+            }
+        }
+    }
+    ImGui::EndChild();
+
+    if (clicked < 0)
+    {
+        return 0;
+    }
+    api->lua->pushinteger(L, clicked + 1);
+    return 1;
+}
+
+/**
+ * @brief Create filter.
+ *
+ * Returns: filter
+ */
+static int _filter_new(lua_State* L)
+{
+    imgui_filter_ref_t* ref = (imgui_filter_ref_t*)api->lua->newuserdatauv(L, sizeof(imgui_filter_ref_t), 0);
+    ref->filter = imgui_filter_create();
+    ref->query = new std::string;
+    ref->selected = -1;
+    ref->regex = false;
+    ref->icase = true;
+
+    static const auto_luaL_Reg s_filter_meta[] = {
+        { "__gc",       _filter_gc },
+        { "__len",      _filter_size },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_filter_method[] = {
+        { "append",     _filter_append },
+        { "clear",      _filter_clear },
+        { "count",      _filter_count },
+        { "draw",       _filter_draw },
+        { "get",        _filter_get },
+        { "hit",        _filter_hit },
+        { "input",      _filter_input },
+        { "set",        _filter_set },
+        { "size",       _filter_size },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_filter") != 0)
+    {
+        api->lua->L_setfuncs(L, s_filter_meta, 0);
+        api->lua->L_newlib(L, s_filter_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
+
+int imgui_luaopen_filter(lua_State *L)
+{
+    static const auto_luaL_Reg s_filter_method[] = {
+        { "new",        _filter_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_filter_method);
+    return 1;
+}
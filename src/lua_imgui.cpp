@@ -1,43 +1,169 @@
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
 #include <imgui.h>
 #include <imgui_stdlib.h>
+#include <condition_variable>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <imgui_internal.h>
 #include "ImGuiAdapter.hpp"
+#include "allocator.hpp"
+#include "buffer.hpp"
+#include "capture.hpp"
+#include "governor.hpp"
+#include "implot_cache.hpp"
+#include "lua_buffer.h"
+#include "lua_dataset.h"
+#include "lua_derive.h"
+#include "lua_filter.h"
 #include "lua_implot.h"
+#include "lua_packed.h"
+#include "lua_playback.h"
+#include "lua_profiler.h"
+#include "lua_stats.h"
+#include "lua_store.h"
+#include "lua_table.h"
+#include "lua_timeseries.h"
+#include "lua_trace.h"
+#include "lua_tree.h"
 #include "lua_imgui.h"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 
 #define LUA_IMGUI_SET_FLAG(x)   \
     _imgui_add_constant(L, -2, #x, x)
 
+/**
+ * @brief Size of stack buffer for formatted text.
+ */
+#define IMGUI_FORMAT_BUFFER_SIZE    1024
+
 const auto_api_t* api;
 
+/**
+ * @brief Frame completion between Lua thread and GUI thread.
+ *
+ * The semaphore of autodo does not support timed wait, which is required by
+ * frame deadline.
+ */
+struct imgui_frame_sync
+{
+    std::mutex              mutex;
+    std::condition_variable cond;
+    bool                    done;       /**< User function finished current frame. */
+};
+
+/**
+ * @brief Frames presented again while waiting for user function.
+ */
+static struct
+{
+    uint64_t    last;       /**< Frames skipped before last completed frame. */
+    uint64_t    total;      /**< Frames skipped since loop started. */
+} s_skipped = { 0, 0 };
+
 static void _imgui_add_constant(lua_State* L, int idx, const char* field, int64_t value)
 {
     api->lua->pushinteger(L, value);
     api->lua->setfield(L, idx, field);
 }
 
+/**
+ * @brief Signal GUI thread that user function finished a frame, or that it
+ *   should stop waiting.
+ */
+static void _imgui_signal_frame(imgui_ctx_t* gui)
+{
+    std::lock_guard<std::mutex> guard(gui->sync->mutex);
+    gui->sync->done = true;
+    gui->sync->cond.notify_one();
+}
+
+/**
+ * @brief Wait for user function to finish current frame.
+ *
+ * If frame deadline is set, the last completed frame is presented again
+ * every time the deadline expires, so the window keeps responding.
+ */
+static void _imgui_wait_frame(imgui_ctx_t* gui)
+{
+    imgui_frame_sync* sync = gui->sync;
+    uint64_t skipped = 0;
+
+    std::unique_lock<std::mutex> lock(sync->mutex);
+    for (;;)
+    {
+        if (gui->frame_deadline == 0)
+        {
+            sync->cond.wait(lock, [gui, sync] { return sync->done || !gui->looping; });
+            break;
+        }
+
+        if (sync->cond.wait_for(lock, std::chrono::nanoseconds(gui->frame_deadline),
+            [gui, sync] { return sync->done || !gui->looping; }))
+        {
+            break;
+        }
+
+        lock.unlock();
+        IMGUI_TRACE_INSTANT("skip");
+        ImGuiAdapterIdle(gui);
+        skipped++;
+        lock.lock();
+    }
+    sync->done = false;
+
+    s_skipped.last = skipped;
+    s_skipped.total += skipped;
+}
+
 static void _imgui_payload(imgui_ctx_t* gui)
 {
+    gui->now_time = api->misc->hrtime();
+    uint64_t delta = gui->now_time - gui->last_frame;
+    gui->last_frame = gui->now_time;
+    imgui_alloc_frame();
+
+    /* Frame cost does not include time slept for frame rate limit */
+    uint64_t cost = delta > gui->slept ? delta - gui->slept : 0;
+    imgui_governor_update(cost, gui->fps_delay);
+    gui->slept = 0;
+
     if (gui->fps != 0)
     {
-        gui->now_time = api->misc->hrtime();
-        uint64_t delta = gui->now_time - gui->last_frame;
-        gui->last_frame = gui->now_time;
+        uint64_t delay = gui->fps_delay;
+        if (imgui_governor_level() >= 3 && !ImGuiAdapterFocused())
+        {
+            delay *= 4;
+        }
 
-        if (delta < gui->fps_delay)
+        if (cost < delay)
         {
-            api->thread->sleep((gui->fps_delay - delta) / 1000 / 1000);
+            gui->slept = delay - cost;
+            IMGUI_TRACE_BEGIN("sleep");
+            api->thread->sleep(gui->slept / 1000 / 1000);
+            IMGUI_TRACE_END();
         }
     }
 
+    IMGUI_TRACE_BEGIN("wait");
+    gui->wakeup = api->misc->hrtime();
     api->notify->send(gui->nfy_gui_update);
-    api->sem->wait(gui->sem);
+    _imgui_wait_frame(gui);
+    IMGUI_TRACE_END();
 }
 
 static void _imgui_thread(void* arg)
 {
     imgui_ctx_t* gui = (imgui_ctx_t*)arg;
 
+    imgui_trace_thread_name("gui");
     gui->last_frame = api->misc->hrtime();
 
     ImGuiAdapter(gui, _imgui_payload);
@@ -48,13 +174,86 @@ static void _imgui_thread(void* arg)
 
 static int _on_gui_loop_beg(lua_State* L, int status, void* ctx);
 
+/**
+ * @brief Run callbacks of finished captures.
+ * @param[in] L     Lua VM.
+ * @param[in] call  Release callbacks without calling them if zero.
+ */
+static void _imgui_capture_dispatch(lua_State* L, int call)
+{
+    std::vector<imgui_capture_result_t> results;
+    imgui_capture_take(results);
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        imgui_capture_result_t& r = results[i];
+        if (r.ref == IMGUI_CAPTURE_NOREF)
+        {
+            continue;
+        }
+
+        /*
+         * Called through pcall(), so an error in user callback does not
+         * unwind through the frame.
+         */
+        int protect = api->lua->getglobal(L, "pcall") == AUTO_LUA_TFUNCTION;
+        if (!protect)
+        {
+            api->lua->pop(L, 1);
+        }
+        api->lua->geti(L, AUTO_LUA_REGISTRYINDEX, r.ref);
+        api->lua->L_unref(L, AUTO_LUA_REGISTRYINDEX, r.ref);
+        if (!call)
+        {
+            api->lua->pop(L, protect ? 2 : 1);
+            continue;
+        }
+
+        int nargs;
+        if (r.err != 0)
+        {
+            api->lua->pushnil(L);
+            api->lua->pushstring(L, strerror(r.err));
+            nargs = 2;
+        }
+        else if (!r.path.empty())
+        {
+            api->lua->pushstring(L, r.path.c_str());
+            nargs = 1;
+        }
+        else
+        {
+            api->lua->pushlstring(L, (const char*)r.pixels.data(), r.pixels.size());
+            api->lua->pushinteger(L, r.width);
+            api->lua->pushinteger(L, r.height);
+            nargs = 3;
+        }
+        if (!protect)
+        {
+            api->lua->callk(L, nargs, 0, 0, NULL);
+            continue;
+        }
+
+        api->lua->callk(L, nargs + 1, 2, 0, NULL);
+        if (!api->lua->toboolean(L, -2))
+        {
+            const char* msg = api->lua->tostring(L, -1);
+            fprintf(stderr, "capture callback: %s\n", msg != NULL ? msg : "(error object is not a string)");
+        }
+        api->lua->pop(L, 2);
+    }
+}
+
 static int _on_gui_loop_end(lua_State* L, int status, void* ctx)
 {
     (void)status;
     imgui_ctx_t* gui = (imgui_ctx_t*)ctx;
 
+    imgui_profiler_frame_end(L);
+    IMGUI_TRACE_END();
+
     /* Notify that GUI loop is done */
-    api->sem->post(gui->sem);
+    _imgui_signal_frame(gui);
 
     /* Wait for GUI thread to wakeup */
     api->coroutine->set_state(gui->co, AUTO_COROUTINE_WAIT);
@@ -91,6 +290,13 @@ static int _on_gui_loop_beg(lua_State* L, int status, void* ctx)
         api->lua->pushvalue(L, i);
     }
 
+    _imgui_capture_dispatch(L, 1);
+
+    /* Time from GUI thread asking for a frame to user function running */
+    IMGUI_TRACE_COMPLETE("wakeup", gui->wakeup, api->misc->hrtime() - gui->wakeup);
+    IMGUI_TRACE_BEGIN("callback");
+
+    imgui_profiler_frame_begin(L);
     return api->lua->A_callk(L, sp - 2, 0, gui, _on_gui_loop_end);
 }
 
@@ -106,6 +312,7 @@ static int _imgui_coroutine(lua_State *L)
 {
     imgui_ctx_t* gui = (imgui_ctx_t*)api->lua->touserdata(L, 1);
     gui->co = api->coroutine->find(L);
+    imgui_trace_thread_name("lua");
 
     /* Run gui in standalone thread */
     gui->gui_thr = api->thread->create(_imgui_thread, gui);
@@ -121,18 +328,25 @@ static int _imgui_gc(lua_State *L)
 
     /* Stop gui thread */
     gui->looping = 0;
-    api->sem->post(gui->sem);
+    if (gui->sync != NULL)
+    {
+        _imgui_signal_frame(gui);
+    }
 
     if (gui->gui_thr != NULL)
     {
         api->thread->join(gui->gui_thr);
         gui->gui_thr = NULL;
     }
-    if (gui->sem != NULL)
+    if (gui->sync != NULL)
     {
-        api->sem->destroy(gui->sem);
-        gui->sem = NULL;
+        delete gui->sync;
+        gui->sync = NULL;
     }
+
+    uint64_t written, dropped;
+    imgui_capture_stream_stop(&written, &dropped);
+    _imgui_capture_dispatch(L, 0);
     if (gui->nfy_gui_update != NULL)
     {
         api->notify->destroy(gui->nfy_gui_update);
@@ -164,6 +378,7 @@ static int _imgui_begin(lua_State *L)
     ImGuiWindowFlags flag = api->lua->tointeger(L, 3);
 
     /* call */
+    imgui_profiler_scope_push(str);
     bool ret = ImGui::Begin(str, p_open, flag);
     api->lua->pushboolean(L, ret);
     api->lua->pushboolean(L, is_open);
@@ -174,6 +389,7 @@ static int _imgui_end(lua_State *L)
 {
     (void)L;
     ImGui::End();
+    imgui_profiler_scope_pop();
     return 0;
 }
 
@@ -200,8 +416,165 @@ static int _imgui_button(lua_State *L)
 
 static int _imgui_text(lua_State *L)
 {
-    const char* str = api->lua->L_checkstring(L, 1);
-    ImGui::Text("%s", str);
+    size_t len;
+    const char* str = api->lua->L_checklstring(L, 1, &len);
+    ImGui::TextUnformatted(str, str + len);
+    return 0;
+}
+
+/**
+ * @brief Format arguments after \p idx with the format string at \p idx.
+ *
+ * Each conversion is checked against its argument like `string.format()`,
+ * then formatted by snprintf(3) into \p buf. Output is truncated to fit.
+ *
+ * @param[in] L     Lua VM.
+ * @param[in] idx   Stack index of format string.
+ * @param[out] buf  Output buffer.
+ * @param[in] size  Size of \p buf.
+ * @return          Length of output.
+ */
+static size_t _imgui_format(lua_State* L, int idx, char* buf, size_t size)
+{
+    static const char* s_flags = "-+ #0";
+    const char* fmt = api->lua->L_checkstring(L, idx);
+    int arg = idx;
+    size_t len = 0;
+
+    while (*fmt != '\0' && len < size - 1)
+    {
+        if (*fmt != '%')
+        {
+            buf[len++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%')
+        {
+            buf[len++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        /*
+         * Copy flags, width and precision with the same limits as
+         * `string.format()`: each flag at most once, at most 2 digits of width
+         * and precision. The longest spec leaves room for length modifier.
+         */
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *fmt++;
+        while (*fmt != '\0' && strchr(s_flags, *fmt) != NULL)
+        {
+            if (memchr(spec + 1, *fmt, n - 1) != NULL)
+            {
+                break;
+            }
+            spec[n++] = *fmt++;
+        }
+        for (int i = 0; i < 2 && isdigit((unsigned char)*fmt); i++)
+        {
+            spec[n++] = *fmt++;
+        }
+        if (*fmt == '.')
+        {
+            spec[n++] = *fmt++;
+            for (int i = 0; i < 2 && isdigit((unsigned char)*fmt); i++)
+            {
+                spec[n++] = *fmt++;
+            }
+        }
+        char conv = *fmt;
+        spec[n] = '\0';
+        if (conv == '\0' || isdigit((unsigned char)conv) || conv == '.' || strchr(s_flags, conv) != NULL)
+        {
+            return api->lua->L_error(L, "invalid conversion '%s%c' to format", spec, conv);
+        }
+        fmt++;
+        arg++;
+
+        int ret;
+        switch (conv)
+        {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        {
+            int64_t v = api->lua->L_checkinteger(L, arg);
+            spec[n++] = 'l';
+            spec[n++] = 'l';
+            spec[n++] = conv;
+            spec[n] = '\0';
+            ret = snprintf(buf + len, size - len, spec, (long long)v);
+            break;
+        }
+
+        case 'c':
+        {
+            int64_t v = api->lua->L_checkinteger(L, arg);
+            spec[n++] = conv;
+            spec[n] = '\0';
+            ret = snprintf(buf + len, size - len, spec, (int)v);
+            break;
+        }
+
+        case 'a': case 'A': case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+        {
+            double v = api->lua->L_checknumber(L, arg);
+            spec[n++] = conv;
+            spec[n] = '\0';
+            ret = snprintf(buf + len, size - len, spec, v);
+            break;
+        }
+
+        case 's':
+        {
+            const char* v = api->lua->L_checklstring(L, arg, NULL);
+            spec[n++] = conv;
+            spec[n] = '\0';
+            ret = snprintf(buf + len, size - len, spec, v);
+            break;
+        }
+
+        default:
+            return api->lua->L_error(L, "invalid conversion '%s%c' to format", spec, conv);
+        }
+
+        if (ret > 0)
+        {
+            len = len + ret < size - 1 ? len + ret : size - 1;
+        }
+    }
+
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Formatted text, without creating a Lua string.
+ *
+ * [1]: string fmt
+ * [2+]: arguments
+ */
+static int _imgui_text_f(lua_State *L)
+{
+    char buf[IMGUI_FORMAT_BUFFER_SIZE];
+    size_t len = _imgui_format(L, 1, buf, sizeof(buf));
+    ImGui::TextUnformatted(buf, buf + len);
+    return 0;
+}
+
+/**
+ * @brief Formatted value with a label, in the layout of LabelText().
+ *
+ * [1]: string label
+ * [2]: string fmt
+ * [3+]: arguments
+ */
+static int _imgui_label_value(lua_State *L)
+{
+    const char* label = api->lua->L_checkstring(L, 1);
+
+    char buf[IMGUI_FORMAT_BUFFER_SIZE];
+    _imgui_format(L, 2, buf, sizeof(buf));
+    ImGui::LabelText(label, "%s", buf);
     return 0;
 }
 
@@ -275,6 +648,21 @@ static int _imgui_end_menu(lua_State *L)
     return 0;
 }
 
+static int _imgui_tree_node(lua_State *L)
+{
+    const char* label = api->lua->L_checkstring(L, 1);
+    bool ret = ImGui::TreeNode(label);
+    api->lua->pushboolean(L, ret);
+    return 1;
+}
+
+static int _imgui_tree_pop(lua_State *L)
+{
+    (void)L;
+    ImGui::TreePop();
+    return 0;
+}
+
 static int _imgui_menu_item(lua_State *L)
 {
     const char* label = api->lua->L_checkstring(L, 1);
@@ -293,13 +681,16 @@ static int _imgui_text_colored(lua_State *L)
     float c4 = api->lua->L_checknumber(L, 4);
     const char* text = api->lua->L_checkstring(L, 5);
 
-    ImGui::TextColored(ImVec4(c1, c2, c3, c4), "%s", text);
+    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(c1, c2, c3, c4));
+    ImGui::TextUnformatted(text);
+    ImGui::PopStyleColor();
     return 0;
 }
 
 static int _imgui_begin_child(lua_State *L)
 {
     const char* text = api->lua->L_checkstring(L, 1);
+    imgui_profiler_scope_push(text);
     ImGui::BeginChild(text);
     return 0;
 }
@@ -308,6 +699,7 @@ static int _imgui_end_child(lua_State *L)
 {
     (void)L;
     ImGui::EndChild();
+    imgui_profiler_scope_pop();
     return 0;
 }
 
@@ -440,6 +832,298 @@ static int _imgui_new_line(lua_State *L)
     return 0;
 }
 
+/**
+ * @brief ImGui data type of each element type, in order of #imgui_dtype_t.
+ */
+static const ImGuiDataType s_imgui_data_type[] = {
+    ImGuiDataType_S8,   ImGuiDataType_U8,   ImGuiDataType_S16,  ImGuiDataType_U16,
+    ImGuiDataType_S32,  ImGuiDataType_U32,  ImGuiDataType_S64,  ImGuiDataType_U64,
+    ImGuiDataType_Float, ImGuiDataType_Double,
+};
+
+/**
+ * @brief Elements of a buffer being edited in place.
+ */
+typedef struct imgui_edit
+{
+    imgui_buffer_t*     buf;
+    ImGuiDataType       type;
+    size_t              beg;        /**< First element, logical index. */
+    size_t              count;      /**< The number of elements. */
+    char*               data;       /**< Contiguous elements. */
+    char*               copy;       /**< Copy of elements if range wraps around ring, owned by a userdata on stack. */
+} imgui_edit_t;
+
+/**
+ * @brief Scalar argument converted to element type.
+ */
+typedef union imgui_scalar
+{
+    uint64_t            u64;
+    double              f64;
+} imgui_scalar_t;
+
+static const void* _imgui_scalar_arg(lua_State* L, int arg, imgui_dtype_t type, imgui_scalar_t* out)
+{
+    double v = api->lua->L_checknumber(L, arg);
+    if (v != v)
+    {
+        api->lua->L_error(L, "bad argument #%d (number is NaN)", arg);
+    }
+    IMGUI_DTYPE_DISPATCH(type, T, *(T*)out = imgui_dtype_cast<T>(v));
+    return out;
+}
+
+static const void* _imgui_scalar_optarg(lua_State* L, int arg, imgui_dtype_t type, imgui_scalar_t* out)
+{
+    return api->lua->type(L, arg) <= AUTO_LUA_TNIL ? NULL : _imgui_scalar_arg(L, arg, type, out);
+}
+
+static const char* _imgui_format_optarg(lua_State* L, int arg)
+{
+    return api->lua->type(L, arg) == AUTO_LUA_TSTRING ? api->lua->tostring(L, arg) : NULL;
+}
+
+static imgui_buffer_t* _imgui_edit_check(lua_State* L, int arg)
+{
+    imgui_buffer_t* buf = imgui_buffer_check(L, arg);
+    if (buf->spill != NULL)
+    {
+        api->lua->L_error(L, "cannot edit a spilling buffer");
+    }
+    return buf;
+}
+
+/**
+ * @brief Prepare elements for editing.
+ *
+ * [arg]: buffer
+ * [arg + 1]: integer first, optional, default 1
+ * [arg + 2]: integer count, optional, default to end of buffer
+ *
+ * The copy of a wrapped range is a userdata pushed on stack, so later argument
+ * errors do not leak it.
+ */
+static void _imgui_edit_begin(lua_State* L, int arg, imgui_edit_t* edit)
+{
+    imgui_buffer_t* buf = _imgui_edit_check(L, arg);
+    int64_t first = api->lua->type(L, arg + 1) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, arg + 1) : 1;
+    int64_t count = api->lua->type(L, arg + 2) == AUTO_LUA_TNUMBER ?
+        api->lua->tointeger(L, arg + 2) : (int64_t)buf->size - first + 1;
+    if (first < 1 || count < 0 || first - 1 + count > (int64_t)buf->size)
+    {
+        api->lua->L_error(L, "range [%d, %d) out of buffer size %d", (int)first, (int)(first + count), (int)buf->size);
+        return;
+    }
+
+    edit->buf = buf;
+    edit->type = s_imgui_data_type[buf->type];
+    edit->beg = (size_t)first - 1;
+    edit->count = (size_t)count;
+    edit->data = count > 0 ? (char*)imgui_buffer_at(buf, edit->beg) : NULL;
+    edit->copy = NULL;
+
+    /* Ring buffer may wrap inside range, edit a copy then */
+    if (count > 0 && (char*)imgui_buffer_at(buf, edit->beg + count - 1) != edit->data + (count - 1) * buf->elem_size)
+    {
+        edit->copy = (char*)api->lua->newuserdatauv(L, count * buf->elem_size, 0);
+        for (size_t i = 0; i < edit->count; i++)
+        {
+            memcpy(edit->copy + i * buf->elem_size, imgui_buffer_at(buf, edit->beg + i), buf->elem_size);
+        }
+        edit->data = edit->copy;
+    }
+}
+
+/**
+ * @brief Finish editing and push changed flag.
+ */
+static int _imgui_edit_end(lua_State* L, imgui_edit_t* edit, bool changed)
+{
+    if (changed)
+    {
+        for (size_t i = 0; i < edit->count && edit->copy != NULL; i++)
+        {
+            memcpy(imgui_buffer_at(edit->buf, edit->beg + i), edit->copy + i * edit->buf->elem_size, edit->buf->elem_size);
+        }
+        edit->buf->epoch++;
+        imgui_buffer_touch(edit->buf);
+    }
+
+    api->lua->pushboolean(L, changed);
+    return 1;
+}
+
+/**
+ * @brief Drag widgets over buffer elements, edited in place.
+ *
+ * [1]: string label
+ * [2]: buffer
+ * [3]: integer first, optional
+ * [4]: integer count, optional
+ * [5]: number speed, optional
+ * [6]: number min, optional
+ * [7]: number max, optional
+ * [8]: string format, optional
+ * Returns: boolean changed
+ */
+static int _imgui_drag_scalar_n(lua_State *L)
+{
+    const char* label = api->lua->L_checkstring(L, 1);
+    imgui_edit_t edit;
+    _imgui_edit_begin(L, 2, &edit);
+
+    float speed = api->lua->type(L, 5) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 5) : 1.0f;
+    imgui_scalar_t min, max;
+    const void* p_min = _imgui_scalar_optarg(L, 6, edit.buf->type, &min);
+    const void* p_max = _imgui_scalar_optarg(L, 7, edit.buf->type, &max);
+    const char* format = _imgui_format_optarg(L, 8);
+
+    bool changed = edit.count > 0
+        && ImGui::DragScalarN(label, edit.type, edit.data, (int)edit.count, speed, p_min, p_max, format);
+    return _imgui_edit_end(L, &edit, changed);
+}
+
+/**
+ * @brief Input widgets over buffer elements, edited in place.
+ *
+ * [1]: string label
+ * [2]: buffer
+ * [3]: integer first, optional
+ * [4]: integer count, optional
+ * [5]: string format, optional
+ * Returns: boolean changed
+ */
+static int _imgui_input_scalar_n(lua_State *L)
+{
+    const char* label = api->lua->L_checkstring(L, 1);
+    imgui_edit_t edit;
+    _imgui_edit_begin(L, 2, &edit);
+
+    const char* format = _imgui_format_optarg(L, 5);
+
+    bool changed = edit.count > 0
+        && ImGui::InputScalarN(label, edit.type, edit.data, (int)edit.count, NULL, NULL, format);
+    return _imgui_edit_end(L, &edit, changed);
+}
+
+/**
+ * @brief Slider widgets over buffer elements, edited in place.
+ *
+ * [1]: string label
+ * [2]: buffer
+ * [3]: integer first, optional
+ * [4]: integer count, optional
+ * [5]: number min
+ * [6]: number max
+ * [7]: string format, optional
+ * Returns: boolean changed
+ */
+static int _imgui_slider_scalar_n(lua_State *L)
+{
+    const char* label = api->lua->L_checkstring(L, 1);
+    imgui_edit_t edit;
+    _imgui_edit_begin(L, 2, &edit);
+
+    imgui_scalar_t min, max;
+    const void* p_min = _imgui_scalar_arg(L, 5, edit.buf->type, &min);
+    const void* p_max = _imgui_scalar_arg(L, 6, edit.buf->type, &max);
+    const char* format = _imgui_format_optarg(L, 7);
+
+    bool changed = edit.count > 0
+        && ImGui::SliderScalarN(label, edit.type, edit.data, (int)edit.count, p_min, p_max, format);
+    return _imgui_edit_end(L, &edit, changed);
+}
+
+/**
+ * @brief Spreadsheet editor of buffer elements, edited in place.
+ *
+ * Only visible rows are submitted.
+ *
+ * [1]: string id
+ * [2]: buffer
+ * [3]: integer columns, optional, default 8
+ * [4]: number height, optional, default 0 to fill available height
+ * [5]: string format, optional
+ * [6]: number speed, optional. Cells are drag widgets if set, otherwise input fields.
+ * Returns: integer first, integer last of changed elements, or nothing
+ */
+static int _imgui_buffer_grid(lua_State *L)
+{
+    const char* id = api->lua->L_checkstring(L, 1);
+    imgui_buffer_t* buf = _imgui_edit_check(L, 2);
+    int64_t columns = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 3) : 8;
+    float height = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 4) : 0.0f;
+    const char* format = _imgui_format_optarg(L, 5);
+    float speed = api->lua->type(L, 6) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 6) : 0.0f;
+    if (columns < 1 || columns > 63)
+    {
+        return api->lua->L_error(L, "columns %d out of range [1, 63]", (int)columns);
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+        | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchSame;
+    if (!ImGui::BeginTable(id, (int)columns + 1, flags, ImVec2(0.0f, height)))
+    {
+        return 0;
+    }
+
+    char name[32];
+    ImGui::TableSetupScrollFreeze(1, 1);
+    ImGui::TableSetupColumn("", ImGuiTableColumnFlags_WidthFixed);
+    for (int64_t c = 0; c < columns; c++)
+    {
+        snprintf(name, sizeof(name), "+%d", (int)c);
+        ImGui::TableSetupColumn(name);
+    }
+    ImGui::TableHeadersRow();
+
+    ImGuiDataType type = s_imgui_data_type[buf->type];
+    size_t rows = (buf->size + columns - 1) / columns;
+    size_t first = SIZE_MAX, last = 0;
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)rows);
+    while (clipper.Step())
+    {
+        for (size_t row = (size_t)clipper.DisplayStart; row < (size_t)clipper.DisplayEnd; row++)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            int len = snprintf(name, sizeof(name), "%d", (int)(row * columns + 1));
+            ImGui::TextUnformatted(name, name + len);
+
+            for (size_t idx = row * columns; idx < (row + 1) * columns && idx < buf->size; idx++)
+            {
+                ImGui::TableNextColumn();
+                ImGui::PushID((int)idx);
+                ImGui::SetNextItemWidth(-FLT_MIN);
+                bool changed = speed > 0 ?
+                    ImGui::DragScalar("##v", type, imgui_buffer_at(buf, idx), speed, NULL, NULL, format) :
+                    ImGui::InputScalar("##v", type, imgui_buffer_at(buf, idx), NULL, NULL, format);
+                ImGui::PopID();
+
+                if (changed)
+                {
+                    first = idx < first ? idx : first;
+                    last = idx > last ? idx : last;
+                }
+            }
+        }
+    }
+    ImGui::EndTable();
+
+    if (first == SIZE_MAX)
+    {
+        return 0;
+    }
+    buf->epoch++;
+    imgui_buffer_touch(buf);
+    api->lua->pushinteger(L, (int64_t)first + 1);
+    api->lua->pushinteger(L, (int64_t)last + 1);
+    return 2;
+}
+
 static int _imgui_spacing(lua_State *L)
 {
     (void)L;
@@ -478,6 +1162,135 @@ static int _imgui_unindent(lua_State *L)
     return 0;
 }
 
+/**
+ * @brief Key of hashed string ID cache.
+ */
+typedef struct imgui_id_key
+{
+    const char*     str;        /**< Address of Lua string. */
+    ImGuiID         seed;       /**< ID on top of stack when hashed. */
+
+    bool operator==(const imgui_id_key& other) const
+    {
+        return str == other.str && seed == other.seed;
+    }
+} imgui_id_key_t;
+
+struct imgui_id_key_hash
+{
+    size_t operator()(const imgui_id_key_t& key) const
+    {
+        return std::hash<const void*>()(key.str) ^ ((size_t)key.seed * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+/**
+ * @brief Hashed string IDs, keyed by Lua string address and ID seed.
+ *
+ * Short Lua strings are interned, so a repeated label has the same address
+ * and is hashed only once per seed. Cached strings are anchored in registry,
+ * so their address is not reused by another string while cached.
+ */
+static std::unordered_map<imgui_id_key_t, ImGuiID, imgui_id_key_hash> s_id_cache;
+
+/**
+ * @brief Entries before cache is dropped.
+ */
+#define IMGUI_ID_CACHE_MAX      16384
+
+/**
+ * @brief Get ID of string at \p idx, as ImGui::GetID() would do.
+ */
+static ImGuiID _imgui_string_id(lua_State* L, int idx)
+{
+    size_t len;
+    const char* str = api->lua->tolstring(L, idx, &len);
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    imgui_id_key_t key = { str, window->IDStack.back() };
+
+    auto it = s_id_cache.find(key);
+    if (it != s_id_cache.end())
+    {
+        return it->second;
+    }
+
+    bool drop = s_id_cache.size() >= IMGUI_ID_CACHE_MAX;
+    if (drop || api->lua->getfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_id_anchor") != AUTO_LUA_TTABLE)
+    {
+        if (!drop)
+        {
+            api->lua->pop(L, 1);
+        }
+        s_id_cache.clear();
+        api->lua->newtable(L);
+        api->lua->pushvalue(L, -1);
+        api->lua->setfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_id_anchor");
+    }
+    api->lua->pushvalue(L, idx);
+    api->lua->pushboolean(L, 1);
+    api->lua->settable(L, -3);
+    api->lua->pop(L, 1);
+
+    ImGuiID id = ImHashStr(str, len, key.seed);
+    s_id_cache[key] = id;
+    return id;
+}
+
+/**
+ * @brief Get ID of integer at \p idx, as ImGui::GetID() would do.
+ */
+static ImGuiID _imgui_integer_id(lua_State* L, int idx)
+{
+    int64_t v = api->lua->L_checkinteger(L, idx);
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    if (v >= INT_MIN && v <= INT_MAX)
+    {
+        int n = (int)v;
+        return ImHashData(&n, sizeof(n), window->IDStack.back());
+    }
+    return ImHashData(&v, sizeof(v), window->IDStack.back());
+}
+
+static ImGuiID _imgui_id_arg(lua_State* L, int idx)
+{
+    if (api->lua->type(L, idx) == AUTO_LUA_TNUMBER)
+    {
+        return _imgui_integer_id(L, idx);
+    }
+    api->lua->L_checklstring(L, idx, NULL);
+    return _imgui_string_id(L, idx);
+}
+
+/**
+ * @brief Push integer or string into ID stack.
+ *
+ * [1]: integer or string id
+ */
+static int _imgui_push_id(lua_State *L)
+{
+    ImGui::PushOverrideID(_imgui_id_arg(L, 1));
+    return 0;
+}
+
+static int _imgui_pop_id(lua_State *L)
+{
+    (void)L;
+    ImGui::PopID();
+    return 0;
+}
+
+/**
+ * @brief Get ID of integer or string in current ID scope.
+ *
+ * [1]: integer or string id
+ * Returns: integer
+ */
+static int _imgui_get_id(lua_State *L)
+{
+    api->lua->pushinteger(L, (int64_t)_imgui_id_arg(L, 1));
+    return 1;
+}
+
 static int _imgui_begin_group(lua_State *L)
 {
     (void)L;
@@ -538,6 +1351,189 @@ static int _imgui_get_frame_height(lua_State *L)
     return 1;
 }
 
+/**
+ * @brief Get quality governor state.
+ *
+ * @return  level, frame cost in milliseconds, frame budget in milliseconds,
+ *   and the number of level transitions.
+ */
+static int _imgui_get_quality(lua_State *L)
+{
+    imgui_governor_stats_t stats;
+    imgui_governor_stats(&stats);
+    api->lua->pushinteger(L, stats.level);
+    api->lua->pushnumber(L, stats.frame_ms);
+    api->lua->pushnumber(L, stats.budget_ms);
+    api->lua->pushinteger(L, (int64_t)stats.changes);
+    return 4;
+}
+
+/**
+ * @brief Capture next frame.
+ *
+ * [1]: string path to write PNG file, or function(pixels, width, height)
+ * [2]: function(path) called after file is written, optional
+ *
+ * Callbacks receive nil and error message on failure.
+ */
+static int _imgui_capture(lua_State *L)
+{
+    if (api->lua->type(L, 1) == AUTO_LUA_TFUNCTION)
+    {
+        api->lua->pushvalue(L, 1);
+        imgui_capture_request(NULL, api->lua->L_ref(L, AUTO_LUA_REGISTRYINDEX));
+        return 0;
+    }
+
+    const char* path = api->lua->L_checkstring(L, 1);
+    int ref = IMGUI_CAPTURE_NOREF;
+    if (api->lua->type(L, 2) == AUTO_LUA_TFUNCTION)
+    {
+        api->lua->pushvalue(L, 2);
+        ref = api->lua->L_ref(L, AUTO_LUA_REGISTRYINDEX);
+    }
+    imgui_capture_request(path, ref);
+    return 0;
+}
+
+/**
+ * @brief Start writing frames to a Y4M file.
+ *
+ * [1]: string path
+ * [2]: integer capture one frame out of every N frames, default 1
+ */
+static int _imgui_start_capture(lua_State *L)
+{
+    const char* path = api->lua->L_checkstring(L, 1);
+    int64_t every = api->lua->type(L, 2) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 2) : 1;
+
+    int ret = imgui_capture_stream_start(path, (int)every);
+    if (ret == EBUSY)
+    {
+        return api->lua->L_error(L, "capture is running or still writing");
+    }
+    if (ret != 0)
+    {
+        return api->lua->L_error(L, "open `%s` failed: %s", path, strerror(ret));
+    }
+    return 0;
+}
+
+/**
+ * @brief Stop writing frames. Queued frames are still written.
+ *
+ * @return  frames written, and frames dropped because window size changed.
+ */
+static int _imgui_stop_capture(lua_State *L)
+{
+    uint64_t written, dropped;
+    imgui_capture_stream_stop(&written, &dropped);
+    api->lua->pushinteger(L, (int64_t)written);
+    api->lua->pushinteger(L, (int64_t)dropped);
+    return 2;
+}
+
+/**
+ * @brief Get memory accounting of ImGui and ImPlot.
+ *
+ * @return  live bytes, peak live bytes, bytes reserved by allocator,
+ *   allocations in last frame and bytes allocated in last frame.
+ */
+static int _imgui_get_memory_stats(lua_State *L)
+{
+    imgui_alloc_stats_t stats;
+    imgui_alloc_stats(&stats);
+    api->lua->pushinteger(L, (int64_t)stats.live);
+    api->lua->pushinteger(L, (int64_t)stats.peak);
+    api->lua->pushinteger(L, (int64_t)stats.reserved);
+    api->lua->pushinteger(L, (int64_t)stats.frame_allocs);
+    api->lua->pushinteger(L, (int64_t)stats.frame_bytes);
+    return 5;
+}
+
+/**
+ * @brief Free transient buffers of windows that are not visible, and
+ *   release idle pool chunks.
+ *
+ * @return  bytes released by allocator.
+ */
+static int _imgui_compact_memory(lua_State *L)
+{
+    ImGuiContext& g = *GImGui;
+    for (int i = 0; i < g.Windows.Size; i++)
+    {
+        ImGuiWindow* window = g.Windows[i];
+        if (!window->Active && !window->WasActive && !window->MemoryCompacted)
+        {
+            ImGui::GcCompactTransientWindowBuffers(window);
+        }
+    }
+
+    api->lua->pushinteger(L, (int64_t)imgui_alloc_trim());
+    return 1;
+}
+
+/**
+ * @brief Get the number of frames presented again because user function
+ *   missed frame deadline.
+ *
+ * @return  skipped frames before current frame, and skipped frames since
+ *   loop started.
+ */
+static int _imgui_get_skipped_frames(lua_State *L)
+{
+    api->lua->pushinteger(L, (int64_t)s_skipped.last);
+    api->lua->pushinteger(L, (int64_t)s_skipped.total);
+    return 2;
+}
+
+/**
+ * @brief Pin quality level, or let governor adapt if level is nil.
+ *
+ * [1]: integer level, optional
+ */
+static int _imgui_set_quality(lua_State *L)
+{
+    if (api->lua->type(L, 1) <= AUTO_LUA_TNIL)
+    {
+        imgui_governor_pin(-1);
+        return 0;
+    }
+
+    int64_t level = api->lua->L_checkinteger(L, 1);
+    if (level < 0 || level > IMGUI_GOVERNOR_LEVEL_MAX)
+    {
+        return api->lua->L_error(L, "level %d out of range [0, %d]", (int)level, IMGUI_GOVERNOR_LEVEL_MAX);
+    }
+    imgui_governor_pin((int)level);
+    return 0;
+}
+
+/**
+ * @brief Begin a trace zone.
+ *
+ * [1]: string name
+ */
+static int _imgui_zone_begin(lua_State *L)
+{
+    if (imgui_trace_active.load(std::memory_order_relaxed))
+    {
+        const char* name = api->lua->L_checkstring(L, 1);
+        imgui_trace_event('B', imgui_trace_intern(name), 0, 0);
+    }
+    return 0;
+}
+
+/**
+ * @brief End last trace zone.
+ */
+static int _imgui_zone_end(lua_State *L)
+{
+    (void)L;
+    IMGUI_TRACE_END();
+    return 0;
+}
+
 static int _imgui_options(lua_State* L, int idx, imgui_ctx_t* gui)
 {
     if (api->lua->getfield(L, idx, "window_size") == AUTO_LUA_TSTRING)
@@ -546,6 +1542,49 @@ static int _imgui_options(lua_State* L, int idx, imgui_ctx_t* gui)
     }
     api->lua->pop(L, 1);
 
+    if (api->lua->getfield(L, idx, "window_hidden") == AUTO_LUA_TBOOLEAN)
+    {
+        gui->window.hidden = api->lua->toboolean(L, -1);
+    }
+    api->lua->pop(L, 1);
+
+    if (api->lua->getfield(L, idx, "governor") == AUTO_LUA_TBOOLEAN)
+    {
+        imgui_governor_enable(api->lua->toboolean(L, -1));
+    }
+    api->lua->pop(L, 1);
+
+    if (api->lua->getfield(L, idx, "allocator") == AUTO_LUA_TSTRING)
+    {
+        const char* allocator = api->lua->tostring(L, -1);
+        if (strcmp(allocator, "system") == 0)
+        {
+            gui->allocator = IMGUI_ALLOC_SYSTEM;
+        }
+        else if (strcmp(allocator, "autodo") == 0)
+        {
+            gui->allocator = IMGUI_ALLOC_AUTODO;
+        }
+        else
+        {
+            gui->allocator = IMGUI_ALLOC_POOL;
+        }
+    }
+    api->lua->pop(L, 1);
+
+    if (api->lua->getfield(L, idx, "memory_compact_timer") == AUTO_LUA_TNUMBER)
+    {
+        gui->compact_timer = (float)api->lua->tonumber(L, -1);
+    }
+    api->lua->pop(L, 1);
+
+    if (api->lua->getfield(L, idx, "frame_deadline") == AUTO_LUA_TNUMBER)
+    {
+        double deadline = api->lua->tonumber(L, -1);
+        gui->frame_deadline = deadline > 0 ? (uint64_t)(deadline * 1000 * 1000) : 0;
+    }
+    api->lua->pop(L, 1);
+
     if (api->lua->getfield(L, idx, "window_title") == AUTO_LUA_TSTRING)
     {
         if (gui->window.title != NULL)
@@ -561,7 +1600,8 @@ static int _imgui_options(lua_State* L, int idx, imgui_ctx_t* gui)
 
 static void _imgui_initialize_to_default(lua_State* L, imgui_ctx_t* gui)
 {
-    gui->sem = api->sem->create(0);
+    gui->sync = new imgui_frame_sync;
+    gui->sync->done = false;
     gui->nfy_gui_update = api->notify->create(L, _on_gui_update, gui);
     gui->looping = 1;
     gui->fps = 30;
@@ -569,6 +1609,11 @@ static void _imgui_initialize_to_default(lua_State* L, imgui_ctx_t* gui)
     gui->window.title = strdup("ImGui");
     gui->window.x = 1280;
     gui->window.y = 720;
+    gui->allocator = IMGUI_ALLOC_POOL;
+    gui->compact_timer = 60.0f;
+    imgui_governor_enable(0);
+    s_skipped.last = 0;
+    s_skipped.total = 0;
 }
 
 static int _imgui_loop_after(struct lua_State* L, int status, void* ctx)
@@ -617,15 +1662,22 @@ static int _luaopen_imgui(lua_State *L)
 {
     static const auto_luaL_Reg s_imgui_method[] = {
         { "loop",                       _imgui_loop },
+        { "packed",                     imgui_packed_new },
+        { "zone_begin",                 _imgui_zone_begin },
+        { "zone_end",                   _imgui_zone_end },
         { "AlignTextToFramePadding",    _imgui_align_text_to_frame_padding },
         { "Begin",                      _imgui_begin },
         { "BeginChild",                 _imgui_begin_child },
         { "BeginGroup",                 _imgui_begin_group },
         { "BeginMenu",                  _imgui_begin_menu },
         { "BeginMenuBar",               _imgui_begin_menu_bar },
+        { "BufferGrid",                 _imgui_buffer_grid },
         { "BulletText",                 _imgui_bullet_text },
         { "Button",                     _imgui_button },
+        { "Capture",                    _imgui_capture },
         { "CheckBox",                   _imgui_checkbox },
+        { "CompactMemory",              _imgui_compact_memory },
+        { "DragScalarN",                _imgui_drag_scalar_n },
         { "Dummy",                      _imgui_dummy },
         { "End",                        _imgui_end },
         { "EndChild",                   _imgui_end_child },
@@ -635,27 +1687,42 @@ static int _luaopen_imgui(lua_State *L)
         { "GetCursorPos",               _imgui_get_cursor_pos },
         { "GetCursorScreenPos",         _imgui_get_cursor_screen_pos },
         { "GetFrameHeight",             _imgui_get_frame_height },
+        { "GetID",                      _imgui_get_id },
+        { "GetMemoryStats",             _imgui_get_memory_stats },
+        { "GetQuality",                 _imgui_get_quality },
+        { "GetSkippedFrames",           _imgui_get_skipped_frames },
         { "GetTextLineHeight",          _imgui_get_text_line_height },
         { "GetWindowPos",               _imgui_get_window_pos },
         { "GetWindowSize",              _imgui_get_window_size },
         { "Indent",                     _imgui_indent },
+        { "InputScalarN",               _imgui_input_scalar_n },
         { "InputText",                  _imgui_input_text },
+        { "LabelValue",                 _imgui_label_value },
         { "NewLine",                    _imgui_new_line },
         { "MenuItem",                   _imgui_menu_item },
         { "PlotLines",                  _imgui_plot_lines },
+        { "PopID",                      _imgui_pop_id },
+        { "PushID",                     _imgui_push_id },
         { "SameLine",                   _imgui_same_line },
         { "Separator",                  _imgui_separator },
         { "SetCursorPos",               _imgui_set_cursor_pos },
         { "SetNextWindowFocus",         _imgui_set_next_window_focus },
         { "SetNextWindowPos",           _imgui_set_next_window_pos },
         { "SetNextWindowSize",          _imgui_set_next_window_size },
+        { "SetQuality",                 _imgui_set_quality },
         { "ShowDemoWindow",             _imgui_show_demo_window },
         { "ShowMetricsWindow",          _imgui_show_metrics_window },
         { "ShowStackToolWindow",        _imgui_show_stack_tool_window },
         { "SliderFloat",                _imgui_slider_float },
+        { "SliderScalarN",              _imgui_slider_scalar_n },
         { "Spacing",                    _imgui_spacing },
+        { "StartCapture",               _imgui_start_capture },
+        { "StopCapture",                _imgui_stop_capture },
         { "Text",                       _imgui_text },
         { "TextColored",                _imgui_text_colored },
+        { "TextF",                      _imgui_text_f },
+        { "TreeNode",                   _imgui_tree_node },
+        { "TreePop",                    _imgui_tree_pop },
         { "Unindent",                   _imgui_unindent },
         { NULL,                         NULL },
     };
@@ -689,15 +1756,88 @@ static int _luaopen_imgui(lua_State *L)
     return 1;
 }
 
+static int _imgui_module_gc(lua_State *L)
+{
+    (void)L;
+    s_id_cache.clear();
+    imgui_implot_cache_clear();
+    imgui_pool_exit();
+    return 0;
+}
+
+/**
+ * @brief Anchor a sentinel in registry, so module resources are released when
+ *   the Lua VM is closed.
+ */
+static void _imgui_module_sentinel(lua_State *L)
+{
+    static const auto_luaL_Reg s_module_meta[] = {
+        { "__gc",       _imgui_module_gc },
+        { NULL,         NULL },
+    };
+
+    if (api->lua->getfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_module") != AUTO_LUA_TNIL)
+    {
+        api->lua->pop(L, 1);
+        return;
+    }
+    api->lua->pop(L, 1);
+
+    api->lua->newuserdatauv(L, 1, 0);
+    if (api->lua->L_newmetatable(L, "__atd_imgui_module_meta") != 0)
+    {
+        api->lua->L_setfuncs(L, s_module_meta, 0);
+    }
+    api->lua->setmetatable(L, -2);
+    api->lua->setfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_module");
+}
+
 int luaopen_imgui(lua_State *L)
 {
     /* Get API */
     api = auto_api();
 
+    _imgui_module_sentinel(L);
     _luaopen_imgui(L);
 
+    imgui_luaopen_buffer(L);
+    api->lua->setfield(L, -2, "buffer");
+
+    imgui_luaopen_dataset(L);
+    api->lua->setfield(L, -2, "dataset");
+
+    imgui_luaopen_derive(L);
+    api->lua->setfield(L, -2, "derive");
+
+    imgui_luaopen_filter(L);
+    api->lua->setfield(L, -2, "filter");
+
     imgui_luaopen_implot(L);
     api->lua->setfield(L, -2, "implot");
 
+    imgui_luaopen_playback(L);
+    api->lua->setfield(L, -2, "playback");
+
+    imgui_luaopen_profiler(L);
+    api->lua->setfield(L, -2, "profiler");
+
+    imgui_luaopen_stats(L);
+    api->lua->setfield(L, -2, "stats");
+
+    imgui_luaopen_store(L);
+    api->lua->setfield(L, -2, "store");
+
+    imgui_luaopen_table(L);
+    api->lua->setfield(L, -2, "table");
+
+    imgui_luaopen_timeseries(L);
+    api->lua->setfield(L, -2, "timeseries");
+
+    imgui_luaopen_trace(L);
+    api->lua->setfield(L, -2, "trace");
+
+    imgui_luaopen_tree(L);
+    api->lua->setfield(L, -2, "tree");
+
     return 1;
 }
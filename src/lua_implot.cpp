@@ -1,7 +1,356 @@
 #include "lua_implot.h"
 #include "lua_imgui.h"
+#include "buffer.hpp"
+#include "buffer_spill.hpp"
+#include "governor.hpp"
+#include "implot_cache.hpp"
+#include "implot_heatmap.hpp"
+#include "implot_parallel.hpp"
+#include "implot_static.hpp"
+#include "series.hpp"
+#include "stats.hpp"
+#include "timeseries.hpp"
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 #include <implot.h>
+#include <implot_internal.h>
+
+/**
+ * @brief Series arguments of a plot item, and how they are submitted to ImPlot.
+ */
+typedef struct imgui_implot_args
+{
+    imgui_series_t          xs;         /**< X series, only valid if #has_x. */
+    imgui_series_t          ys;         /**< Y series. */
+    bool                    has_x;      /**< Whether X is given, otherwise X is element index. */
+    size_t                  base;       /**< X of element 0 if X is element index. */
+    size_t                  beg;        /**< First visible element. */
+    size_t                  end;        /**< One past last visible element. */
+    imgui_implot_capture_t  cap;
+
+    /* ImPlot requires X and Y share the same type and layout */
+    imgui_dtype_t           type;
+    const void*             x_data;
+    const void*             y_data;
+    int                     count;
+    int                     offset;
+    int                     stride;
+    double                  xscale;     /**< X step between submitted elements if X is element index. */
+    double*                 scratch;    /**< Visible slice converted into double. */
+} imgui_implot_args_t;
+
+/**
+ * @brief Get address of element \p idx.
+ */
+static const void* _implot_series_at(const imgui_series_t* series, size_t idx)
+{
+    return (const char*)series->data + idx * series->stride;
+}
+
+/**
+ * @brief Get value of element \p idx, with ring offset applied.
+ *
+ * Only the element is made readable, so binary search on a lazily converted
+ * series only convert what it touches.
+ */
+static double _implot_series_value(imgui_series_t* series, size_t idx)
+{
+    imgui_series_prepare(series, idx, idx + 1);
+    return imgui_series_get(series, (idx + series->offset) % series->count);
+}
+
+/**
+ * @brief Get the range of element index in X limits, plus one element of
+ *   margin on each side.
+ */
+static void _implot_index_range(const ImPlotRect& limits, size_t count, size_t* beg, size_t* end)
+{
+    double lo = floor(limits.X.Min) - 1;
+    double hi = ceil(limits.X.Max) + 2;
+    *beg = lo <= 0 ? 0 : (lo >= (double)count ? count : (size_t)lo);
+    *end = hi <= 0 ? 0 : (hi >= (double)count ? count : (size_t)hi);
+    *end = *end < *beg ? *beg : *end;
+}
+
+/**
+ * @brief Get the range of implicit x index that is visible in current plot.
+ *
+ * Native series only submit visible elements (plus one element of margin on
+ * each side), so memory mapped data only touch what is on screen. The whole
+ * series is submitted when the plot is fitting its axes.
+ *
+ * @param[in] series    Series view.
+ * @param[out] beg      First visible element.
+ * @param[out] end      One past last visible element.
+ */
+static void _implot_visible_range(const imgui_series_t* series, size_t* beg, size_t* end)
+{
+    *beg = 0;
+    *end = series->count;
+
+    /* Lua table is always fully converted, and ring buffer wraps around */
+    if (series->vtbl == NULL || series->offset != 0)
+    {
+        return;
+    }
+
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    if (plot->Axes[plot->CurrentX].FitThisFrame || plot->Axes[plot->CurrentY].FitThisFrame)
+    {
+        return;
+    }
+
+    _implot_index_range(limits, series->count, beg, end);
+}
+
+/**
+ * @brief Get the range of elements whose X is visible in current plot.
+ *
+ * If \p xs is sorted, the visible range is found by binary search, plus one
+ * element of margin on each side. Otherwise the whole series is visible.
+ *
+ * @param[in] xs        X series.
+ * @param[in] count     The number of elements.
+ * @param[in] sorted    Whether caller promise \p xs is sorted.
+ * @param[out] beg      First visible element.
+ * @param[out] end      One past last visible element.
+ */
+static void _implot_visible_range_xy(imgui_series_t* xs, size_t count, bool sorted,
+    size_t* beg, size_t* end)
+{
+    *beg = 0;
+    *end = count;
+
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    if (count == 0 || plot->Axes[plot->CurrentX].FitThisFrame || plot->Axes[plot->CurrentY].FitThisFrame)
+    {
+        return;
+    }
+
+    if (!sorted)
+    {
+        imgui_series_prepare(xs, 0, count);
+        if (!imgui_stats_sorted(xs))
+        {
+            return;
+        }
+    }
+
+    /* First element not less than minimum */
+    size_t lo = 0, hi = count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (_implot_series_value(xs, mid) < limits.X.Min) lo = mid + 1; else hi = mid;
+    }
+    *beg = lo > 0 ? lo - 1 : 0;
+
+    /* First element greater than maximum */
+    hi = count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (_implot_series_value(xs, mid) <= limits.X.Max) lo = mid + 1; else hi = mid;
+    }
+    *end = lo < count ? lo + 1 : count;
+}
+
+/**
+ * @brief Decode visible window of a time series.
+ *
+ * Only blocks overlapping X limits are decoded. When fitting, the bounds of
+ * all samples are fitted directly instead of decoding the whole history.
+ */
+static void _implot_timeseries_window(const char* label_id, imgui_timeseries_t* ts,
+    imgui_implot_args_t* args)
+{
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    ImPlotItem* item = ImPlot::GetItem(label_id);
+    bool fit = plot->Axes[plot->CurrentX].FitThisFrame || plot->Axes[plot->CurrentY].FitThisFrame;
+
+    if (fit && ts->size != 0 && (item == NULL || item->Show))
+    {
+        double t_first, t_last, v_min, v_max;
+        imgui_timeseries_bounds(ts, &t_first, &t_last, &v_min, &v_max);
+        ImPlot::FitPoint(ImPlotPoint(t_first, v_min));
+        ImPlot::FitPoint(ImPlotPoint(t_last, v_max));
+    }
+
+    imgui_timeseries_window(ts, limits.X.Min, limits.X.Max, &args->xs, &args->ys);
+    args->beg = 0;
+    args->end = args->xs.count;
+}
+
+/**
+ * @brief Read visible window of a buffer that spills to file.
+ *
+ * The whole history is one series, old elements are read back from file.
+ * When fitting, the stored bounds are fitted directly.
+ */
+static void _implot_spill_window(const char* label_id, imgui_buffer_t* buf, imgui_implot_args_t* args)
+{
+    ImPlotRect limits = ImPlot::GetPlotLimits();
+    ImPlotPlot* plot = ImPlot::GetCurrentPlot();
+    ImPlotItem* item = ImPlot::GetItem(label_id);
+    bool fit = plot->Axes[plot->CurrentX].FitThisFrame || plot->Axes[plot->CurrentY].FitThisFrame;
+
+    size_t total, spilled, beg, end;
+    double v_min, v_max;
+    imgui_buffer_spill_bounds(buf, &total, &spilled, &v_min, &v_max);
+    if (fit && total != 0 && (item == NULL || item->Show))
+    {
+        ImPlot::FitPoint(ImPlotPoint(0, v_min));
+        ImPlot::FitPoint(ImPlotPoint((double)(total - 1), v_max));
+    }
+
+    _implot_index_range(limits, total, &beg, &end);
+    imgui_buffer_window(buf, beg, end, &args->ys);
+    args->base = beg;
+    args->beg = 0;
+    args->end = args->ys.count;
+}
+
+/**
+ * @brief Decide how visible elements are passed to ImPlot.
+ */
+static void _implot_layout(imgui_implot_args_t* args)
+{
+    size_t n = args->end - args->beg;
+    args->count = (int)n;
+    args->xscale = 1.0;
+
+    if (!args->has_x)
+    {
+        args->type = args->ys.type;
+        args->y_data = _implot_series_at(&args->ys, args->beg);
+        args->offset = (int)args->ys.offset;
+        args->stride = (int)args->ys.stride;
+        return;
+    }
+
+    if (args->xs.type == args->ys.type && args->xs.stride == args->ys.stride
+        && args->xs.offset == 0 && args->ys.offset == 0)
+    {
+        args->type = args->ys.type;
+        args->x_data = _implot_series_at(&args->xs, args->beg);
+        args->y_data = _implot_series_at(&args->ys, args->beg);
+        args->offset = 0;
+        args->stride = (int)args->ys.stride;
+        return;
+    }
+
+    /* Different layout, copy visible slice */
+    args->scratch = (double*)malloc(sizeof(double) * (n ? n : 1) * 2);
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t idx = args->beg + i;
+        args->scratch[i] = imgui_series_get(&args->xs, (idx + args->xs.offset) % args->xs.count);
+        args->scratch[n + i] = imgui_series_get(&args->ys, (idx + args->ys.offset) % args->ys.count);
+    }
+    args->type = IMGUI_DTYPE_F64;
+    args->x_data = args->scratch;
+    args->y_data = args->scratch + n;
+    args->offset = 0;
+    args->stride = sizeof(double);
+}
+
+/**
+ * @brief Submit every Nth element when governor asks for it.
+ *
+ * Ring offset is applied by ImPlot with modulo on element count, so wrapped
+ * series are submitted as is.
+ */
+static void _implot_downsample(imgui_implot_args_t* args)
+{
+    int factor = imgui_governor_downsample();
+    if (factor <= 1 || args->offset != 0 || args->count <= factor)
+    {
+        return;
+    }
+
+    args->count = (args->count + factor - 1) / factor;
+    args->stride *= factor;
+    args->xscale = factor;
+}
+
+/**
+ * @brief Convert series arguments, and replay cached geometry of item if
+ *   nothing changed.
+ *
+ * Arguments start from index 2, and are either `values`, or `xs, ys, [sorted]`
+ * or a time series if \p xy is set.
+ *
+ * @return  true if item is drawn from cache. Otherwise visible range is
+ *   readable, and caller must draw the item and call #_implot_end_series().
+ */
+static bool _implot_begin_series(lua_State* L, const char* label_id,
+    imgui_implot_cache_kind_t kind, bool xy, imgui_implot_args_t* args)
+{
+    memset(args, 0, sizeof(*args));
+    imgui_timeseries_t* ts = xy ? imgui_timeseries_test(L, 2) : NULL;
+    imgui_buffer_t* spill = NULL;
+    args->has_x = xy && (ts != NULL || api->lua->type(L, 3) == AUTO_LUA_TTABLE
+        || api->lua->type(L, 3) == AUTO_LUA_TSTRING || imgui_series_test(L, 3) != NULL);
+
+    if (ts != NULL)
+    {
+        _implot_timeseries_window(label_id, ts, args);
+    }
+    else if (args->has_x)
+    {
+        imgui_series_argcheck(L, 2);
+        imgui_series_argcheck(L, 3);
+        imgui_series_check(L, 2, &args->xs);
+        imgui_series_check(L, 3, &args->ys);
+        size_t count = args->xs.count < args->ys.count ? args->xs.count : args->ys.count;
+        _implot_visible_range_xy(&args->xs, count, api->lua->toboolean(L, 4) != 0, &args->beg, &args->end);
+    }
+    else if ((spill = imgui_buffer_test_spill(L, 2)) != NULL)
+    {
+        _implot_spill_window(label_id, spill, args);
+    }
+    else
+    {
+        imgui_series_check(L, 2, &args->ys);
+        _implot_visible_range(&args->ys, &args->beg, &args->end);
+    }
+
+    if (imgui_implot_cache_replay(&args->cap, label_id, kind, args->has_x ? &args->xs : NULL,
+        &args->ys, args->beg, args->end))
+    {
+        imgui_series_release(&args->xs);
+        imgui_series_release(&args->ys);
+        return true;
+    }
+
+    imgui_series_prepare(&args->ys, args->beg, args->end);
+    if (args->has_x)
+    {
+        imgui_series_prepare(&args->xs, args->beg, args->end);
+    }
+    _implot_layout(args);
+    if (kind != IMGUI_IMPLOT_CACHE_BARS)
+    {
+        _implot_downsample(args);
+    }
+    return false;
+}
+
+/**
+ * @brief Store geometry of item and release series.
+ */
+static void _implot_end_series(imgui_implot_args_t* args)
+{
+    imgui_implot_cache_store(&args->cap);
+    imgui_series_release(&args->xs);
+    imgui_series_release(&args->ys);
+    free(args->scratch);
+}
 
 static int _implot_begin_plot(lua_State *L)
 {
@@ -21,39 +370,43 @@ static int _implot_end_plot(lua_State *L)
 static int _implot_plot_bars(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
-
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
 
-    api->lua->pushnil(L);
-    for (size_t i; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_BARS, false, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotBars(label_id, values, len);
+    IMGUI_DTYPE_DISPATCH(args.type, T,
+        ImPlot::PlotBars(label_id, (const T*)args.y_data, args.count,
+            0.67, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    _implot_end_series(&args);
+
     return 0;
 }
 
 static int _implot_plot_line(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
-
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
 
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_LINE, true, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotLine(label_id, values, len);
-    free(values);
+    if (!imgui_implot_parallel_line(label_id, args.has_x ? &args.xs : NULL, &args.ys,
+        (double)args.base, args.beg, args.end))
+    {
+        IMGUI_DTYPE_DISPATCH(args.type, T,
+            if (args.has_x)
+                ImPlot::PlotLine(label_id, (const T*)args.x_data, (const T*)args.y_data, args.count,
+                    0, args.offset, args.stride);
+            else
+                ImPlot::PlotLine(label_id, (const T*)args.y_data, args.count,
+                    args.xscale, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    }
+    _implot_end_series(&args);
 
     return 0;
 }
@@ -61,20 +414,25 @@ static int _implot_plot_line(lua_State *L)
 static int _implot_plot_scatter(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
 
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
-
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_SCATTER, true, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotScatter(label_id, values, len);
-    free(values);
+    if (!imgui_implot_parallel_scatter(label_id, args.has_x ? &args.xs : NULL, &args.ys,
+        (double)args.base, args.beg, args.end))
+    {
+        IMGUI_DTYPE_DISPATCH(args.type, T,
+            if (args.has_x)
+                ImPlot::PlotScatter(label_id, (const T*)args.x_data, (const T*)args.y_data, args.count,
+                    0, args.offset, args.stride);
+            else
+                ImPlot::PlotScatter(label_id, (const T*)args.y_data, args.count,
+                    args.xscale, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    }
+    _implot_end_series(&args);
 
     return 0;
 }
@@ -82,20 +440,21 @@ static int _implot_plot_scatter(lua_State *L)
 static int _implot_plot_stairs(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
-
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
 
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_STAIRS, true, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotStairs(label_id, values, len);
-    free(values);
+    IMGUI_DTYPE_DISPATCH(args.type, T,
+        if (args.has_x)
+            ImPlot::PlotStairs(label_id, (const T*)args.x_data, (const T*)args.y_data, args.count,
+                0, args.offset, args.stride);
+        else
+            ImPlot::PlotStairs(label_id, (const T*)args.y_data, args.count,
+                args.xscale, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    _implot_end_series(&args);
 
     return 0;
 }
@@ -103,20 +462,21 @@ static int _implot_plot_stairs(lua_State *L)
 static int _implot_plot_shaded(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
 
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
-
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_SHADED, true, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotShaded(label_id, values, len);
-    free(values);
+    IMGUI_DTYPE_DISPATCH(args.type, T,
+        if (args.has_x)
+            ImPlot::PlotShaded(label_id, (const T*)args.x_data, (const T*)args.y_data, args.count,
+                0.0, 0, args.offset, args.stride);
+        else
+            ImPlot::PlotShaded(label_id, (const T*)args.y_data, args.count,
+                0.0, args.xscale, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    _implot_end_series(&args);
 
     return 0;
 }
@@ -124,20 +484,17 @@ static int _implot_plot_shaded(lua_State *L)
 static int _implot_plot_stems(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
-
-    size_t len = api->lua->L_len(L, 2);
-    double* values = (double*)malloc(sizeof(double) * len);
 
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_implot_args_t args;
+    if (_implot_begin_series(L, label_id, IMGUI_IMPLOT_CACHE_STEMS, false, &args))
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        return 0;
     }
 
-    ImPlot::PlotStems(label_id, values, len);
-    free(values);
+    IMGUI_DTYPE_DISPATCH(args.type, T,
+        ImPlot::PlotStems(label_id, (const T*)args.y_data, args.count,
+            0.0, args.xscale, (double)(args.base + args.beg), 0, args.offset, args.stride));
+    _implot_end_series(&args);
 
     return 0;
 }
@@ -145,44 +502,161 @@ static int _implot_plot_stems(lua_State *L)
 static int _implot_plot_heatmap(lua_State *L)
 {
     const char* label_id = api->lua->L_checklstring(L, 1, NULL);
-    api->lua->L_checktype(L, 2, AUTO_LUA_TTABLE);
     int rows = api->lua->tonumber(L, 3);
     int cols = api->lua->tonumber(L, 4);
 
-    int len = api->lua->L_len(L, 2);
-    if (len != (rows * cols))
+    imgui_series_t values;
+    imgui_series_check(L, 2, &values);
+
+    if (values.count != (size_t)rows * cols)
+    {
+        imgui_series_release(&values);
+        return api->lua->L_error(L, "table size(%d) not match with rows*cols(%d)", (int)values.count, rows * cols);
+    }
+    if (values.offset != 0 || values.stride != imgui_dtype_size(values.type))
+    {
+        imgui_series_release(&values);
+        return api->lua->L_error(L, "heatmap require contiguous series");
+    }
+    imgui_series_prepare(&values, 0, values.count);
+
+    IMGUI_DTYPE_DISPATCH(values.type, T,
+        ImPlot::PlotHeatmap(label_id, (const T*)values.data, rows, cols));
+    imgui_series_release(&values);
+
+    return 0;
+}
+
+/**
+ * @brief Plot histogram.
+ *
+ * [1]: string label_id
+ * [2]: table or native series
+ * [3]: integer bins, optional. Default by Sturges' rule.
+ * [4]: number range minimum, optional. Default is minimum value.
+ * [5]: number range maximum, optional. Default is maximum value.
+ */
+static int _implot_plot_histogram(lua_State *L)
+{
+    const char* label_id = api->lua->L_checklstring(L, 1, NULL);
+
+    imgui_series_t values;
+    imgui_series_check(L, 2, &values);
+    imgui_series_prepare(&values, 0, values.count);
+
+    imgui_stats_t stats;
+    imgui_stats_summary(&values, &stats);
+
+    int64_t bins = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ?
+        api->lua->tointeger(L, 3) : (int64_t)imgui_stats_sturges(values.count);
+    double lo = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 4) : stats.min;
+    double hi = api->lua->type(L, 5) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 5) : stats.max;
+    if (bins <= 0 || bins > IMGUI_STATS_BINS_MAX)
+    {
+        imgui_series_release(&values);
+        return api->lua->L_error(L, "invalid bins %f, expect 1 to %d", (double)bins, IMGUI_STATS_BINS_MAX);
+    }
+
+    std::vector<double> xs(bins), counts(bins);
+    imgui_stats_histogram(&values, lo, hi, (size_t)bins, counts.data());
+    imgui_series_release(&values);
+
+    double width = hi > lo ? (hi - lo) / bins : 1.0;
+    for (int64_t i = 0; i < bins; i++)
     {
-        return api->lua->L_error(L, "table size(%d) not match with rows*cols(%d)", len, rows * cols);
+        xs[i] = lo + (i + 0.5) * width;
     }
+    ImPlot::PlotBars(label_id, xs.data(), counts.data(), (int)bins, width);
+
+    return 0;
+}
 
-    double* values = (double*)malloc(sizeof(double) * len);
+/**
+ * @brief Plot 2D histogram as heatmap.
+ *
+ * [1]: string label_id
+ * [2]: table or native series of X
+ * [3]: table or native series of Y
+ * [4]: integer x_bins, optional. Default by Sturges' rule.
+ * [5]: integer y_bins, optional. Default by Sturges' rule.
+ */
+static int _implot_plot_histogram2d(lua_State *L)
+{
+    const char* label_id = api->lua->L_checklstring(L, 1, NULL);
 
-    api->lua->pushnil(L);
-    for (size_t i = 0; api->lua->next(L, 2) != 0; i++)
+    imgui_series_t xs, ys;
+    imgui_series_argcheck(L, 2);
+    imgui_series_argcheck(L, 3);
+    imgui_series_check(L, 2, &xs);
+    imgui_series_check(L, 3, &ys);
+    imgui_series_prepare(&xs, 0, xs.count);
+    imgui_series_prepare(&ys, 0, ys.count);
+
+    size_t count = xs.count < ys.count ? xs.count : ys.count;
+    int64_t x_bins = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ?
+        api->lua->tointeger(L, 4) : (int64_t)imgui_stats_sturges(count);
+    int64_t y_bins = api->lua->type(L, 5) == AUTO_LUA_TNUMBER ?
+        api->lua->tointeger(L, 5) : (int64_t)imgui_stats_sturges(count);
+    /* Check each side first, so the product cannot overflow */
+    if (x_bins <= 0 || y_bins <= 0 || x_bins > IMGUI_STATS_BINS_MAX || y_bins > IMGUI_STATS_BINS_MAX
+        || x_bins * y_bins > IMGUI_STATS_BINS_MAX)
     {
-        values[i] = api->lua->tonumber(L, -1);
-        api->lua->pop(L, 1);
+        imgui_series_release(&xs);
+        imgui_series_release(&ys);
+        return api->lua->L_error(L, "invalid bins %fx%f, expect 1 to %d cells",
+            (double)x_bins, (double)y_bins, IMGUI_STATS_BINS_MAX);
     }
 
-    ImPlot::PlotHeatmap(label_id, values, rows, cols);
-    free(values);
+    imgui_stats_t x_stats, y_stats;
+    imgui_stats_summary(&xs, &x_stats);
+    imgui_stats_summary(&ys, &y_stats);
+
+    std::vector<double> counts(x_bins * y_bins);
+    imgui_stats_histogram2d(&xs, &ys, x_stats.min, x_stats.max, (size_t)x_bins,
+        y_stats.min, y_stats.max, (size_t)y_bins, counts.data());
+    imgui_series_release(&xs);
+    imgui_series_release(&ys);
+
+    ImPlot::PlotHeatmap(label_id, counts.data(), (int)y_bins, (int)x_bins, 0, 0, NULL,
+        ImPlotPoint(x_stats.min, y_stats.min), ImPlotPoint(x_stats.max, y_stats.max));
 
     return 0;
 }
 
+/**
+ * @brief Get geometry cache statistics.
+ *
+ * Returns: integer hits, integer misses, integer bytes
+ */
+static int _implot_get_cache_stats(lua_State *L)
+{
+    uint64_t hits, misses; size_t bytes;
+    imgui_implot_cache_stats(&hits, &misses, &bytes);
+
+    api->lua->pushinteger(L, (int64_t)hits);
+    api->lua->pushinteger(L, (int64_t)misses);
+    api->lua->pushinteger(L, (int64_t)bytes);
+    return 3;
+}
+
 int imgui_luaopen_implot(lua_State *L)
 {
     static const auto_luaL_Reg s_implot_method[] = {
-        { "BeginPlot",      _implot_begin_plot },
-        { "EndPlot",        _implot_end_plot },
-        { "PlotBars",       _implot_plot_bars },
-        { "PlotHeatmap",    _implot_plot_heatmap },
-        { "PlotLine",       _implot_plot_line },
-        { "PlotScatter",    _implot_plot_scatter },
-        { "PlotShaded",     _implot_plot_shaded },
-        { "PlotStairs",     _implot_plot_stairs },
-        { "PlotStems",      _implot_plot_stems },
-        { NULL,             NULL },
+        { "BeginPlot",            _implot_begin_plot },
+        { "EndPlot",              _implot_end_plot },
+        { "GetCacheStats",        _implot_get_cache_stats },
+        { "PlotBars",             _implot_plot_bars },
+        { "PlotHeatmap",          _implot_plot_heatmap },
+        { "PlotHeatmapTexture",   imgui_implot_plot_heatmap_texture },
+        { "PlotHistogram",        _implot_plot_histogram },
+        { "PlotHistogram2D",      _implot_plot_histogram2d },
+        { "PlotLine",             _implot_plot_line },
+        { "PlotLineStatic",       imgui_implot_plot_line_static },
+        { "PlotScatter",          _implot_plot_scatter },
+        { "PlotShaded",           _implot_plot_shaded },
+        { "PlotStairs",           _implot_plot_stairs },
+        { "PlotStems",            _implot_plot_stems },
+        { NULL,                   NULL },
     };
     api->lua->L_newlib(L, s_implot_method);
     return 1;
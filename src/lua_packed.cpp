@@ -0,0 +1,128 @@
+#include <string.h>
+#include "lua_packed.h"
+#include "lua_imgui.h"
+#include "series.hpp"
+
+/**
+ * @brief Typed, strided view of packed values in a Lua string.
+ *
+ * The string is kept alive by the view, and it is immutable, so elements are
+ * read in place and the version never changes.
+ */
+typedef struct imgui_packed
+{
+    const char*     data;       /**< Address of element 0. */
+    size_t          count;      /**< Number of elements. */
+    size_t          stride;     /**< Distance between elements in bytes. */
+    imgui_dtype_t   type;       /**< Element type. */
+    uint64_t        version;    /**< Data version. */
+} imgui_packed_t;
+
+static void _packed_view(void* self, imgui_series_t* series)
+{
+    imgui_packed_t* packed = (imgui_packed_t*)self;
+    series->data = packed->data;
+    series->count = packed->count;
+    series->offset = 0;
+    series->stride = packed->stride;
+    series->type = packed->type;
+    series->version = packed->version;
+}
+
+static const imgui_series_vtbl_t s_packed_vtbl = {
+    "packed",
+    _packed_view,
+    NULL,
+};
+
+static imgui_packed_t* _packed_check(lua_State* L, int idx)
+{
+    api->lua->L_checkudata(L, idx, "__atd_imgui_packed");
+    return (imgui_packed_t*)api->lua->touserdata(L, idx);
+}
+
+static int _packed_size(lua_State* L)
+{
+    imgui_packed_t* packed = _packed_check(L, 1);
+    api->lua->pushinteger(L, packed->count);
+    return 1;
+}
+
+static int _packed_get(lua_State* L)
+{
+    imgui_packed_t* packed = _packed_check(L, 1);
+    int64_t idx = api->lua->L_checkinteger(L, 2);
+    if (idx < 1 || (size_t)idx > packed->count)
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    imgui_series_t series;
+    memset(&series, 0, sizeof(series));
+    _packed_view(packed, &series);
+
+    api->lua->pushnumber(L, imgui_series_get(&series, idx - 1));
+    return 1;
+}
+
+int imgui_packed_new(lua_State *L)
+{
+    size_t len;
+    const char* data = api->lua->L_checklstring(L, 1, &len);
+    imgui_dtype_t type = imgui_dtype_check(L, 2, IMGUI_DTYPE_F64);
+    size_t size = imgui_dtype_size(type);
+
+    int64_t offset = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 4) : 0;
+    int64_t stride = api->lua->type(L, 5) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 5) : (int64_t)size;
+    if (offset < 0 || (size_t)offset > len || stride < (int64_t)size)
+    {
+        return api->lua->L_error(L, "invalid offset %d or stride %d", (int)offset, (int)stride);
+    }
+
+    /* ImPlot reads elements through typed pointers */
+    if (((uintptr_t)(data + offset) | (uintptr_t)stride) % size != 0)
+    {
+        return api->lua->L_error(L, "offset %d and stride %d must be multiples of element size %d",
+            (int)offset, (int)stride, (int)size);
+    }
+
+    size_t avail = len - offset >= size ? (len - offset - size) / stride + 1 : 0;
+    int64_t count = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? api->lua->tointeger(L, 3) : (int64_t)avail;
+    if (count < 0 || (size_t)count > avail)
+    {
+        return api->lua->L_error(L, "count %d out of range [0, %d]", (int)count, (int)avail);
+    }
+
+    imgui_packed_t* packed = (imgui_packed_t*)api->lua->newuserdatauv(L, sizeof(imgui_packed_t), 1);
+    packed->data = data + offset;
+    packed->count = (size_t)count;
+    packed->stride = (size_t)stride;
+    packed->type = type;
+    packed->version = imgui_series_next_version();
+
+    imgui_series_bind(L, &s_packed_vtbl);
+
+    /* Keep string alive */
+    api->lua->pushvalue(L, 1);
+    api->lua->setiuservalue(L, -2, 1);
+
+    static const auto_luaL_Reg s_packed_meta[] = {
+        { "__len",      _packed_size },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_packed_method[] = {
+        { "get",        _packed_get },
+        { "size",       _packed_size },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_packed") != 0)
+    {
+        api->lua->L_setfuncs(L, s_packed_meta, 0);
+        api->lua->L_newlib(L, s_packed_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
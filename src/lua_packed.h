@@ -0,0 +1,27 @@
+#ifndef __LUA_PACKED_H__
+#define __LUA_PACKED_H__
+
+#include <autodo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create a series view over bytes of a Lua string.
+ *
+ * [1]: string data
+ * [2]: string type, optional
+ * [3]: integer count, optional
+ * [4]: integer offset, optional
+ * [5]: integer stride, optional
+ *
+ * @param[in] L     Lua VM.
+ * @return          Always 1.
+ */
+AUTO_LOCAL int imgui_packed_new(lua_State *L);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
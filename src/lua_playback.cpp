@@ -0,0 +1,273 @@
+#include <imgui.h>
+#include <string.h>
+#include <algorithm>
+#include "lua_playback.h"
+#include "lua_imgui.h"
+#include "playback.hpp"
+
+static ImGuiKey _playback_key(lua_State* L, const char* name)
+{
+    for (int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; key++)
+    {
+        if (strcmp(ImGui::GetKeyName((ImGuiKey)key), name) == 0)
+        {
+            return (ImGuiKey)key;
+        }
+    }
+    api->lua->L_error(L, "unknown key `%s`", name);
+    return ImGuiKey_None;
+}
+
+static int _playback_button(lua_State* L, int idx)
+{
+    int64_t button = api->lua->tointeger(L, idx);
+    if (button < 0 || button >= ImGuiMouseButton_COUNT)
+    {
+        return api->lua->L_error(L, "mouse button %d out of range [0, %d)", (int)button, ImGuiMouseButton_COUNT);
+    }
+    return (int)button;
+}
+
+/**
+ * @brief Parse event on top of stack, pop it and append to \p events.
+ *
+ * An event is `{ frame, type, args... }`. `click` and `key` are expanded to a
+ * press and a release in next frame.
+ *
+ * All checks are done before any event is built, so nothing owning memory is
+ * alive when an error is raised.
+ *
+ * @param[out] events   Parsed events, or NULL to only validate.
+ */
+static void _playback_parse(lua_State* L, int64_t i, std::vector<imgui_playback_event_t>* events)
+{
+    int idx = api->lua->gettop(L);
+    if (api->lua->type(L, idx) != AUTO_LUA_TTABLE)
+    {
+        api->lua->L_error(L, "event #%d is not a table", (int)i);
+        return;
+    }
+
+    api->lua->geti(L, idx, 1);
+    api->lua->geti(L, idx, 2);
+    api->lua->geti(L, idx, 3);
+    api->lua->geti(L, idx, 4);
+    int64_t frame = api->lua->tointeger(L, idx + 1);
+    const char* type = api->lua->tostring(L, idx + 2);
+    if (frame < 0 || type == NULL)
+    {
+        api->lua->L_error(L, "event #%d needs a frame and a type", (int)i);
+        return;
+    }
+
+    imgui_playback_type_t kind;
+    bool expand = false;
+    int code = 0;
+    float x = 0, y = 0;
+    const char* text = "";
+
+    if (strcmp(type, "move") == 0 || strcmp(type, "resize") == 0)
+    {
+        kind = type[0] == 'm' ? IMGUI_PLAYBACK_MOVE : IMGUI_PLAYBACK_RESIZE;
+        x = (float)api->lua->tonumber(L, idx + 3);
+        y = (float)api->lua->tonumber(L, idx + 4);
+    }
+    else if (strcmp(type, "down") == 0 || strcmp(type, "up") == 0 || strcmp(type, "click") == 0)
+    {
+        code = _playback_button(L, idx + 3);
+        kind = type[0] == 'u' ? IMGUI_PLAYBACK_UP : IMGUI_PLAYBACK_DOWN;
+        expand = type[0] == 'c';
+    }
+    else if (strcmp(type, "wheel") == 0)
+    {
+        kind = IMGUI_PLAYBACK_WHEEL;
+        y = (float)api->lua->tonumber(L, idx + 3);
+        x = (float)api->lua->tonumber(L, idx + 4);
+    }
+    else if (strcmp(type, "key") == 0 || strcmp(type, "key_down") == 0 || strcmp(type, "key_up") == 0)
+    {
+        const char* name = api->lua->tostring(L, idx + 3);
+        code = _playback_key(L, name != NULL ? name : "");
+        kind = strcmp(type, "key_up") == 0 ? IMGUI_PLAYBACK_KEY_UP : IMGUI_PLAYBACK_KEY_DOWN;
+        expand = strcmp(type, "key") == 0;
+    }
+    else if (strcmp(type, "text") == 0)
+    {
+        kind = IMGUI_PLAYBACK_TEXT;
+        text = api->lua->tostring(L, idx + 3);
+        text = text != NULL ? text : "";
+    }
+    else if (strcmp(type, "exit") == 0)
+    {
+        kind = IMGUI_PLAYBACK_EXIT;
+    }
+    else
+    {
+        api->lua->L_error(L, "event #%d has unknown type `%s`", (int)i, type);
+        return;
+    }
+
+    if (events != NULL)
+    {
+        imgui_playback_event_t ev;
+        ev.frame = (uint64_t)frame;
+        ev.type = kind;
+        ev.code = code;
+        ev.x = x;
+        ev.y = y;
+        ev.text = text;
+        events->push_back(ev);
+        if (expand)
+        {
+            ev.frame++;
+            ev.type = kind == IMGUI_PLAYBACK_DOWN ? IMGUI_PLAYBACK_UP : IMGUI_PLAYBACK_KEY_UP;
+            events->push_back(ev);
+        }
+    }
+
+    api->lua->pop(L, 5);
+}
+
+static double _playback_percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t rank = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+/**
+ * @brief Start playing a timeline from next frame.
+ *
+ * [1]: table events
+ */
+static int _playback_start(lua_State* L)
+{
+    api->lua->L_checktype(L, 1, AUTO_LUA_TTABLE);
+
+    /* Validate whole script first, errors would skip destructor of events */
+    int64_t len = api->lua->L_len(L, 1);
+    for (int64_t i = 1; i <= len; i++)
+    {
+        api->lua->geti(L, 1, i);
+        _playback_parse(L, i, NULL);
+    }
+
+    std::vector<imgui_playback_event_t> events;
+    for (int64_t i = 1; i <= len; i++)
+    {
+        api->lua->geti(L, 1, i);
+        _playback_parse(L, i, &events);
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+        [](const imgui_playback_event_t& a, const imgui_playback_event_t& b) { return a.frame < b.frame; });
+    imgui_playback_start(events);
+    return 0;
+}
+
+/**
+ * @brief Stop playback.
+ *
+ * Returns: table report
+ */
+static int _playback_stop(lua_State* L)
+{
+    imgui_playback_report_t report;
+    imgui_playback_stop(&report);
+
+    std::vector<double> sorted = report.times;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        sum += sorted[i];
+    }
+
+    api->lua->newtable(L);
+    api->lua->pushinteger(L, (int64_t)report.frames);
+    api->lua->setfield(L, -2, "frames");
+    api->lua->pushboolean(L, report.finished);
+    api->lua->setfield(L, -2, "finished");
+    api->lua->pushnumber(L, sorted.empty() ? 0 : sum / sorted.size());
+    api->lua->setfield(L, -2, "mean");
+    api->lua->pushnumber(L, _playback_percentile(sorted, 0.50));
+    api->lua->setfield(L, -2, "p50");
+    api->lua->pushnumber(L, _playback_percentile(sorted, 0.95));
+    api->lua->setfield(L, -2, "p95");
+    api->lua->pushnumber(L, _playback_percentile(sorted, 0.99));
+    api->lua->setfield(L, -2, "p99");
+    api->lua->pushnumber(L, sorted.empty() ? 0 : sorted.back());
+    api->lua->setfield(L, -2, "max");
+
+    api->lua->newtable(L);
+    for (size_t i = 0; i < report.times.size(); i++)
+    {
+        api->lua->pushnumber(L, report.times[i]);
+        api->lua->seti(L, -2, (int64_t)i + 1);
+    }
+    api->lua->setfield(L, -2, "times");
+
+    api->lua->newtable(L);
+    for (size_t i = 0; i < report.failures.size(); i++)
+    {
+        api->lua->pushstring(L, report.failures[i].c_str());
+        api->lua->seti(L, -2, (int64_t)i + 1);
+    }
+    api->lua->setfield(L, -2, "failures");
+
+    return 1;
+}
+
+/**
+ * @brief Get current playback frame.
+ *
+ * Returns: integer frame, or nil if not playing
+ */
+static int _playback_frame(lua_State* L)
+{
+    int64_t frame = imgui_playback_frame();
+    if (frame < 0)
+    {
+        api->lua->pushnil(L);
+    }
+    else
+    {
+        api->lua->pushinteger(L, frame);
+    }
+    return 1;
+}
+
+/**
+ * @brief Record a failure if condition is false.
+ *
+ * [1]: any condition
+ * [2]: string message, optional
+ * Returns: boolean condition
+ */
+static int _playback_check(lua_State* L)
+{
+    int ok = api->lua->toboolean(L, 1);
+    if (!ok)
+    {
+        const char* msg = api->lua->tostring(L, 2);
+        imgui_playback_fail(msg != NULL ? msg : "check failed");
+    }
+    api->lua->pushboolean(L, ok);
+    return 1;
+}
+
+int imgui_luaopen_playback(lua_State *L)
+{
+    static const auto_luaL_Reg s_playback_method[] = {
+        { "check",      _playback_check },
+        { "frame",      _playback_frame },
+        { "start",      _playback_start },
+        { "stop",       _playback_stop },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_playback_method);
+    return 1;
+}
@@ -0,0 +1,255 @@
+#include <string.h>
+#include <imgui.h>
+#include <string>
+#include "lua_profiler.h"
+#include "lua_imgui.h"
+#include "profiler.hpp"
+
+/**
+ * @brief Default VM instructions between two samples.
+ */
+#define IMGUI_PROFILER_DEFAULT_COUNT    1000
+
+typedef struct imgui_profiler_lua
+{
+    lua_State*      hooked;     /**< Coroutine with sampling hook installed. */
+    int             count;      /**< VM instructions between two samples. */
+    std::string     frames[IMGUI_PROFILER_MAX_DEPTH];
+} imgui_profiler_lua_t;
+
+static imgui_profiler_lua_t s_profiler_lua = { NULL, IMGUI_PROFILER_DEFAULT_COUNT, {} };
+
+/**
+ * @brief Push `debug.<field>`, or return 0 if debug library is not loaded.
+ */
+static int _profiler_debug_function(lua_State* L, const char* field)
+{
+    if (api->lua->getglobal(L, "debug") != AUTO_LUA_TTABLE)
+    {
+        api->lua->pop(L, 1);
+        return 0;
+    }
+    if (api->lua->getfield(L, -1, field) != AUTO_LUA_TFUNCTION)
+    {
+        api->lua->pop(L, 2);
+        return 0;
+    }
+    api->lua->remove(L, -2);
+    return 1;
+}
+
+/**
+ * @brief Describe function at stack \p level, or return 0 if there is none.
+ */
+static int _profiler_describe(lua_State* L, int level, std::string& frame, int* is_c)
+{
+    if (!_profiler_debug_function(L, "getinfo"))
+    {
+        return 0;
+    }
+    api->lua->pushinteger(L, level);
+    api->lua->pushstring(L, "Sn");
+    api->lua->callk(L, 2, 1, 0, NULL);
+    if (api->lua->type(L, -1) != AUTO_LUA_TTABLE)
+    {
+        api->lua->pop(L, 1);
+        return 0;
+    }
+
+    api->lua->getfield(L, -1, "what");
+    const char* what = api->lua->tostring(L, -1);
+    *is_c = what != NULL && strcmp(what, "C") == 0;
+    int is_main = what != NULL && strcmp(what, "main") == 0;
+    api->lua->getfield(L, -2, "name");
+    const char* name = api->lua->tostring(L, -1);
+    api->lua->getfield(L, -3, "short_src");
+    const char* src = api->lua->tostring(L, -1);
+    api->lua->getfield(L, -4, "linedefined");
+    int64_t line = api->lua->tointeger(L, -1);
+
+    frame = is_main ? "main chunk" : (name != NULL ? name : "?");
+    if (*is_c)
+    {
+        frame += " [C]";
+    }
+    else
+    {
+        frame += " (";
+        frame += src != NULL ? src : "?";
+        frame += ":" + std::to_string(line) + ")";
+    }
+
+    api->lua->pop(L, 5);
+    return 1;
+}
+
+/**
+ * @brief Count hook, take a sample of current Lua stack.
+ */
+static int _profiler_hook(lua_State* L)
+{
+    uint64_t now = api->misc->hrtime();
+
+    /* Level 0 is getinfo, 1 is this hook, 2 is the running function */
+    const char* frames[IMGUI_PROFILER_MAX_DEPTH];
+    int n = 0, n_c = 0;
+    for (; n < IMGUI_PROFILER_MAX_DEPTH; n++)
+    {
+        int is_c;
+        if (!_profiler_describe(L, n + 2, s_profiler_lua.frames[n], &is_c))
+        {
+            break;
+        }
+        n_c = is_c ? n_c + 1 : 0;
+    }
+
+    /* Outermost C functions belong to coroutine machinery */
+    n -= n_c;
+    for (int i = 0; i < n; i++)
+    {
+        frames[i] = s_profiler_lua.frames[n - 1 - i].c_str();
+    }
+
+    imgui_profiler_sample(now, frames, n);
+    return 0;
+}
+
+static void _profiler_sethook(lua_State* L, int count)
+{
+    if (!_profiler_debug_function(L, "sethook"))
+    {
+        return;
+    }
+
+    if (count == 0)
+    {
+        api->lua->callk(L, 0, 0, 0, NULL);
+        return;
+    }
+
+    api->lua->pushcfunction(L, _profiler_hook);
+    api->lua->pushstring(L, "");
+    api->lua->pushinteger(L, count);
+    api->lua->callk(L, 3, 0, 0, NULL);
+}
+
+void imgui_profiler_frame_begin(lua_State *L)
+{
+    if (!imgui_profiler_enabled())
+    {
+        return;
+    }
+
+    if (s_profiler_lua.hooked != L)
+    {
+        _profiler_sethook(L, s_profiler_lua.count);
+        s_profiler_lua.hooked = L;
+    }
+    imgui_profiler_open_frame();
+}
+
+void imgui_profiler_frame_end(lua_State *L)
+{
+    imgui_profiler_close_frame();
+
+    if (!imgui_profiler_enabled() && s_profiler_lua.hooked == L)
+    {
+        _profiler_sethook(L, 0);
+        s_profiler_lua.hooked = NULL;
+    }
+}
+
+/**
+ * @brief Start profiling from next frame.
+ *
+ * The profiler uses `debug.sethook()` on the coroutine running GUI function,
+ * which replaces any hook set by user.
+ *
+ * [1]: integer VM instructions between two samples, default 1000
+ */
+static int _profiler_start(lua_State* L)
+{
+    int64_t count = api->lua->type(L, 1) == AUTO_LUA_TNUMBER
+        ? api->lua->tointeger(L, 1) : IMGUI_PROFILER_DEFAULT_COUNT;
+    if (count <= 0)
+    {
+        return api->lua->L_error(L, "count must be positive");
+    }
+
+    if (count != s_profiler_lua.count)
+    {
+        /* Install hook again with new count */
+        s_profiler_lua.count = (int)count;
+        s_profiler_lua.hooked = NULL;
+    }
+    imgui_profiler_enable(1);
+    return 0;
+}
+
+/**
+ * @brief Stop profiling at the end of current frame. Collected data is kept.
+ */
+static int _profiler_stop(lua_State* L)
+{
+    (void)L;
+    imgui_profiler_enable(0);
+    return 0;
+}
+
+/**
+ * @brief Drop collected data.
+ */
+static int _profiler_reset(lua_State* L)
+{
+    (void)L;
+    imgui_profiler_reset();
+    return 0;
+}
+
+/**
+ * @brief Show profiler window.
+ *
+ * [1]: string window title, default "Profiler"
+ */
+static int _profiler_show(lua_State* L)
+{
+    const char* title = api->lua->type(L, 1) == AUTO_LUA_TSTRING ? api->lua->tostring(L, 1) : "Profiler";
+
+    if (ImGui::Begin(title))
+    {
+        imgui_profiler_draw();
+    }
+    ImGui::End();
+    return 0;
+}
+
+/**
+ * @brief Save collected data in folded stack format.
+ *
+ * [1]: string path
+ */
+static int _profiler_save(lua_State* L)
+{
+    const char* path = api->lua->L_checklstring(L, 1, NULL);
+
+    int ret = imgui_profiler_save(path);
+    if (ret != 0)
+    {
+        return api->lua->L_error(L, "save `%s` failed: %s", path, strerror(ret));
+    }
+    return 0;
+}
+
+int imgui_luaopen_profiler(lua_State *L)
+{
+    static const auto_luaL_Reg s_profiler_method[] = {
+        { "reset",      _profiler_reset },
+        { "save",       _profiler_save },
+        { "show",       _profiler_show },
+        { "start",      _profiler_start },
+        { "stop",       _profiler_stop },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_profiler_method);
+    return 1;
+}
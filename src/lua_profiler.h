@@ -0,0 +1,38 @@
+#ifndef __LUA_PROFILER_H__
+#define __LUA_PROFILER_H__
+
+#include <autodo.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Open ImGui extension profiler.
+ * @param[in] L     Lua VM.
+ * @return          Always 1.
+ */
+AUTO_LOCAL int imgui_luaopen_profiler(lua_State *L);
+
+/**
+ * @brief User function is about to run on \p L.
+ *
+ * Install sampling hook on \p L if profiler is running.
+ *
+ * @param[in] L     Coroutine running user function.
+ */
+AUTO_LOCAL void imgui_profiler_frame_begin(lua_State *L);
+
+/**
+ * @brief User function finished a frame on \p L.
+ *
+ * Remove sampling hook from \p L if profiler is stopped.
+ *
+ * @param[in] L     Coroutine running user function.
+ */
+AUTO_LOCAL void imgui_profiler_frame_end(lua_State *L);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,129 @@
+#include "lua_stats.h"
+#include "lua_imgui.h"
+#include "stats.hpp"
+
+/**
+ * @brief Get summary statistics.
+ *
+ * [1]: table or native series
+ *
+ * Returns: min, max, mean, variance, sum, count
+ */
+static int _stats_summary(lua_State* L)
+{
+    imgui_series_t values;
+    imgui_series_check(L, 1, &values);
+    imgui_series_prepare(&values, 0, values.count);
+
+    imgui_stats_t stats;
+    imgui_stats_summary(&values, &stats);
+    imgui_series_release(&values);
+
+    api->lua->pushnumber(L, stats.min);
+    api->lua->pushnumber(L, stats.max);
+    api->lua->pushnumber(L, stats.mean);
+    api->lua->pushnumber(L, stats.variance);
+    api->lua->pushnumber(L, stats.sum);
+    api->lua->pushinteger(L, (int64_t)stats.count);
+    return 6;
+}
+
+/**
+ * @brief Estimate quantiles.
+ *
+ * [1]: table or native series
+ * [2+]: number quantile in range [0, 1]
+ *
+ * Returns: one number for each quantile
+ */
+static int _stats_quantile(lua_State* L)
+{
+    int sp = api->lua->gettop(L);
+    if (sp < 2)
+    {
+        return api->lua->L_error(L, "quantile required");
+    }
+
+    /* Scratch is a userdata so it is collected if any check below fails */
+    size_t n = sp - 1;
+    double* q = (double*)api->lua->newuserdatauv(L, sizeof(double) * n * 2, 0);
+    double* out = q + n;
+    for (size_t i = 0; i < n; i++)
+    {
+        q[i] = api->lua->L_checknumber(L, (int)i + 2);
+        q[i] = q[i] < 0 ? 0 : (q[i] > 1 ? 1 : q[i]);
+    }
+
+    imgui_series_t values;
+    imgui_series_check(L, 1, &values);
+    imgui_series_prepare(&values, 0, values.count);
+    imgui_stats_quantile(&values, q, out, n);
+    imgui_series_release(&values);
+
+    /* Reuse argument slots so any number of quantiles fits the stack */
+    for (size_t i = 0; i < n; i++)
+    {
+        api->lua->pushnumber(L, out[i]);
+        api->lua->replace(L, (int)i + 1);
+    }
+    api->lua->pop(L, sp + 1 - (int)n);
+
+    return (int)n;
+}
+
+/**
+ * @brief Count values into equal width bins.
+ *
+ * [1]: table or native series
+ * [2]: integer bins, optional. Default by Sturges' rule.
+ * [3]: number range minimum, optional. Default is minimum value.
+ * [4]: number range maximum, optional. Default is maximum value.
+ *
+ * Returns: table counts, number range minimum, number range maximum
+ */
+static int _stats_histogram(lua_State* L)
+{
+    imgui_series_t values;
+    imgui_series_check(L, 1, &values);
+    imgui_series_prepare(&values, 0, values.count);
+
+    imgui_stats_t stats;
+    imgui_stats_summary(&values, &stats);
+
+    int64_t bins = api->lua->type(L, 2) == AUTO_LUA_TNUMBER ?
+        api->lua->tointeger(L, 2) : (int64_t)imgui_stats_sturges(values.count);
+    double lo = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 3) : stats.min;
+    double hi = api->lua->type(L, 4) == AUTO_LUA_TNUMBER ? api->lua->tonumber(L, 4) : stats.max;
+    if (bins <= 0 || bins > IMGUI_STATS_BINS_MAX)
+    {
+        imgui_series_release(&values);
+        return api->lua->L_error(L, "invalid bins %f, expect 1 to %d", (double)bins, IMGUI_STATS_BINS_MAX);
+    }
+
+    double* counts = (double*)api->lua->newuserdatauv(L, sizeof(double) * bins, 0);
+    imgui_stats_histogram(&values, lo, hi, (size_t)bins, counts);
+    imgui_series_release(&values);
+
+    api->lua->newtable(L);
+    for (int64_t i = 0; i < bins; i++)
+    {
+        api->lua->pushinteger(L, (int64_t)counts[i]);
+        api->lua->seti(L, -2, i + 1);
+    }
+
+    api->lua->pushnumber(L, lo);
+    api->lua->pushnumber(L, hi);
+    return 3;
+}
+
+int imgui_luaopen_stats(lua_State *L)
+{
+    static const auto_luaL_Reg s_stats_method[] = {
+        { "histogram",  _stats_histogram },
+        { "quantile",   _stats_quantile },
+        { "summary",    _stats_summary },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_stats_method);
+    return 1;
+}
@@ -0,0 +1,233 @@
+#include <string.h>
+#include "lua_store.h"
+#include "lua_imgui.h"
+#include "series.hpp"
+#include "store.hpp"
+
+/**
+ * @brief Lua handle of a slot.
+ */
+typedef struct imgui_store_ref
+{
+    imgui_store_slot_t*     slot;
+    uint64_t                seen;       /**< Write count of last view. */
+    uint64_t                version;    /**< Series version of last view. */
+} imgui_store_ref_t;
+
+/**
+ * @brief Snapshot slot value into scratch of \p series.
+ */
+static void _store_view(void* self, imgui_series_t* series)
+{
+    imgui_store_ref_t* ref = (imgui_store_ref_t*)self;
+    size_t nwords = imgui_store_words(ref->slot);
+    uint64_t* words = (uint64_t*)malloc(sizeof(uint64_t) * (nwords ? nwords : 1));
+
+    size_t size;
+    uint64_t seen = imgui_store_read(ref->slot, words, &size);
+    if (seen != ref->seen || ref->version == 0)
+    {
+        ref->seen = seen;
+        ref->version = imgui_series_next_version();
+    }
+
+    imgui_store_type_t type = imgui_store_type(ref->slot);
+    series->data = words;
+    series->count = type == IMGUI_STORE_STRING ? 0 : size;
+    series->stride = sizeof(uint64_t);
+    series->type = type == IMGUI_STORE_INTEGER ? IMGUI_DTYPE_I64 : IMGUI_DTYPE_F64;
+    series->version = ref->version;
+    series->scratch = words;
+}
+
+static const imgui_series_vtbl_t s_store_vtbl = {
+    "store",
+    _store_view,
+    NULL,
+};
+
+static imgui_store_ref_t* _store_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_store_slot");
+    return (imgui_store_ref_t*)api->lua->touserdata(L, arg);
+}
+
+/**
+ * @brief Push value of \p slot.
+ */
+static void _store_push(lua_State* L, const imgui_store_slot_t* slot)
+{
+    size_t nwords = imgui_store_words(slot);
+    std::vector<uint64_t> words(nwords ? nwords : 1);
+
+    size_t size;
+    imgui_store_read(slot, words.data(), &size);
+
+    switch (imgui_store_type(slot))
+    {
+    case IMGUI_STORE_NUMBER:
+    {
+        double value;
+        memcpy(&value, &words[0], sizeof(value));
+        api->lua->pushnumber(L, value);
+        break;
+    }
+
+    case IMGUI_STORE_INTEGER:
+        api->lua->pushinteger(L, (int64_t)words[0]);
+        break;
+
+    case IMGUI_STORE_ARRAY:
+        api->lua->newtable(L);
+        for (size_t i = 0; i < size; i++)
+        {
+            double value;
+            memcpy(&value, &words[i], sizeof(value));
+            api->lua->pushnumber(L, value);
+            api->lua->seti(L, -2, (int64_t)i + 1);
+        }
+        break;
+
+    case IMGUI_STORE_STRING:
+        api->lua->pushlstring(L, (const char*)words.data(), size);
+        break;
+    }
+}
+
+/**
+ * @brief Get value of slot.
+ *
+ * [1]: slot
+ * Returns: number, integer, table or string
+ */
+static int _store_slot_get(lua_State* L)
+{
+    imgui_store_ref_t* ref = _store_check(L, 1);
+    _store_push(L, ref->slot);
+    return 1;
+}
+
+/**
+ * @brief Get the number of writes to slot.
+ *
+ * [1]: slot
+ * Returns: integer
+ */
+static int _store_slot_version(lua_State* L)
+{
+    imgui_store_ref_t* ref = _store_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_store_version(ref->slot));
+    return 1;
+}
+
+/**
+ * @brief Get handle of a slot.
+ *
+ * [1]: string name
+ * Returns: slot, or nil if not created yet
+ */
+static int _store_slot(lua_State* L)
+{
+    const char* name = api->lua->L_checkstring(L, 1);
+    imgui_store_slot_t* slot = imgui_store_find(name);
+    if (slot == NULL)
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+
+    imgui_store_ref_t* ref = (imgui_store_ref_t*)api->lua->newuserdatauv(L, sizeof(imgui_store_ref_t), 0);
+    ref->slot = slot;
+    ref->seen = 0;
+    ref->version = 0;
+
+    imgui_series_bind(L, &s_store_vtbl);
+
+    static const auto_luaL_Reg s_slot_method[] = {
+        { "get",        _store_slot_get },
+        { "version",    _store_slot_version },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_store_slot") != 0)
+    {
+        api->lua->L_newlib(L, s_slot_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
+
+/**
+ * @brief Get values of slots.
+ *
+ * [1+]: slot or string name
+ * Returns: value of each slot, nil if name is not created yet
+ */
+static int _store_get(lua_State* L)
+{
+    int sp = api->lua->gettop(L);
+    for (int i = 1; i <= sp; i++)
+    {
+        const imgui_store_slot_t* slot;
+        if (api->lua->type(L, i) == AUTO_LUA_TSTRING)
+        {
+            slot = imgui_store_find(api->lua->tostring(L, i));
+        }
+        else
+        {
+            slot = _store_check(L, i)->slot;
+        }
+
+        if (slot == NULL)
+        {
+            api->lua->pushnil(L);
+            continue;
+        }
+        _store_push(L, slot);
+    }
+    return sp;
+}
+
+/**
+ * @brief Get names of all slots.
+ *
+ * Returns: table
+ */
+static int _store_list(lua_State* L)
+{
+    std::vector<std::string> names;
+    imgui_store_names(names);
+
+    api->lua->newtable(L);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        api->lua->pushstring(L, names[i].c_str());
+        api->lua->seti(L, -2, (int64_t)i + 1);
+    }
+    return 1;
+}
+
+/**
+ * @brief Get publishing API for native modules.
+ *
+ * Returns: lightuserdata #imgui_store_api_t
+ */
+static int _store_api(lua_State* L)
+{
+    api->lua->pushlightuserdata(L, (void*)imgui_store_api());
+    return 1;
+}
+
+int imgui_luaopen_store(lua_State *L)
+{
+    static const auto_luaL_Reg s_store_method[] = {
+        { "api",        _store_api },
+        { "get",        _store_get },
+        { "list",       _store_list },
+        { "slot",       _store_slot },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_store_method);
+    return 1;
+}
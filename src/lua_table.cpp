@@ -0,0 +1,510 @@
+#include <imgui.h>
+#include <stdio.h>
+#include <string.h>
+#include "lua_table.h"
+#include "lua_imgui.h"
+#include "series.hpp"
+#include "table.hpp"
+
+/**
+ * @brief Lua handle of a table.
+ */
+typedef struct imgui_table_ref
+{
+    imgui_table_t*      table;
+} imgui_table_ref_t;
+
+static imgui_table_t* _table_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_table");
+    return ((imgui_table_ref_t*)api->lua->touserdata(L, arg))->table;
+}
+
+static size_t _table_check_column(lua_State* L, imgui_table_t* table, int arg)
+{
+    int64_t col = api->lua->L_checkinteger(L, arg);
+    size_t ncol = imgui_table_columns(table).size();
+    if (col < 1 || (size_t)col > ncol)
+    {
+        api->lua->L_error(L, "column %d out of range [1, %d]", (int)col, (int)ncol);
+    }
+    return (size_t)col - 1;
+}
+
+/**
+ * @brief Find the conversion specifier of the directive that starts after `%`.
+ * @return  Length of flags, width and precision before the specifier.
+ */
+static size_t _table_format_spec(const char* p)
+{
+    size_t len = strspn(p, "-+ #0");
+    len += strspn(p + len, "0123456789");
+    if (p[len] == '.')
+    {
+        len++;
+        len += strspn(p + len, "0123456789");
+    }
+    return len;
+}
+
+/**
+ * @brief Check printf format of numeric column.
+ *
+ * A format must contain exactly one conversion, `diouxX` for integer column
+ * or `aAeEfFgG` for number column. `%%` is allowed anywhere.
+ */
+static void _table_check_format(lua_State* L, const char* fmt, imgui_table_type_t type)
+{
+    int conversions = 0;
+
+    for (const char* p = fmt; *p != '\0'; p++)
+    {
+        if (*p != '%')
+        {
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            p++;
+            continue;
+        }
+
+        p++;
+        size_t len = _table_format_spec(p);
+        const char* accepted = type == IMGUI_TABLE_INTEGER ? "diouxX" : "aAeEfFgG";
+        if (p[len] == '\0' || strchr(accepted, p[len]) == NULL)
+        {
+            api->lua->L_error(L, "invalid conversion in format `%s`", fmt);
+        }
+        p += len;
+        conversions++;
+    }
+
+    if (conversions != 1)
+    {
+        api->lua->L_error(L, "format `%s` needs exactly one conversion", fmt);
+    }
+}
+
+/**
+ * @brief Widen integer conversion of a checked format to 64 bits.
+ */
+static std::string _table_widen_format(const char* fmt, imgui_table_type_t type)
+{
+    std::string ret;
+    for (const char* p = fmt; *p != '\0'; p++)
+    {
+        ret.push_back(*p);
+        if (*p != '%')
+        {
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            ret.push_back(*++p);
+            continue;
+        }
+
+        p++;
+        size_t len = _table_format_spec(p);
+        ret.append(p, len);
+        if (type == IMGUI_TABLE_INTEGER)
+        {
+            ret.append("ll");
+        }
+        ret.push_back(p[len]);
+        p += len;
+    }
+    return ret;
+}
+
+static void _table_push_cell(lua_State* L, imgui_table_t* table, size_t row, size_t col)
+{
+    const imgui_table_cell_t* cell = imgui_table_at(table, row, col);
+    switch (imgui_table_columns(table)[col].type)
+    {
+    case IMGUI_TABLE_INTEGER:
+        api->lua->pushinteger(L, cell->i);
+        break;
+
+    case IMGUI_TABLE_NUMBER:
+        api->lua->pushnumber(L, cell->f);
+        break;
+
+    case IMGUI_TABLE_STRING:
+        api->lua->pushlstring(L, cell->s.ptr, cell->s.len);
+        break;
+    }
+}
+
+static int _table_gc(lua_State* L)
+{
+    imgui_table_ref_t* ref = (imgui_table_ref_t*)api->lua->touserdata(L, 1);
+    if (ref->table != NULL)
+    {
+        imgui_table_release(ref->table);
+        ref->table = NULL;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append a row.
+ *
+ * [1]: table
+ * [2+]: value of each column
+ */
+static int _table_append(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    const std::vector<imgui_table_column_t>& columns = imgui_table_columns(table);
+
+    /* Check all values first so a bad row is not half appended */
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        int arg = (int)i + 2;
+        switch (columns[i].type)
+        {
+        case IMGUI_TABLE_INTEGER:   api->lua->L_checkinteger(L, arg);           break;
+        case IMGUI_TABLE_NUMBER:    api->lua->L_checknumber(L, arg);            break;
+        case IMGUI_TABLE_STRING:    api->lua->L_checklstring(L, arg, NULL);     break;
+        }
+    }
+
+    imgui_table_cell_t* cells = imgui_table_append(table);
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        int arg = (int)i + 2;
+        switch (columns[i].type)
+        {
+        case IMGUI_TABLE_INTEGER:
+            cells[i].i = api->lua->tointeger(L, arg);
+            break;
+
+        case IMGUI_TABLE_NUMBER:
+            cells[i].f = api->lua->tonumber(L, arg);
+            break;
+
+        case IMGUI_TABLE_STRING:
+        {
+            size_t len;
+            const char* str = api->lua->tolstring(L, arg, &len);
+            cells[i].s.ptr = imgui_table_intern(table, str, len);
+            cells[i].s.len = len;
+            break;
+        }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Get a cell.
+ *
+ * [1]: table
+ * [2]: integer row in insertion order
+ * [3]: integer column
+ * Returns: value, or nil if row is out of range
+ */
+static int _table_get(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    int64_t row = api->lua->L_checkinteger(L, 2);
+    size_t col = _table_check_column(L, table, 3);
+
+    if (row < 1 || (size_t)row > imgui_table_rows(table))
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+    _table_push_cell(L, table, (size_t)row - 1, col);
+    return 1;
+}
+
+static int _table_rows(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_table_rows(table));
+    return 1;
+}
+
+static int _table_clear(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    imgui_table_clear(table);
+    return 0;
+}
+
+/**
+ * @brief Keep rows containing text in string columns, ignoring ASCII case.
+ *
+ * [1]: table
+ * [2]: string text, empty to keep all rows
+ * [3]: integer column, optional. Default all string columns.
+ */
+static int _table_filter(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    const char* text = api->lua->L_checkstring(L, 2);
+    int column = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? (int)_table_check_column(L, table, 3) : -1;
+    imgui_table_filter(table, text, column);
+    return 0;
+}
+
+/**
+ * @brief Get row in insertion order of a displayed row.
+ *
+ * [1]: table
+ * [2]: integer displayed row
+ * Returns: integer row, or nil if out of range
+ */
+static int _table_index(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    int64_t pos = api->lua->L_checkinteger(L, 2);
+
+    const uint32_t* index;
+    size_t count;
+    imgui_table_view(table, &index, &count);
+    if (pos < 1 || (size_t)pos > count)
+    {
+        api->lua->pushnil(L);
+        return 1;
+    }
+    api->lua->pushinteger(L, index != NULL ? (int64_t)index[pos - 1] + 1 : pos);
+    return 1;
+}
+
+static void _table_draw_cell(imgui_table_t* table, size_t row, size_t col)
+{
+    const imgui_table_column_t& column = imgui_table_columns(table)[col];
+    const imgui_table_cell_t* cell = imgui_table_at(table, row, col);
+    char buf[64];
+
+    switch (column.type)
+    {
+    case IMGUI_TABLE_INTEGER:
+        snprintf(buf, sizeof(buf), column.format.c_str(), (long long)cell->i);
+        ImGui::TextUnformatted(buf);
+        break;
+
+    case IMGUI_TABLE_NUMBER:
+        snprintf(buf, sizeof(buf), column.format.c_str(), cell->f);
+        ImGui::TextUnformatted(buf);
+        break;
+
+    case IMGUI_TABLE_STRING:
+        ImGui::TextUnformatted(cell->s.ptr, cell->s.ptr + cell->s.len);
+        break;
+    }
+}
+
+/**
+ * @brief Draw table with sortable headers.
+ *
+ * Clicking a header (shift-click for more keys) sorts on worker threads.
+ * Previous order is displayed until sorting finishes. Only visible rows are
+ * drawn.
+ *
+ * [1]: table
+ * [2]: string id
+ * [3]: number height, optional. Default fills remaining space.
+ * Returns: integer displayed rows, boolean busy
+ */
+static int _table_draw(lua_State* L)
+{
+    imgui_table_t* table = _table_check(L, 1);
+    const char* id = api->lua->L_checkstring(L, 2);
+    float height = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 3) : 0.0f;
+    const std::vector<imgui_table_column_t>& columns = imgui_table_columns(table);
+
+    ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY
+        | ImGuiTableFlags_Resizable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_Hideable
+        | ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti;
+    if (!ImGui::BeginTable(id, (int)columns.size(), flags, ImVec2(0.0f, height)))
+    {
+        api->lua->pushinteger(L, 0);
+        api->lua->pushboolean(L, 0);
+        return 2;
+    }
+
+    ImGui::TableSetupScrollFreeze(0, 1);
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        ImGui::TableSetupColumn(columns[i].name.c_str());
+    }
+    ImGui::TableHeadersRow();
+
+    ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs();
+    if (specs != NULL && specs->SpecsDirty)
+    {
+        std::vector<imgui_table_key_t> keys;
+        for (int i = 0; i < specs->SpecsCount; i++)
+        {
+            imgui_table_key_t key;
+            key.column = (size_t)specs->Specs[i].ColumnIndex;
+            key.descending = specs->Specs[i].SortDirection == ImGuiSortDirection_Descending;
+            keys.push_back(key);
+        }
+        imgui_table_sort(table, keys);
+        specs->SpecsDirty = false;
+    }
+
+    const uint32_t* index;
+    size_t count;
+    bool busy = imgui_table_view(table, &index, &count);
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)count);
+    while (clipper.Step())
+    {
+        for (int pos = clipper.DisplayStart; pos < clipper.DisplayEnd; pos++)
+        {
+            size_t row = index != NULL ? index[pos] : (size_t)pos;
+            ImGui::TableNextRow();
+            for (size_t col = 0; col < columns.size(); col++)
+            {
+                ImGui::TableNextColumn();
+                _table_draw_cell(table, row, col);
+            }
+        }
+    }
+    ImGui::EndTable();
+
+    api->lua->pushinteger(L, (int64_t)count);
+    api->lua->pushboolean(L, busy);
+    return 2;
+}
+
+/**
+ * @brief Parse column on top of stack and pop it.
+ * @param[out] column   Parsed column, or NULL to only check. Check all columns
+ *   first, an error would skip destructor of the strings.
+ */
+static void _table_parse_column(lua_State* L, int64_t i, imgui_table_column_t* column)
+{
+    int idx = api->lua->gettop(L);
+    if (api->lua->type(L, idx) != AUTO_LUA_TTABLE)
+    {
+        api->lua->L_error(L, "column #%d is not a table", (int)i + 1);
+        return;
+    }
+    api->lua->geti(L, idx, 1);
+    api->lua->geti(L, idx, 2);
+    api->lua->geti(L, idx, 3);
+
+    const char* name = api->lua->tostring(L, idx + 1);
+    const char* type = api->lua->tostring(L, idx + 2);
+    const char* format = api->lua->tostring(L, idx + 3);
+    if (name == NULL || type == NULL)
+    {
+        api->lua->L_error(L, "column #%d needs a name and a type", (int)i + 1);
+        return;
+    }
+
+    imgui_table_type_t kind;
+    int dtype = imgui_dtype_parse(type);
+    if (strcmp(type, "string") == 0)
+    {
+        kind = IMGUI_TABLE_STRING;
+    }
+    else if (dtype == IMGUI_DTYPE_F32 || dtype == IMGUI_DTYPE_F64)
+    {
+        kind = IMGUI_TABLE_NUMBER;
+        format = format != NULL ? format : "%g";
+        _table_check_format(L, format, kind);
+    }
+    else if (dtype >= 0)
+    {
+        kind = IMGUI_TABLE_INTEGER;
+        format = format != NULL ? format : "%d";
+        _table_check_format(L, format, kind);
+    }
+    else
+    {
+        api->lua->L_error(L, "column #%d has unknown type `%s`", (int)i + 1, type);
+        return;
+    }
+
+    if (column != NULL)
+    {
+        column->name = name;
+        column->type = kind;
+        if (kind != IMGUI_TABLE_STRING)
+        {
+            column->format = _table_widen_format(format, kind);
+        }
+    }
+    api->lua->pop(L, 4);
+}
+
+/**
+ * @brief Create table.
+ *
+ * [1]: table columns, each is `{ string name, string type, [string format] }`.
+ *   Type is `string`, an integer type such as `i64`, or `f32`/`f64`.
+ * Returns: table
+ */
+static int _table_new(lua_State* L)
+{
+    api->lua->L_checktype(L, 1, AUTO_LUA_TTABLE);
+    int64_t ncol = api->lua->L_len(L, 1);
+    if (ncol < 1 || ncol > 64)
+    {
+        return api->lua->L_error(L, "invalid number of columns %d", (int)ncol);
+    }
+
+    for (int64_t i = 0; i < ncol; i++)
+    {
+        api->lua->geti(L, 1, i + 1);
+        _table_parse_column(L, i, NULL);
+    }
+    imgui_table_ref_t* ref = (imgui_table_ref_t*)api->lua->newuserdatauv(L, sizeof(imgui_table_ref_t), 0);
+    ref->table = NULL;
+
+    /* Columns are checked above, so nothing raises error while they are alive */
+    {
+        std::vector<imgui_table_column_t> columns((size_t)ncol);
+        for (int64_t i = 0; i < ncol; i++)
+        {
+            api->lua->geti(L, 1, i + 1);
+            _table_parse_column(L, i, &columns[i]);
+        }
+        ref->table = imgui_table_create(columns);
+    }
+
+    static const auto_luaL_Reg s_table_meta[] = {
+        { "__gc",       _table_gc },
+        { "__len",      _table_rows },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_table_method[] = {
+        { "append",     _table_append },
+        { "clear",      _table_clear },
+        { "draw",       _table_draw },
+        { "filter",     _table_filter },
+        { "get",        _table_get },
+        { "index",      _table_index },
+        { "rows",       _table_rows },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_table") != 0)
+    {
+        api->lua->L_setfuncs(L, s_table_meta, 0);
+        api->lua->L_newlib(L, s_table_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
+
+int imgui_luaopen_table(lua_State *L)
+{
+    static const auto_luaL_Reg s_table_method[] = {
+        { "new",        _table_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_table_method);
+    return 1;
+}
@@ -0,0 +1,426 @@
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "lua_timeseries.h"
+#include "lua_imgui.h"
+#include "timeseries.hpp"
+
+#define IMGUI_TIMESERIES_BLOCK_SIZE     1024
+#define IMGUI_TIMESERIES_RESOLUTION     1e-6
+
+/**
+ * @brief Stored ticks are less than this in magnitude, so the difference of
+ *   any two ticks and of any two such differences fit in int64_t.
+ */
+#define IMGUI_TIMESERIES_TICK_LIMIT     4.611686018427387904e18 /* 2^62 */
+
+/**
+ * @brief As a plain series, a time series is the values of its last window.
+ */
+static void _timeseries_view(void* self, imgui_series_t* series)
+{
+    imgui_timeseries_t* ts = (imgui_timeseries_t*)self;
+    series->data = ts->win_y.data();
+    series->count = ts->win_y.size();
+    series->offset = 0;
+    series->stride = sizeof(double);
+    series->type = IMGUI_DTYPE_F64;
+    series->version = ts->win_y_version;
+}
+
+static const imgui_series_vtbl_t s_timeseries_vtbl = {
+    "timeseries",
+    _timeseries_view,
+    NULL,
+};
+
+static imgui_timeseries_t* _timeseries_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_timeseries");
+    return (imgui_timeseries_t*)api->lua->touserdata(L, arg);
+}
+
+imgui_timeseries_t* imgui_timeseries_test(lua_State* L, int arg)
+{
+    if (imgui_series_test(L, arg) != &s_timeseries_vtbl)
+    {
+        return NULL;
+    }
+    return (imgui_timeseries_t*)api->lua->touserdata(L, arg);
+}
+
+static void _timeseries_lru_reset(imgui_timeseries_t* ts)
+{
+    for (size_t i = 0; i < IMGUI_TIMESERIES_LRU_SIZE; i++)
+    {
+        ts->lru[i].block = SIZE_MAX;
+        ts->lru[i].stamp = 0;
+    }
+}
+
+/**
+ * @brief Get decoded block, decode it into the least recently used slot if
+ *   not cached.
+ */
+static const imgui_timeseries_lru_t* _timeseries_lru_get(imgui_timeseries_t* ts, size_t block)
+{
+    imgui_timeseries_lru_t* victim = &ts->lru[0];
+    for (size_t i = 0; i < IMGUI_TIMESERIES_LRU_SIZE; i++)
+    {
+        imgui_timeseries_lru_t* entry = &ts->lru[i];
+        if (entry->block == block)
+        {
+            entry->stamp = ++ts->lru_clock;
+            return entry;
+        }
+        if (entry->stamp < victim->stamp)
+        {
+            victim = entry;
+        }
+    }
+
+    const imgui_gorilla_block_t* blk = &ts->blocks[block];
+    victim->ticks.resize(blk->count);
+    victim->values.resize(blk->count);
+    imgui_gorilla_decode(blk, victim->ticks.data(), victim->values.data());
+    victim->block = block;
+    victim->stamp = ++ts->lru_clock;
+    return victim;
+}
+
+static int64_t _timeseries_tick(const imgui_timeseries_t* ts, double t)
+{
+    double tick = t / ts->resolution;
+    if (tick != tick || tick <= -9.2e18)
+    {
+        return INT64_MIN;
+    }
+    return tick >= 9.2e18 ? INT64_MAX : (int64_t)floor(tick);
+}
+
+static void _timeseries_win_push(imgui_timeseries_t* ts, int64_t tick, double value)
+{
+    ts->win_x.push_back((double)tick * ts->resolution);
+    ts->win_y.push_back(value);
+}
+
+static void _timeseries_win_fill(imgui_timeseries_t* ts, double t_min, double t_max)
+{
+    int64_t lo = _timeseries_tick(ts, t_min);
+    int64_t hi = _timeseries_tick(ts, t_max);
+    hi = hi < INT64_MAX ? hi + 1 : hi;
+
+    ts->win_x.clear();
+    ts->win_y.clear();
+
+    /* First block that ends after minimum */
+    size_t b_lo = 0, b_hi = ts->blocks.size();
+    while (b_lo < b_hi)
+    {
+        size_t mid = b_lo + (b_hi - b_lo) / 2;
+        if (ts->blocks[mid].last_tick < lo) b_lo = mid + 1; else b_hi = mid;
+    }
+
+    /* Left margin, from header of previous block */
+    if (b_lo > 0)
+    {
+        const imgui_gorilla_block_t* prev = &ts->blocks[b_lo - 1];
+        _timeseries_win_push(ts, prev->last_tick, prev->last_value);
+    }
+
+    for (size_t b = b_lo; b < ts->blocks.size(); b++)
+    {
+        const imgui_gorilla_block_t* blk = &ts->blocks[b];
+        if (blk->first_tick > hi)
+        {
+            /* Right margin, from header of next block */
+            _timeseries_win_push(ts, blk->first_tick, blk->first_value);
+            return;
+        }
+
+        const imgui_timeseries_lru_t* entry = _timeseries_lru_get(ts, b);
+        for (size_t i = 0; i < entry->ticks.size(); i++)
+        {
+            _timeseries_win_push(ts, entry->ticks[i], entry->values[i]);
+        }
+    }
+
+    /* Hot tail, with one sample of margin on each side */
+    size_t n = ts->tail_ticks.size();
+    size_t i_lo = 0, i_hi = n;
+    while (i_lo < i_hi)
+    {
+        size_t mid = i_lo + (i_hi - i_lo) / 2;
+        if (ts->tail_ticks[mid] < lo) i_lo = mid + 1; else i_hi = mid;
+    }
+    for (size_t i = i_lo > 0 ? i_lo - 1 : 0; i < n; i++)
+    {
+        _timeseries_win_push(ts, ts->tail_ticks[i], ts->tail_values[i]);
+        if (ts->tail_ticks[i] > hi)
+        {
+            break;
+        }
+    }
+}
+
+void imgui_timeseries_window(imgui_timeseries_t* ts, double t_min, double t_max,
+    imgui_series_t* xs, imgui_series_t* ys)
+{
+    if (ts->win_source != ts->version || ts->win_min != t_min || ts->win_max != t_max)
+    {
+        /* Window content changes with its bounds, so it is a new series */
+        _timeseries_win_fill(ts, t_min, t_max);
+        ts->win_source = ts->version;
+        ts->win_x_version = imgui_series_next_version();
+        ts->win_y_version = imgui_series_next_version();
+        ts->win_min = t_min;
+        ts->win_max = t_max;
+    }
+
+    memset(xs, 0, sizeof(*xs));
+    xs->data = ts->win_x.data();
+    xs->count = ts->win_x.size();
+    xs->stride = sizeof(double);
+    xs->type = IMGUI_DTYPE_F64;
+    xs->version = ts->win_x_version;
+    xs->vtbl = &s_timeseries_vtbl;
+    xs->self = ts;
+
+    *ys = *xs;
+    ys->data = ts->win_y.data();
+    ys->version = ts->win_y_version;
+}
+
+void imgui_timeseries_bounds(const imgui_timeseries_t* ts, double* t_first,
+    double* t_last, double* v_min, double* v_max)
+{
+    int64_t first = ts->blocks.empty() ? ts->tail_ticks.front() : ts->blocks.front().first_tick;
+    int64_t last = ts->tail_ticks.empty() ? ts->blocks.back().last_tick : ts->tail_ticks.back();
+
+    *t_first = (double)first * ts->resolution;
+    *t_last = (double)last * ts->resolution;
+    *v_min = ts->v_min;
+    *v_max = ts->v_max;
+}
+
+/**
+ * @brief Compress hot tail into a new block.
+ */
+static void _timeseries_seal(imgui_timeseries_t* ts)
+{
+    ts->blocks.emplace_back();
+    imgui_gorilla_encode(&ts->blocks.back(), ts->tail_ticks.data(), ts->tail_values.data(),
+        ts->tail_ticks.size());
+    ts->tail_ticks.clear();
+    ts->tail_values.clear();
+}
+
+static void _timeseries_push(lua_State* L, imgui_timeseries_t* ts, double t, double v)
+{
+    /* Round to nearest tick */
+    double tick_f = floor((t + ts->resolution / 2) / ts->resolution);
+    if (!(fabs(tick_f) < IMGUI_TIMESERIES_TICK_LIMIT))
+    {
+        api->lua->L_error(L, "timestamp %f is out of range", t);
+        return;
+    }
+
+    int64_t tick = (int64_t)tick_f;
+    int64_t last = ts->tail_ticks.empty()
+        ? (ts->blocks.empty() ? INT64_MIN : ts->blocks.back().last_tick)
+        : ts->tail_ticks.back();
+    if (tick < last)
+    {
+        api->lua->L_error(L, "timestamp %f is earlier than last sample", t);
+        return;
+    }
+
+    ts->tail_ticks.push_back(tick);
+    ts->tail_values.push_back(v);
+    ts->v_min = ts->size == 0 || v < ts->v_min ? v : ts->v_min;
+    ts->v_max = ts->size == 0 || v > ts->v_max ? v : ts->v_max;
+    ts->size++;
+
+    if (ts->tail_ticks.size() >= ts->block_size)
+    {
+        _timeseries_seal(ts);
+    }
+}
+
+static int _timeseries_gc(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+    ts->~imgui_timeseries_t();
+    return 0;
+}
+
+/**
+ * @brief Append samples.
+ *
+ * [1]: timeseries
+ * [2]: number timestamp in seconds, or table of timestamps
+ * [3]: number value, or table of values
+ */
+static int _timeseries_append(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+
+    ts->version = imgui_series_next_version();
+
+    if (api->lua->type(L, 2) != AUTO_LUA_TTABLE)
+    {
+        _timeseries_push(L, ts, api->lua->L_checknumber(L, 2), api->lua->L_checknumber(L, 3));
+        return 0;
+    }
+
+    api->lua->L_checktype(L, 3, AUTO_LUA_TTABLE);
+    int64_t n_t = api->lua->L_len(L, 2);
+    int64_t n_v = api->lua->L_len(L, 3);
+    int64_t len = n_t < n_v ? n_t : n_v;
+    for (int64_t i = 1; i <= len; i++)
+    {
+        api->lua->geti(L, 2, i);
+        api->lua->geti(L, 3, i);
+        double t = api->lua->tonumber(L, -2);
+        double v = api->lua->tonumber(L, -1);
+        api->lua->pop(L, 2);
+        _timeseries_push(L, ts, t, v);
+    }
+
+    return 0;
+}
+
+static int _timeseries_clear(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+    ts->blocks.clear();
+    ts->tail_ticks.clear();
+    ts->tail_values.clear();
+    ts->size = 0;
+    ts->v_min = 0;
+    ts->v_max = 0;
+    _timeseries_lru_reset(ts);
+    ts->version = imgui_series_next_version();
+    return 0;
+}
+
+static int _timeseries_size(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+    api->lua->pushinteger(L, ts->size);
+    return 1;
+}
+
+/**
+ * @brief Get timestamp of first and last sample, or nothing if empty.
+ */
+static int _timeseries_range(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+    if (ts->size == 0)
+    {
+        return 0;
+    }
+
+    double t_first, t_last, v_min, v_max;
+    imgui_timeseries_bounds(ts, &t_first, &t_last, &v_min, &v_max);
+    api->lua->pushnumber(L, t_first);
+    api->lua->pushnumber(L, t_last);
+    return 2;
+}
+
+/**
+ * @brief Get memory usage.
+ *
+ * @return  Bytes used by samples, and bytes they would take uncompressed.
+ */
+static int _timeseries_bytes(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+
+    size_t bytes = ts->tail_ticks.capacity() * sizeof(int64_t)
+        + ts->tail_values.capacity() * sizeof(double);
+    for (size_t i = 0; i < ts->blocks.size(); i++)
+    {
+        bytes += sizeof(imgui_gorilla_block_t) + ts->blocks[i].bits.size() * sizeof(uint64_t);
+    }
+
+    api->lua->pushinteger(L, (int64_t)bytes);
+    api->lua->pushinteger(L, (int64_t)(ts->size * (sizeof(int64_t) + sizeof(double))));
+    return 2;
+}
+
+static int _timeseries_version(lua_State* L)
+{
+    imgui_timeseries_t* ts = _timeseries_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)ts->version);
+    return 1;
+}
+
+/**
+ * @brief Create time series.
+ *
+ * [1]: integer samples per compressed block, default 1024
+ * [2]: number timestamp resolution in seconds, default 1e-6
+ */
+static int _timeseries_new(lua_State* L)
+{
+    int64_t block_size = api->lua->type(L, 1) == AUTO_LUA_TNUMBER
+        ? api->lua->tointeger(L, 1) : IMGUI_TIMESERIES_BLOCK_SIZE;
+    double resolution = api->lua->type(L, 2) == AUTO_LUA_TNUMBER
+        ? api->lua->tonumber(L, 2) : IMGUI_TIMESERIES_RESOLUTION;
+    if (block_size < 2)
+    {
+        return api->lua->L_error(L, "invalid block size %d", (int)block_size);
+    }
+    if (!(resolution > 0))
+    {
+        return api->lua->L_error(L, "invalid resolution %f", resolution);
+    }
+
+    void* addr = api->lua->newuserdatauv(L, sizeof(imgui_timeseries_t), 0);
+    imgui_timeseries_t* ts = new (addr) imgui_timeseries_t();
+    ts->resolution = resolution;
+    ts->block_size = (size_t)block_size;
+    ts->tail_ticks.reserve(ts->block_size);
+    ts->tail_values.reserve(ts->block_size);
+    _timeseries_lru_reset(ts);
+    ts->version = imgui_series_next_version();
+
+    imgui_series_bind(L, &s_timeseries_vtbl);
+
+    static const auto_luaL_Reg s_timeseries_meta[] = {
+        { "__gc",       _timeseries_gc },
+        { "__len",      _timeseries_size },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_timeseries_method[] = {
+        { "append",     _timeseries_append },
+        { "bytes",      _timeseries_bytes },
+        { "clear",      _timeseries_clear },
+        { "range",      _timeseries_range },
+        { "size",       _timeseries_size },
+        { "version",    _timeseries_version },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_timeseries") != 0)
+    {
+        api->lua->L_setfuncs(L, s_timeseries_meta, 0);
+        api->lua->L_newlib(L, s_timeseries_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    return 1;
+}
+
+int imgui_luaopen_timeseries(lua_State *L)
+{
+    static const auto_luaL_Reg s_timeseries_method[] = {
+        { "new",        _timeseries_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_timeseries_method);
+    return 1;
+}
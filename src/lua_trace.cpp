@@ -0,0 +1,44 @@
+#include <string.h>
+#include "lua_trace.h"
+#include "lua_imgui.h"
+#include "trace.hpp"
+
+/**
+ * @brief Start writing trace events.
+ *
+ * [1]: string path
+ */
+static int _trace_start(lua_State* L)
+{
+    const char* path = api->lua->L_checklstring(L, 1, NULL);
+
+    int ret = imgui_trace_start(path);
+    if (ret != 0)
+    {
+        return api->lua->L_error(L, "open `%s` failed: %s", path, strerror(ret));
+    }
+    return 0;
+}
+
+/**
+ * @brief Stop tracing and close file.
+ *
+ * Returns: integer the number of dropped events
+ */
+static int _trace_stop(lua_State* L)
+{
+    uint64_t dropped = imgui_trace_stop();
+    api->lua->pushinteger(L, (int64_t)dropped);
+    return 1;
+}
+
+int imgui_luaopen_trace(lua_State *L)
+{
+    static const auto_luaL_Reg s_trace_method[] = {
+        { "start",      _trace_start },
+        { "stop",       _trace_stop },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_trace_method);
+    return 1;
+}
@@ -0,0 +1,316 @@
+#include <imgui.h>
+#include "lua_tree.h"
+#include "lua_imgui.h"
+#include "tree.hpp"
+
+/**
+ * @brief Lua handle of a tree.
+ */
+typedef struct imgui_tree_ref
+{
+    imgui_tree_t*       tree;
+    lua_State*          L;          /**< Caller of method that may load children, with tree at index 1. */
+    int64_t             selected;   /**< Selected node, or 0. */
+} imgui_tree_ref_t;
+
+static imgui_tree_ref_t* _tree_check(lua_State* L, int arg)
+{
+    api->lua->L_checkudata(L, arg, "__atd_imgui_tree");
+    return (imgui_tree_ref_t*)api->lua->touserdata(L, arg);
+}
+
+static uint32_t _tree_check_node(lua_State* L, imgui_tree_ref_t* ref, int arg, bool allow_root)
+{
+    int64_t node = api->lua->L_checkinteger(L, arg);
+    if (node < (allow_root ? 0 : 1) || (uint64_t)node > imgui_tree_size(ref->tree))
+    {
+        return (uint32_t)api->lua->L_error(L, "bad argument #%d (node out of range)", arg);
+    }
+    return (uint32_t)node;
+}
+
+/**
+ * @brief Call Lua loader in uservalue 1 as `loader(tree, node)`.
+ */
+static void _tree_load(imgui_tree_t* tree, uint32_t node, void* arg)
+{
+    (void)tree;
+    lua_State* L = ((imgui_tree_ref_t*)arg)->L;
+
+    if (api->lua->getiuservalue(L, 1, 1) != AUTO_LUA_TFUNCTION)
+    {
+        api->lua->pop(L, 1);
+        return;
+    }
+    api->lua->pushvalue(L, 1);
+    api->lua->pushinteger(L, node);
+    api->lua->callk(L, 2, 0, 0, NULL);
+}
+
+static int _tree_gc(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    if (ref->tree != NULL)
+    {
+        imgui_tree_destroy(ref->tree);
+        ref->tree = NULL;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append a child.
+ *
+ * [1]: tree
+ * [2]: integer parent, 0 for top-level
+ * [3]: string label
+ * [4]: boolean leaf, optional
+ * Returns: integer node
+ */
+static int _tree_add(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    uint32_t parent = _tree_check_node(L, ref, 2, true);
+    size_t len;
+    const char* label = api->lua->L_checklstring(L, 3, &len);
+    bool leaf = api->lua->toboolean(L, 4);
+
+    if (imgui_tree_size(ref->tree) >= UINT32_MAX - 1)
+    {
+        return api->lua->L_error(L, "too many nodes");
+    }
+
+    api->lua->pushinteger(L, imgui_tree_add(ref->tree, parent, label, len, leaf));
+    return 1;
+}
+
+static int _tree_clear(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    imgui_tree_clear(ref->tree);
+    ref->selected = 0;
+    return 0;
+}
+
+/**
+ * @brief Draw visible nodes in a child window. Only rows on screen are drawn.
+ *
+ * [1]: tree
+ * [2]: string id
+ * [3]: number height, optional. Default fills remaining space.
+ * Returns: integer node clicked, or nil
+ */
+static int _tree_draw(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    const char* id = api->lua->L_checkstring(L, 2);
+    float height = api->lua->type(L, 3) == AUTO_LUA_TNUMBER ? (float)api->lua->tonumber(L, 3) : 0.0f;
+    const std::vector<uint32_t>& rows = imgui_tree_rows(ref->tree);
+    int64_t clicked = 0;
+    int64_t toggled = -1;
+
+    if (ImGui::BeginChild(id, ImVec2(0.0f, height), true))
+    {
+        const float x = ImGui::GetCursorPosX();
+        const float indent = ImGui::GetStyle().IndentSpacing;
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)rows.size());
+        while (clipper.Step())
+        {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+            {
+                const uint32_t node = rows[row];
+                const bool expanded = imgui_tree_is_expanded(ref->tree, node);
+                size_t len;
+                const char* label = imgui_tree_label(ref->tree, node, &len);
+
+                ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_OpenOnArrow
+                    | ImGuiTreeNodeFlags_OpenOnDoubleClick | ImGuiTreeNodeFlags_SpanAvailWidth;
+                if (imgui_tree_is_leaf(ref->tree, node))
+                {
+                    flags |= ImGuiTreeNodeFlags_Leaf;
+                }
+                if (ref->selected == (int64_t)node)
+                {
+                    flags |= ImGuiTreeNodeFlags_Selected;
+                }
+
+                /* Open state lives in the tree, not in ImGui storage */
+                ImGui::SetCursorPosX(x + indent * imgui_tree_depth(ref->tree, node));
+                ImGui::SetNextItemOpen(expanded, ImGuiCond_Always);
+                bool open = ImGui::TreeNodeEx((void*)(intptr_t)node, flags, "%.*s", (int)len, label);
+
+                if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen())
+                {
+                    clicked = node;
+                    ref->selected = node;
+                }
+                if (open != expanded)
+                {
+                    toggled = row;
+                }
+            }
+        }
+    }
+    ImGui::EndChild();
+
+    /* Rows are spliced after drawing, so children show from next frame */
+    if (toggled >= 0)
+    {
+        ref->L = L;
+        imgui_tree_toggle(ref->tree, (size_t)toggled);
+    }
+
+    if (clicked == 0)
+    {
+        return 0;
+    }
+    api->lua->pushinteger(L, clicked);
+    return 1;
+}
+
+/**
+ * @brief Expand or collapse a node.
+ *
+ * [1]: tree
+ * [2]: integer node
+ * [3]: boolean expand, optional. Default true.
+ */
+static int _tree_expand(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    uint32_t node = _tree_check_node(L, ref, 2, false);
+    bool expand = api->lua->type(L, 3) == AUTO_LUA_TNONE || api->lua->toboolean(L, 3);
+
+    ref->L = L;
+    imgui_tree_expand(ref->tree, node, expand);
+    return 0;
+}
+
+/**
+ * @brief Check whether a node is expanded.
+ *
+ * [1]: tree
+ * [2]: integer node
+ * Returns: boolean
+ */
+static int _tree_expanded(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    uint32_t node = _tree_check_node(L, ref, 2, false);
+    api->lua->pushboolean(L, imgui_tree_is_expanded(ref->tree, node));
+    return 1;
+}
+
+/**
+ * @brief Get label of a node.
+ *
+ * [1]: tree
+ * [2]: integer node
+ * Returns: string
+ */
+static int _tree_label(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    uint32_t node = _tree_check_node(L, ref, 2, false);
+    size_t len;
+    const char* label = imgui_tree_label(ref->tree, node, &len);
+    api->lua->pushlstring(L, label, len);
+    return 1;
+}
+
+/**
+ * @brief Get parent of a node.
+ *
+ * [1]: tree
+ * [2]: integer node
+ * Returns: integer parent, 0 for top-level
+ */
+static int _tree_parent(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    uint32_t node = _tree_check_node(L, ref, 2, false);
+    api->lua->pushinteger(L, imgui_tree_parent(ref->tree, node));
+    return 1;
+}
+
+/**
+ * @brief Get the number of visible rows.
+ *
+ * [1]: tree
+ * Returns: integer
+ */
+static int _tree_rows(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_tree_rows(ref->tree).size());
+    return 1;
+}
+
+static int _tree_size(lua_State* L)
+{
+    imgui_tree_ref_t* ref = _tree_check(L, 1);
+    api->lua->pushinteger(L, (int64_t)imgui_tree_size(ref->tree));
+    return 1;
+}
+
+/**
+ * @brief Create tree.
+ *
+ * [1]: function loader, optional. Called as `loader(tree, node)` when a node
+ *   is expanded for the first time.
+ * Returns: tree
+ */
+static int _tree_new(lua_State* L)
+{
+    if (api->lua->type(L, 1) != AUTO_LUA_TNONE && api->lua->type(L, 1) != AUTO_LUA_TNIL)
+    {
+        api->lua->L_checktype(L, 1, AUTO_LUA_TFUNCTION);
+    }
+
+    imgui_tree_ref_t* ref = (imgui_tree_ref_t*)api->lua->newuserdatauv(L, sizeof(imgui_tree_ref_t), 1);
+    ref->tree = imgui_tree_create(_tree_load, ref);
+    ref->L = L;
+    ref->selected = 0;
+
+    static const auto_luaL_Reg s_tree_meta[] = {
+        { "__gc",       _tree_gc },
+        { "__len",      _tree_size },
+        { NULL,         NULL },
+    };
+    static const auto_luaL_Reg s_tree_method[] = {
+        { "add",        _tree_add },
+        { "clear",      _tree_clear },
+        { "draw",       _tree_draw },
+        { "expand",     _tree_expand },
+        { "expanded",   _tree_expanded },
+        { "label",      _tree_label },
+        { "parent",     _tree_parent },
+        { "rows",       _tree_rows },
+        { "size",       _tree_size },
+        { NULL,         NULL },
+    };
+    if (api->lua->L_newmetatable(L, "__atd_imgui_tree") != 0)
+    {
+        api->lua->L_setfuncs(L, s_tree_meta, 0);
+        api->lua->L_newlib(L, s_tree_method);
+        api->lua->setfield(L, -2, "__index");
+    }
+    api->lua->setmetatable(L, -2);
+
+    api->lua->pushvalue(L, 1);
+    api->lua->setiuservalue(L, -2, 1);
+
+    return 1;
+}
+
+int imgui_luaopen_tree(lua_State *L)
+{
+    static const auto_luaL_Reg s_tree_method[] = {
+        { "new",        _tree_new },
+        { NULL,         NULL },
+    };
+    api->lua->L_newlib(L, s_tree_method);
+    return 1;
+}
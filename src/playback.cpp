@@ -0,0 +1,132 @@
+#include <imgui.h>
+#include <mutex>
+#include "playback.hpp"
+
+typedef struct imgui_playback
+{
+    std::mutex                          mutex;
+    bool                                active;
+    std::vector<imgui_playback_event_t> events;
+    size_t                              next;       /**< Next event to inject. */
+    int64_t                             frame;      /**< Current frame, -1 before first frame. */
+    bool                                has_pos;    /**< Mouse position is set by playback. */
+    ImVec2                              pos;
+    imgui_playback_report_t             report;
+} imgui_playback_t;
+
+static imgui_playback_t s_playback;
+
+void imgui_playback_start(std::vector<imgui_playback_event_t>& events)
+{
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    s_playback.active = true;
+    s_playback.events.swap(events);
+    s_playback.next = 0;
+    s_playback.frame = -1;
+    s_playback.has_pos = false;
+    s_playback.report = imgui_playback_report_t();
+}
+
+void imgui_playback_stop(imgui_playback_report_t* report)
+{
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    s_playback.report.frames = s_playback.frame >= 0 ? (uint64_t)s_playback.frame + 1 : 0;
+    s_playback.report.finished = s_playback.next == s_playback.events.size();
+    *report = std::move(s_playback.report);
+
+    s_playback.active = false;
+    s_playback.events.clear();
+    s_playback.report = imgui_playback_report_t();
+}
+
+void imgui_playback_apply(imgui_playback_action_t* action)
+{
+    action->resize = false;
+    action->exit = false;
+
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    if (!s_playback.active)
+    {
+        return;
+    }
+
+    ImGuiIO& io = ImGui::GetIO();
+    if (++s_playback.frame == 0)
+    {
+        /* A hidden window never gets focus, but should behave as if it had */
+        io.AddFocusEvent(true);
+    }
+
+    /* Platform backend feeds real cursor every frame, keep it overridden */
+    if (s_playback.has_pos)
+    {
+        io.AddMousePosEvent(s_playback.pos.x, s_playback.pos.y);
+    }
+
+    for (; s_playback.next < s_playback.events.size(); s_playback.next++)
+    {
+        const imgui_playback_event_t* ev = &s_playback.events[s_playback.next];
+        if (ev->frame > (uint64_t)s_playback.frame)
+        {
+            break;
+        }
+
+        switch (ev->type)
+        {
+        case IMGUI_PLAYBACK_MOVE:
+            s_playback.has_pos = true;
+            s_playback.pos = ImVec2(ev->x, ev->y);
+            io.AddMousePosEvent(ev->x, ev->y);
+            break;
+
+        case IMGUI_PLAYBACK_DOWN:
+        case IMGUI_PLAYBACK_UP:
+            io.AddMouseButtonEvent(ev->code, ev->type == IMGUI_PLAYBACK_DOWN);
+            break;
+
+        case IMGUI_PLAYBACK_WHEEL:
+            io.AddMouseWheelEvent(ev->x, ev->y);
+            break;
+
+        case IMGUI_PLAYBACK_KEY_DOWN:
+        case IMGUI_PLAYBACK_KEY_UP:
+            io.AddKeyEvent((ImGuiKey)ev->code, ev->type == IMGUI_PLAYBACK_KEY_DOWN);
+            break;
+
+        case IMGUI_PLAYBACK_TEXT:
+            io.AddInputCharactersUTF8(ev->text.c_str());
+            break;
+
+        case IMGUI_PLAYBACK_RESIZE:
+            action->resize = true;
+            action->width = (int)ev->x;
+            action->height = (int)ev->y;
+            break;
+
+        case IMGUI_PLAYBACK_EXIT:
+            action->exit = true;
+            break;
+        }
+    }
+}
+
+void imgui_playback_record(uint64_t cost)
+{
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    if (s_playback.active && s_playback.frame >= 0)
+    {
+        s_playback.report.times.push_back(cost / 1000.0 / 1000.0);
+    }
+}
+
+int64_t imgui_playback_frame(void)
+{
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    return s_playback.active ? s_playback.frame : -1;
+}
+
+void imgui_playback_fail(const char* msg)
+{
+    std::lock_guard<std::mutex> guard(s_playback.mutex);
+    s_playback.report.failures.push_back("frame " + std::to_string(s_playback.frame) + ": " + msg);
+}
@@ -0,0 +1,96 @@
+#ifndef __IMGUI_PLAYBACK_HPP__
+#define __IMGUI_PLAYBACK_HPP__
+
+#include <autodo.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Synthetic input event types.
+ */
+typedef enum imgui_playback_type
+{
+    IMGUI_PLAYBACK_MOVE,        /**< Move mouse to (#x, #y). */
+    IMGUI_PLAYBACK_DOWN,        /**< Press mouse button #code. */
+    IMGUI_PLAYBACK_UP,          /**< Release mouse button #code. */
+    IMGUI_PLAYBACK_WHEEL,       /**< Scroll by (#x, #y). */
+    IMGUI_PLAYBACK_KEY_DOWN,    /**< Press key #code, which is a ImGuiKey. */
+    IMGUI_PLAYBACK_KEY_UP,      /**< Release key #code. */
+    IMGUI_PLAYBACK_TEXT,        /**< Type UTF-8 #text. */
+    IMGUI_PLAYBACK_RESIZE,      /**< Resize window to (#x, #y). */
+    IMGUI_PLAYBACK_EXIT,        /**< Close window. */
+} imgui_playback_type_t;
+
+typedef struct imgui_playback_event
+{
+    uint64_t                frame;      /**< Frame to inject, counted from start of playback. */
+    imgui_playback_type_t   type;
+    int                     code;
+    float                   x;
+    float                   y;
+    std::string             text;
+} imgui_playback_event_t;
+
+/**
+ * @brief Playback result.
+ */
+typedef struct imgui_playback_report
+{
+    uint64_t                    frames;     /**< Frames played. */
+    bool                        finished;   /**< All events injected. */
+    std::vector<double>         times;      /**< Cost of each frame in milliseconds. */
+    std::vector<std::string>    failures;   /**< Failed checks. */
+} imgui_playback_report_t;
+
+/**
+ * @brief Actions the GUI thread must take in current frame.
+ */
+typedef struct imgui_playback_action
+{
+    bool                    resize;     /**< Resize window to (#width, #height). */
+    int                     width;
+    int                     height;
+    bool                    exit;       /**< Close window. */
+} imgui_playback_action_t;
+
+/**
+ * @brief Start playing a timeline. Previous playback is discarded.
+ * @param[in,out] events    Events, sorted by frame. Content is moved out.
+ */
+AUTO_LOCAL void imgui_playback_start(std::vector<imgui_playback_event_t>& events);
+
+/**
+ * @brief Stop playback and take its result.
+ * @param[out] report   Playback result.
+ */
+AUTO_LOCAL void imgui_playback_stop(imgui_playback_report_t* report);
+
+/**
+ * @brief Inject events of current frame into ImGui input queue.
+ * @note Called on GUI thread after platform backend started a new frame and
+ *   before ImGui::NewFrame().
+ * @param[out] action   Actions requested by events.
+ */
+AUTO_LOCAL void imgui_playback_apply(imgui_playback_action_t* action);
+
+/**
+ * @brief Record cost of a played frame.
+ * @note Called on GUI thread after frame is presented.
+ * @param[in] cost      Frame cost in nanoseconds.
+ */
+AUTO_LOCAL void imgui_playback_record(uint64_t cost);
+
+/**
+ * @brief Get current playback frame.
+ * @return              Frame counted from start of playback, -1 if not playing.
+ */
+AUTO_LOCAL int64_t imgui_playback_frame(void);
+
+/**
+ * @brief Record a failed check in current frame.
+ * @param[in] msg       Message.
+ */
+AUTO_LOCAL void imgui_playback_fail(const char* msg);
+
+#endif
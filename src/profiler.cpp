@@ -0,0 +1,368 @@
+#include <errno.h>
+#include <stdio.h>
+#include <imgui.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "profiler.hpp"
+#include "lua_imgui.h"
+
+typedef struct imgui_profiler_node
+{
+    int                 frame;      /**< Interned name. */
+    int                 parent;     /**< Parent node, -1 for root. */
+    uint64_t            self;       /**< Time charged to this node only, in nanoseconds. */
+    uint64_t            hits;       /**< Samples, or calls of window scope. */
+    std::vector<int>    children;
+} imgui_profiler_node_t;
+
+/**
+ * @brief Call tree. Children always come after their parent.
+ */
+typedef std::vector<imgui_profiler_node_t> imgui_profiler_tree_t;
+
+typedef struct imgui_profiler
+{
+    int                 enabled;
+    uint64_t            frames;     /**< Frames profiled. */
+    uint64_t            in_frame;   /**< Set while user function runs. */
+
+    std::unordered_map<std::string, int>    names;
+    std::vector<std::string>                frames_name;
+
+    imgui_profiler_tree_t   lua;
+    uint64_t                lua_mark;   /**< Time of last sample. */
+    int                     lua_leaf;   /**< Node of last sample. */
+
+    imgui_profiler_tree_t   windows;
+    uint64_t                scope_mark; /**< Time of last scope transition. */
+    std::vector<int>        scopes;     /**< Open scopes. */
+} imgui_profiler_t;
+
+static imgui_profiler_t s_profiler;
+
+static int _profiler_intern(const char* name)
+{
+    auto it = s_profiler.names.find(name);
+    if (it != s_profiler.names.end())
+    {
+        return it->second;
+    }
+
+    int id = (int)s_profiler.frames_name.size();
+    s_profiler.frames_name.push_back(name);
+    s_profiler.names.emplace(name, id);
+    return id;
+}
+
+static void _profiler_tree_init(imgui_profiler_tree_t& tree, const char* root)
+{
+    tree.clear();
+
+    imgui_profiler_node_t node;
+    node.frame = _profiler_intern(root);
+    node.parent = -1;
+    node.self = 0;
+    node.hits = 0;
+    tree.push_back(node);
+}
+
+static int _profiler_tree_child(imgui_profiler_tree_t& tree, int parent, int frame)
+{
+    for (int child : tree[parent].children)
+    {
+        if (tree[child].frame == frame)
+        {
+            return child;
+        }
+    }
+
+    imgui_profiler_node_t node;
+    node.frame = frame;
+    node.parent = parent;
+    node.self = 0;
+    node.hits = 0;
+
+    int pos = (int)tree.size();
+    tree.push_back(node);
+    tree[parent].children.push_back(pos);
+    return pos;
+}
+
+/**
+ * @brief Compute time of each node including children.
+ */
+static std::vector<uint64_t> _profiler_tree_total(const imgui_profiler_tree_t& tree)
+{
+    std::vector<uint64_t> total(tree.size());
+    for (size_t i = tree.size(); i-- > 0;)
+    {
+        total[i] += tree[i].self;
+        if (tree[i].parent >= 0)
+        {
+            total[tree[i].parent] += total[i];
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Charge time since last scope transition to current scope.
+ */
+static void _profiler_scope_charge(uint64_t now)
+{
+    int top = s_profiler.scopes.empty() ? 0 : s_profiler.scopes.back();
+    s_profiler.windows[top].self += now - s_profiler.scope_mark;
+    s_profiler.scope_mark = now;
+}
+
+void imgui_profiler_enable(int enable)
+{
+    if (s_profiler.lua.empty())
+    {
+        imgui_profiler_reset();
+    }
+    s_profiler.enabled = enable;
+}
+
+int imgui_profiler_enabled(void)
+{
+    return s_profiler.enabled;
+}
+
+void imgui_profiler_reset(void)
+{
+    s_profiler.frames = 0;
+    s_profiler.names.clear();
+    s_profiler.frames_name.clear();
+    _profiler_tree_init(s_profiler.lua, "lua");
+    _profiler_tree_init(s_profiler.windows, "windows");
+    s_profiler.lua_leaf = 0;
+    s_profiler.scopes.clear();
+}
+
+void imgui_profiler_open_frame(void)
+{
+    uint64_t now = api->misc->hrtime();
+    s_profiler.in_frame = 1;
+    s_profiler.lua_mark = now;
+    s_profiler.lua_leaf = 0;
+    s_profiler.scope_mark = now;
+    s_profiler.scopes.clear();
+}
+
+void imgui_profiler_close_frame(void)
+{
+    if (!s_profiler.in_frame)
+    {
+        return;
+    }
+
+    uint64_t now = api->misc->hrtime();
+    s_profiler.lua[s_profiler.lua_leaf].self += now - s_profiler.lua_mark;
+    _profiler_scope_charge(now);
+
+    s_profiler.in_frame = 0;
+    s_profiler.frames++;
+}
+
+void imgui_profiler_sample(uint64_t now, const char** frames, size_t n)
+{
+    if (!s_profiler.in_frame)
+    {
+        return;
+    }
+
+    int node = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        node = _profiler_tree_child(s_profiler.lua, node, _profiler_intern(frames[i]));
+    }
+    s_profiler.lua[node].self += now - s_profiler.lua_mark;
+    s_profiler.lua[node].hits++;
+    s_profiler.lua_leaf = node;
+
+    /* Time spent on taking sample is not charged */
+    s_profiler.lua_mark = api->misc->hrtime();
+}
+
+void imgui_profiler_scope_push(const char* name)
+{
+    if (!s_profiler.enabled || !s_profiler.in_frame)
+    {
+        return;
+    }
+
+    _profiler_scope_charge(api->misc->hrtime());
+
+    int top = s_profiler.scopes.empty() ? 0 : s_profiler.scopes.back();
+    int node = _profiler_tree_child(s_profiler.windows, top, _profiler_intern(name));
+    s_profiler.windows[node].hits++;
+    s_profiler.scopes.push_back(node);
+}
+
+void imgui_profiler_scope_pop(void)
+{
+    /* Scopes opened before profiling started are not tracked */
+    if (!s_profiler.enabled || !s_profiler.in_frame || s_profiler.scopes.empty())
+    {
+        return;
+    }
+
+    _profiler_scope_charge(api->misc->hrtime());
+    s_profiler.scopes.pop_back();
+}
+
+static void _profiler_draw_scope(const std::vector<uint64_t>& total, int node, int depth, double frames)
+{
+    const imgui_profiler_node_t& n = s_profiler.windows[node];
+
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Text("%*s%s", depth * 2, "", s_profiler.frames_name[n.frame].c_str());
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", n.hits / frames);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.3f", n.self / frames / 1000 / 1000);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.3f", total[node] / frames / 1000 / 1000);
+
+    for (int child : n.children)
+    {
+        _profiler_draw_scope(total, child, depth + 1, frames);
+    }
+}
+
+static ImU32 _profiler_frame_color(int frame)
+{
+    uint32_t h = (uint32_t)frame * 2654435761u;
+    return IM_COL32(205 + h % 50, 90 + (h >> 8) % 120, 40 + (h >> 16) % 40, 255);
+}
+
+/**
+ * @brief Draw \p node and its children, return the deepest row drawn.
+ */
+static int _profiler_draw_flame(ImDrawList* draw_list, const std::vector<uint64_t>& total,
+    int node, ImVec2 pos, int depth, double scale, double frames)
+{
+    const imgui_profiler_node_t& n = s_profiler.lua[node];
+    float width = (float)(total[node] * scale);
+    if (width < 1.0f)
+    {
+        return depth - 1;
+    }
+
+    const float row = ImGui::GetTextLineHeight() + 2;
+    ImVec2 min(pos.x, pos.y + depth * row);
+    ImVec2 max(min.x + width, min.y + row - 1);
+    const char* name = s_profiler.frames_name[n.frame].c_str();
+
+    draw_list->AddRectFilled(min, max, _profiler_frame_color(n.frame));
+    draw_list->PushClipRect(min, max, true);
+    draw_list->AddText(ImVec2(min.x + 2, min.y + 1), IM_COL32(0, 0, 0, 255), name);
+    draw_list->PopClipRect();
+
+    if (ImGui::IsMouseHoveringRect(min, max))
+    {
+        ImGui::SetTooltip("%s\n%.3f ms per frame (%.1f%%)\nself %.3f ms, %llu samples", name,
+            total[node] / frames / 1000 / 1000, 100.0 * total[node] / total[0],
+            n.self / frames / 1000 / 1000, (unsigned long long)n.hits);
+    }
+
+    int deepest = depth;
+    float x = min.x;
+    for (int child : n.children)
+    {
+        int d = _profiler_draw_flame(draw_list, total, child, ImVec2(x, pos.y), depth + 1, scale, frames);
+        deepest = d > deepest ? d : deepest;
+        x += (float)(total[child] * scale);
+    }
+    return deepest;
+}
+
+void imgui_profiler_draw(void)
+{
+    if (s_profiler.lua.empty())
+    {
+        imgui_profiler_reset();
+    }
+
+    double frames = s_profiler.frames != 0 ? (double)s_profiler.frames : 1.0;
+    ImGui::Text("%s, %llu frames", s_profiler.enabled ? "Running" : "Stopped",
+        (unsigned long long)s_profiler.frames);
+
+    if (ImGui::CollapsingHeader("Windows", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        std::vector<uint64_t> total = _profiler_tree_total(s_profiler.windows);
+        if (ImGui::BeginTable("windows", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable))
+        {
+            ImGui::TableSetupColumn("Window", ImGuiTableColumnFlags_WidthStretch);
+            ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Self (ms)", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableSetupColumn("Total (ms)", ImGuiTableColumnFlags_WidthFixed);
+            ImGui::TableHeadersRow();
+            _profiler_draw_scope(total, 0, 0, frames);
+            ImGui::EndTable();
+        }
+    }
+
+    if (ImGui::CollapsingHeader("Lua", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        std::vector<uint64_t> total = _profiler_tree_total(s_profiler.lua);
+        ImVec2 pos = ImGui::GetCursorScreenPos();
+        float width = ImGui::GetContentRegionAvail().x;
+        double scale = total[0] != 0 ? width / (double)total[0] : 0;
+
+        int deepest = _profiler_draw_flame(ImGui::GetWindowDrawList(), total, 0, pos, 0, scale, frames);
+        ImGui::Dummy(ImVec2(width, (deepest + 1) * (ImGui::GetTextLineHeight() + 2)));
+    }
+}
+
+static void _profiler_save_tree(FILE* file, const imgui_profiler_tree_t& tree)
+{
+    std::string stack;
+    for (size_t i = 0; i < tree.size(); i++)
+    {
+        uint64_t us = tree[i].self / 1000;
+        if (us == 0)
+        {
+            continue;
+        }
+
+        stack.clear();
+        for (int node = (int)i; node >= 0; node = tree[node].parent)
+        {
+            std::string name = s_profiler.frames_name[tree[node].frame];
+            for (char& c : name)
+            {
+                c = c == ';' ? ',' : c;
+            }
+            stack.insert(0, stack.empty() ? name : name + ";");
+        }
+        fprintf(file, "%s %llu\n", stack.c_str(), (unsigned long long)us);
+    }
+}
+
+int imgui_profiler_save(const char* path)
+{
+    if (s_profiler.lua.empty())
+    {
+        imgui_profiler_reset();
+    }
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return errno;
+    }
+
+    _profiler_save_tree(file, s_profiler.lua);
+    _profiler_save_tree(file, s_profiler.windows);
+
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed)
+    {
+        return errno != 0 ? errno : EIO;
+    }
+    return 0;
+}
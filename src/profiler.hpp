@@ -0,0 +1,77 @@
+#ifndef __IMGUI_PROFILER_HPP__
+#define __IMGUI_PROFILER_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Deepest Lua stack recorded by a sample.
+ */
+#define IMGUI_PROFILER_MAX_DEPTH    64
+
+/**
+ * @brief Start or stop profiling. Collected data is kept.
+ * @param[in] enable    Boolean.
+ */
+AUTO_LOCAL void imgui_profiler_enable(int enable);
+
+/**
+ * @brief Check if profiling is running.
+ * @return              Boolean.
+ */
+AUTO_LOCAL int imgui_profiler_enabled(void);
+
+/**
+ * @brief Drop all collected data.
+ */
+AUTO_LOCAL void imgui_profiler_reset(void);
+
+/**
+ * @brief User function is about to run.
+ */
+AUTO_LOCAL void imgui_profiler_open_frame(void);
+
+/**
+ * @brief User function finished a frame.
+ *
+ * Time since last sample is charged to the stack of last sample.
+ */
+AUTO_LOCAL void imgui_profiler_close_frame(void);
+
+/**
+ * @brief Charge time since last sample to a Lua stack.
+ * @param[in] now       Time when sample is taken, in nanoseconds.
+ * @param[in] frames    Function names, outermost first.
+ * @param[in] n         The number of frames.
+ */
+AUTO_LOCAL void imgui_profiler_sample(uint64_t now, const char** frames, size_t n);
+
+/**
+ * @brief Enter a window scope.
+ * @param[in] name      Window name.
+ */
+AUTO_LOCAL void imgui_profiler_scope_push(const char* name);
+
+/**
+ * @brief Leave current window scope.
+ */
+AUTO_LOCAL void imgui_profiler_scope_pop(void);
+
+/**
+ * @brief Draw per-window cost table and flame graph of Lua samples into
+ *   current window.
+ */
+AUTO_LOCAL void imgui_profiler_draw(void);
+
+/**
+ * @brief Write collected data in folded stack format.
+ *
+ * Each line is a `;` separated stack followed by microseconds. Lua stacks
+ * are rooted at `lua`, window scopes at `windows`. The file can be loaded by
+ * flamegraph.pl or speedscope.
+ *
+ * @param[in] path      File path, truncated if exists.
+ * @return              0 if success, otherwise errno.
+ */
+AUTO_LOCAL int imgui_profiler_save(const char* path);
+
+#endif
@@ -0,0 +1,238 @@
+#include <string.h>
+#include <atomic>
+#include "series.hpp"
+#include "lua_imgui.h"
+
+static const struct
+{
+    const char*     name;
+    imgui_dtype_t   type;
+} s_dtype_names[] = {
+    { "i8",     IMGUI_DTYPE_I8 },
+    { "u8",     IMGUI_DTYPE_U8 },
+    { "i16",    IMGUI_DTYPE_I16 },
+    { "u16",    IMGUI_DTYPE_U16 },
+    { "i32",    IMGUI_DTYPE_I32 },
+    { "u32",    IMGUI_DTYPE_U32 },
+    { "i64",    IMGUI_DTYPE_I64 },
+    { "u64",    IMGUI_DTYPE_U64 },
+    { "f32",    IMGUI_DTYPE_F32 },
+    { "f64",    IMGUI_DTYPE_F64 },
+    { "float",  IMGUI_DTYPE_F32 },
+    { "double", IMGUI_DTYPE_F64 },
+};
+
+size_t imgui_dtype_size(imgui_dtype_t type)
+{
+    size_t ret = 0;
+    IMGUI_DTYPE_DISPATCH(type, T, ret = sizeof(T));
+    return ret;
+}
+
+int imgui_dtype_parse(const char* name)
+{
+    size_t i;
+    for (i = 0; i < sizeof(s_dtype_names) / sizeof(s_dtype_names[0]); i++)
+    {
+        if (strcmp(s_dtype_names[i].name, name) == 0)
+        {
+            return s_dtype_names[i].type;
+        }
+    }
+    return -1;
+}
+
+imgui_dtype_t imgui_dtype_check(lua_State* L, int arg, imgui_dtype_t def)
+{
+    if (api->lua->type(L, arg) <= AUTO_LUA_TNIL)
+    {
+        return def;
+    }
+
+    const char* name = api->lua->L_checkstring(L, arg);
+    int type = imgui_dtype_parse(name);
+    if (type < 0)
+    {
+        api->lua->L_error(L, "bad argument #%d: unknown type '%s'", arg, name);
+    }
+    return (imgui_dtype_t)type;
+}
+
+static std::atomic<uint64_t> s_series_version(0);
+
+uint64_t imgui_series_next_version(void)
+{
+    return ++s_series_version;
+}
+
+double imgui_series_get(const imgui_series_t* series, size_t idx)
+{
+    const char* addr = (const char*)series->data + idx * series->stride;
+    double ret = 0;
+    IMGUI_DTYPE_DISPATCH(series->type, T, ret = (double)*(const T*)addr);
+    return ret;
+}
+
+/**
+ * @brief Push the registry of series sources, which maps source userdata to
+ *   its type descriptor. Keys are weak, so sources are still collected.
+ */
+static void _imgui_series_registry(lua_State* L)
+{
+    if (api->lua->getfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_series") == AUTO_LUA_TTABLE)
+    {
+        return;
+    }
+    api->lua->pop(L, 1);
+
+    api->lua->newtable(L);
+    api->lua->newtable(L);
+    api->lua->pushstring(L, "k");
+    api->lua->setfield(L, -2, "__mode");
+    api->lua->setmetatable(L, -2);
+
+    api->lua->pushvalue(L, -1);
+    api->lua->setfield(L, AUTO_LUA_REGISTRYINDEX, "__atd_imgui_series");
+}
+
+void imgui_series_bind(lua_State* L, const imgui_series_vtbl_t* vtbl)
+{
+    _imgui_series_registry(L);
+    api->lua->pushvalue(L, -2);
+    api->lua->pushlightuserdata(L, (void*)vtbl);
+    api->lua->settable(L, -3);
+    api->lua->pop(L, 1);
+}
+
+const imgui_series_vtbl_t* imgui_series_test(lua_State* L, int idx)
+{
+    if (api->lua->type(L, idx) != AUTO_LUA_TUSERDATA)
+    {
+        return NULL;
+    }
+    if (idx < 0)
+    {
+        idx = api->lua->gettop(L) + idx + 1;
+    }
+
+    /*
+     * Only userdata bound by this module are in the registry, so userdata
+     * of other modules are never taken as a series source.
+     */
+    const imgui_series_vtbl_t* vtbl = NULL;
+    _imgui_series_registry(L);
+    api->lua->pushvalue(L, idx);
+    if (api->lua->gettable(L, -2) == AUTO_LUA_TLIGHTUSERDATA)
+    {
+        vtbl = (const imgui_series_vtbl_t*)api->lua->touserdata(L, -1);
+    }
+    api->lua->pop(L, 2);
+
+    return vtbl;
+}
+
+static void _imgui_series_from_table(lua_State* L, int arg, imgui_series_t* series)
+{
+    size_t len = (size_t)api->lua->L_len(L, arg);
+    double* values = (double*)malloc(sizeof(double) * (len ? len : 1));
+
+    for (size_t i = 0; i < len; i++)
+    {
+        api->lua->geti(L, arg, i + 1);
+        values[i] = api->lua->tonumber(L, -1);
+        api->lua->pop(L, 1);
+    }
+
+    series->data = values;
+    series->count = len;
+    series->stride = sizeof(double);
+    series->type = IMGUI_DTYPE_F64;
+    series->scratch = values;
+}
+
+/**
+ * @brief Packed doubles in native byte order, read in place.
+ * @note The string is an argument of the running function, so it stays alive
+ *   until the view is released.
+ */
+static void _imgui_series_from_string(lua_State* L, int arg, imgui_series_t* series)
+{
+    size_t len;
+    series->data = api->lua->tolstring(L, arg, &len);
+    series->count = len / sizeof(double);
+    series->stride = sizeof(double);
+    series->type = IMGUI_DTYPE_F64;
+}
+
+const imgui_series_vtbl_t* imgui_series_argcheck(lua_State* L, int arg)
+{
+    int type = api->lua->type(L, arg);
+    if (type == AUTO_LUA_TTABLE)
+    {
+        return NULL;
+    }
+    if (type == AUTO_LUA_TSTRING)
+    {
+        size_t len;
+        api->lua->tolstring(L, arg, &len);
+        if (len % sizeof(double) != 0)
+        {
+            api->lua->L_error(L, "bad argument #%d: string length %d is not a multiple of %d",
+                arg, (int)len, (int)sizeof(double));
+        }
+        return NULL;
+    }
+
+    const imgui_series_vtbl_t* vtbl = imgui_series_test(L, arg);
+    if (vtbl == NULL)
+    {
+        api->lua->L_error(L, "bad argument #%d: table, string or series expected, got %s",
+            arg, api->lua->L_typename(L, type));
+    }
+    return vtbl;
+}
+
+void imgui_series_check(lua_State* L, int arg, imgui_series_t* series)
+{
+    const imgui_series_vtbl_t* vtbl = imgui_series_argcheck(L, arg);
+    memset(series, 0, sizeof(*series));
+
+    int type = api->lua->type(L, arg);
+    if (type == AUTO_LUA_TTABLE)
+    {
+        _imgui_series_from_table(L, arg, series);
+        return;
+    }
+    if (type == AUTO_LUA_TSTRING)
+    {
+        _imgui_series_from_string(L, arg, series);
+        return;
+    }
+
+    void* self = api->lua->touserdata(L, arg);
+    vtbl->view(self, series);
+    series->vtbl = vtbl;
+    series->self = self;
+}
+
+void imgui_series_prepare(imgui_series_t* series, size_t beg, size_t end)
+{
+    if (end > series->count)
+    {
+        end = series->count;
+    }
+    if (series->vtbl == NULL || series->vtbl->prepare == NULL || beg >= end)
+    {
+        return;
+    }
+    series->vtbl->prepare(series->self, beg, end);
+}
+
+void imgui_series_release(imgui_series_t* series)
+{
+    if (series->scratch != NULL)
+    {
+        free(series->scratch);
+        series->scratch = NULL;
+    }
+}
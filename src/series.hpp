@@ -0,0 +1,222 @@
+#ifndef __IMGUI_SERIES_HPP__
+#define __IMGUI_SERIES_HPP__
+
+#include <math.h>
+#include <autodo.h>
+#include <imgui.h>
+#include <limits>
+
+/**
+ * @brief Element type of a native series.
+ */
+typedef enum imgui_dtype
+{
+    IMGUI_DTYPE_I8,
+    IMGUI_DTYPE_U8,
+    IMGUI_DTYPE_I16,
+    IMGUI_DTYPE_U16,
+    IMGUI_DTYPE_I32,
+    IMGUI_DTYPE_U32,
+    IMGUI_DTYPE_I64,
+    IMGUI_DTYPE_U64,
+    IMGUI_DTYPE_F32,
+    IMGUI_DTYPE_F64,
+} imgui_dtype_t;
+
+struct imgui_series_vtbl;
+
+/**
+ * @brief A typed, strided view of numeric data.
+ *
+ * The view always describe the whole series, but only the range passed to
+ * #imgui_series_prepare() is guaranteed to be readable.
+ */
+typedef struct imgui_series
+{
+    const void*                     data;       /**< Address of element 0. */
+    size_t                          count;      /**< Number of elements. */
+    size_t                          offset;     /**< Ring offset in elements. */
+    size_t                          stride;     /**< Distance between elements in bytes. */
+    imgui_dtype_t                   type;       /**< Element type. */
+    uint64_t                        version;    /**< Data version, 0 if not tracked. See #imgui_series_next_version(). */
+
+    const struct imgui_series_vtbl* vtbl;       /**< Source type, NULL for Lua table. */
+    void*                           self;       /**< Source object. */
+    void*                           scratch;    /**< Temporary storage owned by this view. */
+} imgui_series_t;
+
+/**
+ * @brief Native series source.
+ *
+ * A userdata become a series source by calling #imgui_series_bind() on it.
+ */
+typedef struct imgui_series_vtbl
+{
+    /**
+     * @brief Source type name, for error message.
+     */
+    const char* name;
+
+    /**
+     * @brief Describe the whole series.
+     * @param[in] self      Source object.
+     * @param[out] series   Series view.
+     */
+    void (*view)(void* self, imgui_series_t* series);
+
+    /**
+     * @brief Make elements in range [beg, end) readable.
+     * @note Can be NULL if the whole series is always readable.
+     * @param[in] self      Source object.
+     * @param[in] beg       First element.
+     * @param[in] end       One past last element.
+     */
+    void (*prepare)(void* self, size_t beg, size_t end);
+} imgui_series_vtbl_t;
+
+/**
+ * @brief Visit series element type.
+ *
+ * `T` is defined as the element type of \p dtype in the body.
+ */
+#define IMGUI_DTYPE_DISPATCH(dtype, T, ...)  \
+    switch (dtype)\
+    {\
+    case IMGUI_DTYPE_I8:  { typedef ImS8 T;   __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_U8:  { typedef ImU8 T;   __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_I16: { typedef ImS16 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_U16: { typedef ImU16 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_I32: { typedef ImS32 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_U32: { typedef ImU32 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_I64: { typedef ImS64 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_U64: { typedef ImU64 T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_F32: { typedef float T;  __VA_ARGS__; } break;\
+    case IMGUI_DTYPE_F64: { typedef double T; __VA_ARGS__; } break;\
+    }
+
+/**
+ * @brief Convert to element type \p T, saturating at its range.
+ *
+ * Out of range conversion is undefined, and the maximum of 64-bit integers
+ * rounds up in double, so bounds are compared with `<=` and `>=`. NaN becomes
+ * 0 for integer types, NaN and infinity are kept for floating point types.
+ */
+template <typename T>
+static inline T imgui_dtype_cast(double v)
+{
+    if (v != v)
+    {
+        return std::numeric_limits<T>::is_integer ? (T)0 : (T)v;
+    }
+    if (!std::numeric_limits<T>::is_integer && isinf(v))
+    {
+        return (T)v;
+    }
+    if (v <= (double)std::numeric_limits<T>::lowest())
+    {
+        return std::numeric_limits<T>::lowest();
+    }
+    if (v >= (double)std::numeric_limits<T>::max())
+    {
+        return std::numeric_limits<T>::max();
+    }
+    return (T)v;
+}
+
+/**
+ * @brief Get element size in bytes.
+ * @param[in] type  Element type.
+ * @return          Size in bytes.
+ */
+AUTO_LOCAL size_t imgui_dtype_size(imgui_dtype_t type);
+
+/**
+ * @brief Parse element type name, like `"f64"` or `"i32"`.
+ * @param[in] name  Type name.
+ * @return          Element type, or -1 if not recognized.
+ */
+AUTO_LOCAL int imgui_dtype_parse(const char* name);
+
+/**
+ * @brief Checks whether the function argument \p arg is a element type name.
+ * @param[in] L     Lua VM.
+ * @param[in] arg   Argument index.
+ * @param[in] def   Default type if argument is absent.
+ * @return          Element type.
+ */
+AUTO_LOCAL imgui_dtype_t imgui_dtype_check(lua_State* L, int arg, imgui_dtype_t def);
+
+/**
+ * @brief Get a new data version.
+ *
+ * Versions are unique across all series sources, so a version identify both
+ * the source and its content, and can be used as cache key alone.
+ *
+ * @note MT-Safe
+ * @return  A version number, never 0.
+ */
+AUTO_LOCAL uint64_t imgui_series_next_version(void);
+
+/**
+ * @brief Read element \p idx as double.
+ * @param[in] series    Series view.
+ * @param[in] idx       Element index, ring offset not applied.
+ * @return              Element value.
+ */
+AUTO_LOCAL double imgui_series_get(const imgui_series_t* series, size_t idx);
+
+/**
+ * @brief Mark the userdata on top of stack as a series source.
+ * @param[in] L     Lua VM.
+ * @param[in] vtbl  Source type.
+ */
+AUTO_LOCAL void imgui_series_bind(lua_State* L, const imgui_series_vtbl_t* vtbl);
+
+/**
+ * @brief Checks whether the function argument \p arg is a series source.
+ *
+ * Lua table, native series source, and string of packed doubles in native
+ * byte order are accepted.
+ *
+ * @param[in] L         Lua VM.
+ * @param[in] arg       Argument index.
+ * @param[out] series   Series view. Must be released by #imgui_series_release().
+ */
+AUTO_LOCAL void imgui_series_check(lua_State* L, int arg, imgui_series_t* series);
+
+/**
+ * @brief Raise an error if the function argument \p arg is not a series
+ *   source, without converting it.
+ *
+ * Call on every series argument before #imgui_series_check(), so a bad
+ * argument does not leak views of previous arguments.
+ *
+ * @param[in] L     Lua VM.
+ * @param[in] arg   Argument index.
+ * @return          Source type, or NULL for Lua table and string.
+ */
+AUTO_LOCAL const imgui_series_vtbl_t* imgui_series_argcheck(lua_State* L, int arg);
+
+/**
+ * @brief Test whether the value at \p idx is a native series source.
+ * @param[in] L     Lua VM.
+ * @param[in] idx   Stack index.
+ * @return          Source type, or NULL.
+ */
+AUTO_LOCAL const imgui_series_vtbl_t* imgui_series_test(lua_State* L, int idx);
+
+/**
+ * @brief Make elements in range [beg, end) readable.
+ * @param[in] series    Series view.
+ * @param[in] beg       First element.
+ * @param[in] end       One past last element.
+ */
+AUTO_LOCAL void imgui_series_prepare(imgui_series_t* series, size_t beg, size_t end);
+
+/**
+ * @brief Release series view.
+ * @param[in] series    Series view.
+ */
+AUTO_LOCAL void imgui_series_release(imgui_series_t* series);
+
+#endif
@@ -0,0 +1,630 @@
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "stats.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define IMGUI_STATS_SSE2 1
+#endif
+
+/**
+ * @brief Elements processed by a single task.
+ */
+#define IMGUI_STATS_CHUNK           (1 << 16)
+
+/**
+ * @brief Maximum entries of per task histograms. Large histograms use fewer
+ *   tasks, and each task covers several chunks.
+ */
+#define IMGUI_STATS_HIST_SCRATCH    (1 << 22)
+
+/**
+ * @brief The number of bins used by quantile sketch.
+ */
+#define IMGUI_STATS_SKETCH_BINS     4096
+
+/**
+ * @brief The number of cached results.
+ */
+#define IMGUI_STATS_CACHE_SIZE      32
+
+typedef struct imgui_stats_acc
+{
+    double                  min;
+    double                  max;
+    double                  sum;
+} imgui_stats_acc_t;
+
+typedef struct imgui_stats_cache
+{
+    uint64_t                version;    /**< Series version. */
+    uint64_t                version2;   /**< Y series version for 2D histogram, 0 otherwise. */
+    uint64_t                tick;       /**< Last access time. */
+
+    int                     has_summary;
+    imgui_stats_t           summary;
+
+    int                     sorted;     /**< 1 if sorted, 0 if not, -1 if unknown. */
+
+    std::vector<uint32_t>   sketch;     /**< Quantile sketch, empty if not built. */
+
+    struct
+    {
+        double              x_lo;
+        double              x_hi;
+        size_t              x_bins;
+        double              y_lo;
+        double              y_hi;
+        size_t              y_bins;
+    } hist_key;
+    std::vector<double>     hist;       /**< Histogram, empty if not built. */
+} imgui_stats_cache_t;
+
+typedef struct imgui_stats_job
+{
+    const imgui_series_t*   series;
+    const imgui_series_t*   series2;
+    size_t                  count;
+    double                  mean;
+
+    double                  x_lo;
+    double                  x_hi;
+    size_t                  x_bins;
+    double                  y_lo;
+    double                  y_hi;
+    size_t                  y_bins;
+
+    std::vector<imgui_stats_acc_t>  accs;   /**< Per task reduction. */
+    std::vector<uint32_t>           counts; /**< Per task histogram. */
+    size_t                          counts_size;
+    size_t                          num_task;   /**< Histogram tasks, task `i` covers every `num_task`-th chunk from `i`. */
+} imgui_stats_job_t;
+
+static imgui_stats_cache_t  s_stats_cache[IMGUI_STATS_CACHE_SIZE];
+static uint64_t             s_stats_tick = 0;
+
+/**
+ * @brief Find cache entry, or recycle the least recently used one.
+ * @return  Cache entry, or NULL if series is not versioned.
+ */
+static imgui_stats_cache_t* _stats_cache(uint64_t version, uint64_t version2)
+{
+    if (version == 0)
+    {
+        return NULL;
+    }
+
+    imgui_stats_cache_t* lru = &s_stats_cache[0];
+    for (size_t i = 0; i < IMGUI_STATS_CACHE_SIZE; i++)
+    {
+        imgui_stats_cache_t* cache = &s_stats_cache[i];
+        if (cache->version == version && cache->version2 == version2)
+        {
+            cache->tick = ++s_stats_tick;
+            return cache;
+        }
+        lru = cache->tick < lru->tick ? cache : lru;
+    }
+
+    lru->version = version;
+    lru->version2 = version2;
+    lru->tick = ++s_stats_tick;
+    lru->has_summary = 0;
+    lru->sorted = -1;
+    lru->sketch.clear();
+    lru->hist.clear();
+    return lru;
+}
+
+static size_t _stats_num_task(size_t count)
+{
+    return (count + IMGUI_STATS_CHUNK - 1) / IMGUI_STATS_CHUNK;
+}
+
+static void _stats_task_range(const imgui_stats_job_t* job, size_t idx, size_t* beg, size_t* end)
+{
+    *beg = idx * IMGUI_STATS_CHUNK;
+    *end = *beg + IMGUI_STATS_CHUNK < job->count ? *beg + IMGUI_STATS_CHUNK : job->count;
+}
+
+/**
+ * @brief The number of histogram tasks, so that per task histograms of
+ *   \p counts_size entries stay within #IMGUI_STATS_HIST_SCRATCH.
+ */
+static size_t _stats_hist_num_task(size_t count, size_t counts_size)
+{
+    size_t num_task = _stats_num_task(count);
+    size_t limit = IMGUI_STATS_HIST_SCRATCH / counts_size;
+    limit = limit > 0 ? limit : 1;
+    return num_task < limit ? num_task : limit;
+}
+
+template <typename T>
+static void _stats_reduce_t(const char* p, size_t n, size_t stride, imgui_stats_acc_t* acc)
+{
+    double mn = acc->min, mx = acc->max, sum = acc->sum;
+    for (size_t i = 0; i < n; i++)
+    {
+        double v = (double)*(const T*)(p + i * stride);
+        mn = v < mn ? v : mn;
+        mx = v > mx ? v : mx;
+        sum += v;
+    }
+    acc->min = mn; acc->max = mx; acc->sum = sum;
+}
+
+#if defined(IMGUI_STATS_SSE2)
+
+static void _stats_reduce_sse2(__m128d* vmin, __m128d* vmax, __m128d* vsum, __m128d v)
+{
+    *vmin = _mm_min_pd(*vmin, v);
+    *vmax = _mm_max_pd(*vmax, v);
+    *vsum = _mm_add_pd(*vsum, v);
+}
+
+static void _stats_reduce_finish_sse2(__m128d vmin, __m128d vmax, __m128d vsum, imgui_stats_acc_t* acc)
+{
+    double tmin[2], tmax[2], tsum[2];
+    _mm_storeu_pd(tmin, vmin);
+    _mm_storeu_pd(tmax, vmax);
+    _mm_storeu_pd(tsum, vsum);
+
+    acc->min = tmin[0] < acc->min ? tmin[0] : acc->min;
+    acc->min = tmin[1] < acc->min ? tmin[1] : acc->min;
+    acc->max = tmax[0] > acc->max ? tmax[0] : acc->max;
+    acc->max = tmax[1] > acc->max ? tmax[1] : acc->max;
+    acc->sum += tsum[0] + tsum[1];
+}
+
+#endif
+
+static void _stats_reduce_f64(const double* p, size_t n, imgui_stats_acc_t* acc)
+{
+    size_t i = 0;
+#if defined(IMGUI_STATS_SSE2)
+    /* Two independent accumulators hide add latency */
+    __m128d vmin0 = _mm_set1_pd(acc->min), vmin1 = vmin0;
+    __m128d vmax0 = _mm_set1_pd(acc->max), vmax1 = vmax0;
+    __m128d vsum0 = _mm_setzero_pd(), vsum1 = vsum0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _stats_reduce_sse2(&vmin0, &vmax0, &vsum0, _mm_loadu_pd(p + i));
+        _stats_reduce_sse2(&vmin1, &vmax1, &vsum1, _mm_loadu_pd(p + i + 2));
+    }
+    _stats_reduce_finish_sse2(_mm_min_pd(vmin0, vmin1), _mm_max_pd(vmax0, vmax1),
+        _mm_add_pd(vsum0, vsum1), acc);
+#endif
+    _stats_reduce_t<double>((const char*)(p + i), n - i, sizeof(double), acc);
+}
+
+static void _stats_reduce_f32(const float* p, size_t n, imgui_stats_acc_t* acc)
+{
+    size_t i = 0;
+#if defined(IMGUI_STATS_SSE2)
+    /* Widen to double so the sum does not lose precision */
+    __m128d vmin0 = _mm_set1_pd(acc->min), vmin1 = vmin0;
+    __m128d vmax0 = _mm_set1_pd(acc->max), vmax1 = vmax0;
+    __m128d vsum0 = _mm_setzero_pd(), vsum1 = vsum0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(p + i);
+        _stats_reduce_sse2(&vmin0, &vmax0, &vsum0, _mm_cvtps_pd(v));
+        _stats_reduce_sse2(&vmin1, &vmax1, &vsum1, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    _stats_reduce_finish_sse2(_mm_min_pd(vmin0, vmin1), _mm_max_pd(vmax0, vmax1),
+        _mm_add_pd(vsum0, vsum1), acc);
+#endif
+    _stats_reduce_t<float>((const char*)(p + i), n - i, sizeof(float), acc);
+}
+
+template <typename T>
+static double _stats_sqdev_t(const char* p, size_t n, size_t stride, double mean)
+{
+    double sum = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double d = (double)*(const T*)(p + i * stride) - mean;
+        sum += d * d;
+    }
+    return sum;
+}
+
+static double _stats_sqdev_f64(const double* p, size_t n, double mean)
+{
+    size_t i = 0;
+    double sum = 0;
+#if defined(IMGUI_STATS_SSE2)
+    __m128d vmean = _mm_set1_pd(mean);
+    __m128d vsum0 = _mm_setzero_pd(), vsum1 = vsum0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(p + i), vmean);
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(p + i + 2), vmean);
+        vsum0 = _mm_add_pd(vsum0, _mm_mul_pd(d0, d0));
+        vsum1 = _mm_add_pd(vsum1, _mm_mul_pd(d1, d1));
+    }
+    double tmp[2];
+    _mm_storeu_pd(tmp, _mm_add_pd(vsum0, vsum1));
+    sum = tmp[0] + tmp[1];
+#endif
+    return sum + _stats_sqdev_t<double>((const char*)(p + i), n - i, sizeof(double), mean);
+}
+
+static void _stats_reduce_task(void* arg, size_t idx)
+{
+    imgui_stats_job_t* job = (imgui_stats_job_t*)arg;
+    const imgui_series_t* s = job->series;
+    imgui_stats_acc_t* acc = &job->accs[idx];
+    acc->min = DBL_MAX;
+    acc->max = -DBL_MAX;
+    acc->sum = 0;
+
+    size_t beg, end;
+    _stats_task_range(job, idx, &beg, &end);
+    const char* p = (const char*)s->data + beg * s->stride;
+
+    if (s->type == IMGUI_DTYPE_F64 && s->stride == sizeof(double))
+    {
+        _stats_reduce_f64((const double*)p, end - beg, acc);
+        return;
+    }
+    if (s->type == IMGUI_DTYPE_F32 && s->stride == sizeof(float))
+    {
+        _stats_reduce_f32((const float*)p, end - beg, acc);
+        return;
+    }
+    IMGUI_DTYPE_DISPATCH(s->type, T, _stats_reduce_t<T>(p, end - beg, s->stride, acc));
+}
+
+static void _stats_sqdev_task(void* arg, size_t idx)
+{
+    imgui_stats_job_t* job = (imgui_stats_job_t*)arg;
+    const imgui_series_t* s = job->series;
+
+    size_t beg, end;
+    _stats_task_range(job, idx, &beg, &end);
+    const char* p = (const char*)s->data + beg * s->stride;
+
+    if (s->type == IMGUI_DTYPE_F64 && s->stride == sizeof(double))
+    {
+        job->accs[idx].sum = _stats_sqdev_f64((const double*)p, end - beg, job->mean);
+        return;
+    }
+    IMGUI_DTYPE_DISPATCH(s->type, T,
+        job->accs[idx].sum = _stats_sqdev_t<T>(p, end - beg, s->stride, job->mean));
+}
+
+static void _stats_summary(const imgui_series_t* series, imgui_stats_t* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->count = series->count;
+    if (series->count == 0)
+    {
+        return;
+    }
+
+    imgui_stats_job_t job;
+    job.series = series;
+    job.count = series->count;
+
+    size_t num_task = _stats_num_task(series->count);
+    job.accs.resize(num_task);
+    imgui_pool_parallel(num_task, _stats_reduce_task, &job);
+
+    stats->min = DBL_MAX;
+    stats->max = -DBL_MAX;
+    for (size_t i = 0; i < num_task; i++)
+    {
+        stats->min = job.accs[i].min < stats->min ? job.accs[i].min : stats->min;
+        stats->max = job.accs[i].max > stats->max ? job.accs[i].max : stats->max;
+        stats->sum += job.accs[i].sum;
+    }
+    stats->mean = stats->sum / series->count;
+
+    /* Two-pass variance is more stable than sum of squares */
+    job.mean = stats->mean;
+    imgui_pool_parallel(num_task, _stats_sqdev_task, &job);
+
+    double sqdev = 0;
+    for (size_t i = 0; i < num_task; i++)
+    {
+        sqdev += job.accs[i].sum;
+    }
+    stats->variance = sqdev / series->count;
+}
+
+void imgui_stats_summary(const imgui_series_t* series, imgui_stats_t* stats)
+{
+    imgui_stats_cache_t* cache = _stats_cache(series->version, 0);
+    if (cache != NULL && cache->has_summary)
+    {
+        *stats = cache->summary;
+        return;
+    }
+
+    _stats_summary(series, stats);
+
+    if (cache != NULL)
+    {
+        cache->summary = *stats;
+        cache->has_summary = 1;
+    }
+}
+
+/**
+ * @brief Bin index of \p v, or \p bins if out of range.
+ */
+static size_t _stats_bin(double v, double lo, double hi, double scale, size_t bins)
+{
+    if (!(v >= lo && v <= hi))
+    {
+        return bins;
+    }
+    size_t b = (size_t)((v - lo) * scale);
+    return b < bins ? b : bins - 1;
+}
+
+template <typename T>
+static void _stats_hist_t(const char* p, size_t n, size_t stride, double lo, double hi,
+    size_t bins, uint32_t* counts)
+{
+    double scale = hi > lo ? bins / (hi - lo) : 0;
+
+    /*
+     * Four interleaved sub-histograms, so consecutive elements falling into
+     * the same bin do not serialize on the same counter.
+     */
+    for (size_t i = 0; i < n; i++)
+    {
+        double v = (double)*(const T*)(p + i * stride);
+        size_t b = _stats_bin(v, lo, hi, scale, bins);
+        if (b < bins)
+        {
+            counts[(i & 3) * bins + b]++;
+        }
+    }
+}
+
+static void _stats_hist_task(void* arg, size_t idx)
+{
+    imgui_stats_job_t* job = (imgui_stats_job_t*)arg;
+    const imgui_series_t* s = job->series;
+    uint32_t* counts = &job->counts[idx * job->counts_size];
+
+    for (size_t chunk = idx; chunk < _stats_num_task(job->count); chunk += job->num_task)
+    {
+        size_t beg, end;
+        _stats_task_range(job, chunk, &beg, &end);
+        const char* p = (const char*)s->data + beg * s->stride;
+
+        IMGUI_DTYPE_DISPATCH(s->type, T,
+            _stats_hist_t<T>(p, end - beg, s->stride, job->x_lo, job->x_hi, job->x_bins, counts));
+    }
+}
+
+/**
+ * @brief Build histogram of series.
+ * @param[out] counts   Must have \p bins entries.
+ */
+static void _stats_histogram(const imgui_series_t* series, double lo, double hi,
+    size_t bins, uint32_t* counts)
+{
+    imgui_stats_job_t job;
+    job.series = series;
+    job.count = series->count;
+    job.x_lo = lo;
+    job.x_hi = hi;
+    job.x_bins = bins;
+    job.counts_size = bins * 4;
+
+    size_t num_task = _stats_hist_num_task(series->count, job.counts_size);
+    job.num_task = num_task;
+    job.counts.assign(num_task * job.counts_size, 0);
+    imgui_pool_parallel(num_task, _stats_hist_task, &job);
+
+    memset(counts, 0, sizeof(uint32_t) * bins);
+    for (size_t i = 0; i < num_task * 4; i++)
+    {
+        const uint32_t* sub = &job.counts[i * bins];
+        for (size_t b = 0; b < bins; b++)
+        {
+            counts[b] += sub[b];
+        }
+    }
+}
+
+void imgui_stats_quantile(const imgui_series_t* series, const double* q, double* out, size_t n)
+{
+    imgui_stats_t stats;
+    imgui_stats_summary(series, &stats);
+
+    imgui_stats_cache_t* cache = _stats_cache(series->version, 0);
+    std::vector<uint32_t> local;
+    std::vector<uint32_t>* sketch = cache != NULL ? &cache->sketch : &local;
+    if (sketch->empty())
+    {
+        sketch->resize(IMGUI_STATS_SKETCH_BINS);
+        _stats_histogram(series, stats.min, stats.max, IMGUI_STATS_SKETCH_BINS, sketch->data());
+    }
+
+    double width = (stats.max - stats.min) / IMGUI_STATS_SKETCH_BINS;
+    for (size_t i = 0; i < n; i++)
+    {
+        double qi = q[i] < 0 ? 0 : (q[i] > 1 ? 1 : q[i]);
+        if (stats.count == 0)
+        {
+            out[i] = 0;
+            continue;
+        }
+        if (qi == 0 || qi == 1)
+        {
+            out[i] = qi == 0 ? stats.min : stats.max;
+            continue;
+        }
+
+        /* Interpolate inside the bin that contains the target rank */
+        double target = qi * stats.count;
+        double cum = 0;
+        size_t b = 0;
+        for (; b < IMGUI_STATS_SKETCH_BINS - 1 && cum + (*sketch)[b] < target; b++)
+        {
+            cum += (*sketch)[b];
+        }
+        double frac = (*sketch)[b] != 0 ? (target - cum) / (*sketch)[b] : 0.5;
+        out[i] = stats.min + (b + frac) * width;
+    }
+}
+
+void imgui_stats_histogram(const imgui_series_t* series, double lo, double hi,
+    size_t bins, double* counts)
+{
+    imgui_stats_cache_t* cache = _stats_cache(series->version, 0);
+    if (cache != NULL && cache->hist.size() == bins
+        && cache->hist_key.x_lo == lo && cache->hist_key.x_hi == hi)
+    {
+        memcpy(counts, cache->hist.data(), sizeof(double) * bins);
+        return;
+    }
+
+    std::vector<uint32_t> tmp(bins);
+    _stats_histogram(series, lo, hi, bins, tmp.data());
+    for (size_t b = 0; b < bins; b++)
+    {
+        counts[b] = tmp[b];
+    }
+
+    if (cache != NULL)
+    {
+        cache->hist.assign(counts, counts + bins);
+        cache->hist_key.x_lo = lo;
+        cache->hist_key.x_hi = hi;
+        cache->hist_key.x_bins = bins;
+    }
+}
+
+static void _stats_hist2d_task(void* arg, size_t idx)
+{
+    imgui_stats_job_t* job = (imgui_stats_job_t*)arg;
+    uint32_t* counts = &job->counts[idx * job->counts_size];
+
+    double x_scale = job->x_hi > job->x_lo ? job->x_bins / (job->x_hi - job->x_lo) : 0;
+    double y_scale = job->y_hi > job->y_lo ? job->y_bins / (job->y_hi - job->y_lo) : 0;
+    for (size_t chunk = idx; chunk < _stats_num_task(job->count); chunk += job->num_task)
+    {
+        size_t beg, end;
+        _stats_task_range(job, chunk, &beg, &end);
+
+        for (size_t i = beg; i < end; i++)
+        {
+            size_t xb = _stats_bin(imgui_series_get(job->series, i), job->x_lo, job->x_hi, x_scale, job->x_bins);
+            size_t yb = _stats_bin(imgui_series_get(job->series2, i), job->y_lo, job->y_hi, y_scale, job->y_bins);
+            if (xb < job->x_bins && yb < job->y_bins)
+            {
+                counts[(job->y_bins - 1 - yb) * job->x_bins + xb]++;
+            }
+        }
+    }
+}
+
+void imgui_stats_histogram2d(const imgui_series_t* xs, const imgui_series_t* ys,
+    double x_lo, double x_hi, size_t x_bins, double y_lo, double y_hi, size_t y_bins,
+    double* counts)
+{
+    size_t size = x_bins * y_bins;
+    imgui_stats_cache_t* cache = ys->version != 0 ? _stats_cache(xs->version, ys->version) : NULL;
+    if (cache != NULL && cache->hist.size() == size
+        && cache->hist_key.x_lo == x_lo && cache->hist_key.x_hi == x_hi && cache->hist_key.x_bins == x_bins
+        && cache->hist_key.y_lo == y_lo && cache->hist_key.y_hi == y_hi && cache->hist_key.y_bins == y_bins)
+    {
+        memcpy(counts, cache->hist.data(), sizeof(double) * size);
+        return;
+    }
+
+    imgui_stats_job_t job;
+    job.series = xs;
+    job.series2 = ys;
+    job.count = xs->count < ys->count ? xs->count : ys->count;
+    job.x_lo = x_lo; job.x_hi = x_hi; job.x_bins = x_bins;
+    job.y_lo = y_lo; job.y_hi = y_hi; job.y_bins = y_bins;
+    job.counts_size = size;
+
+    size_t num_task = _stats_hist_num_task(job.count, size);
+    job.num_task = num_task;
+    job.counts.assign(num_task * size, 0);
+    imgui_pool_parallel(num_task, _stats_hist2d_task, &job);
+
+    for (size_t b = 0; b < size; b++)
+    {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < num_task; i++)
+        {
+            sum += job.counts[i * size + b];
+        }
+        counts[b] = sum;
+    }
+
+    if (cache != NULL)
+    {
+        cache->hist.assign(counts, counts + size);
+        cache->hist_key.x_lo = x_lo; cache->hist_key.x_hi = x_hi; cache->hist_key.x_bins = x_bins;
+        cache->hist_key.y_lo = y_lo; cache->hist_key.y_hi = y_hi; cache->hist_key.y_bins = y_bins;
+    }
+}
+
+static void _stats_sorted_task(void* arg, size_t idx)
+{
+    imgui_stats_job_t* job = (imgui_stats_job_t*)arg;
+    const imgui_series_t* series = job->series;
+
+    /* Overlap one element with next chunk to check the boundary */
+    size_t beg, end;
+    _stats_task_range(job, idx, &beg, &end);
+    end = end < job->count ? end + 1 : end;
+
+    double prev = imgui_series_get(series, (beg + series->offset) % series->count);
+    uint32_t sorted = prev == prev;
+    for (size_t i = beg + 1; sorted && i < end; i++)
+    {
+        double v = imgui_series_get(series, (i + series->offset) % series->count);
+        sorted = v >= prev;
+        prev = v;
+    }
+    job->counts[idx] = sorted;
+}
+
+bool imgui_stats_sorted(const imgui_series_t* series)
+{
+    imgui_stats_cache_t* cache = _stats_cache(series->version, 0);
+    if (cache != NULL && cache->sorted >= 0)
+    {
+        return cache->sorted != 0;
+    }
+
+    imgui_stats_job_t job;
+    job.series = series;
+    job.count = series->count;
+
+    size_t num_task = _stats_num_task(job.count);
+    job.counts.assign(num_task, 0);
+    imgui_pool_parallel(num_task, _stats_sorted_task, &job);
+
+    bool sorted = true;
+    for (size_t i = 0; i < num_task; i++)
+    {
+        sorted = sorted && job.counts[i] != 0;
+    }
+
+    if (cache != NULL)
+    {
+        cache->sorted = sorted;
+    }
+    return sorted;
+}
+
+size_t imgui_stats_sturges(size_t count)
+{
+    return count > 1 ? (size_t)ceil(log2((double)count)) + 1 : 1;
+}
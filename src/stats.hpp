@@ -0,0 +1,101 @@
+#ifndef __IMGUI_STATS_HPP__
+#define __IMGUI_STATS_HPP__
+
+#include "series.hpp"
+
+/**
+ * @brief Maximum number of histogram bins, or cells of 2D histogram.
+ */
+#define IMGUI_STATS_BINS_MAX    (1 << 20)
+
+/**
+ * @brief Summary statistics of a series.
+ */
+typedef struct imgui_stats
+{
+    size_t      count;      /**< The number of elements. */
+    double      min;        /**< Minimum value, 0 if empty. */
+    double      max;        /**< Maximum value, 0 if empty. */
+    double      sum;        /**< Sum of elements. */
+    double      mean;       /**< Arithmetic mean. */
+    double      variance;   /**< Population variance. */
+} imgui_stats_t;
+
+/**
+ * @brief Compute summary statistics.
+ *
+ * Result of native series is cached by version.
+ *
+ * @param[in] series    Series view, must be fully prepared.
+ * @param[out] stats    Summary statistics.
+ */
+AUTO_LOCAL void imgui_stats_summary(const imgui_series_t* series, imgui_stats_t* stats);
+
+/**
+ * @brief Estimate quantiles from a histogram sketch.
+ *
+ * The error is bounded by `(max - min) / 4096`. Result of native series is
+ * cached by version.
+ *
+ * @param[in] series    Series view, must be fully prepared.
+ * @param[in] q         Quantiles in range [0, 1].
+ * @param[out] out      Estimated values.
+ * @param[in] n         The number of quantiles.
+ */
+AUTO_LOCAL void imgui_stats_quantile(const imgui_series_t* series, const double* q, double* out, size_t n);
+
+/**
+ * @brief Count elements in \p bins equal width bins over [lo, hi].
+ *
+ * Elements outside range are ignored. Result of native series is cached by
+ * version.
+ *
+ * @param[in] series    Series view, must be fully prepared.
+ * @param[in] lo        Range minimum.
+ * @param[in] hi        Range maximum.
+ * @param[in] bins      The number of bins, at most #IMGUI_STATS_BINS_MAX.
+ * @param[out] counts   Counts of each bin.
+ */
+AUTO_LOCAL void imgui_stats_histogram(const imgui_series_t* series, double lo, double hi,
+    size_t bins, double* counts);
+
+/**
+ * @brief Count element pairs in a 2D grid of bins.
+ *
+ * The result is row-major and row 0 is the highest Y bin, which is the same
+ * layout as a heatmap. Result of native series is cached by version.
+ *
+ * @param[in] xs        X series, must be fully prepared.
+ * @param[in] ys        Y series, must be fully prepared.
+ * @param[in] x_lo      X range minimum.
+ * @param[in] x_hi      X range maximum.
+ * @param[in] x_bins    The number of X bins.
+ * @param[in] y_lo      Y range minimum.
+ * @param[in] y_hi      Y range maximum.
+ * @param[in] y_bins    The number of Y bins.
+ * @param[out] counts   Counts of each bin, `x_bins * y_bins` entries, which is at
+ *   most #IMGUI_STATS_BINS_MAX.
+ */
+AUTO_LOCAL void imgui_stats_histogram2d(const imgui_series_t* xs, const imgui_series_t* ys,
+    double x_lo, double x_hi, size_t x_bins, double y_lo, double y_hi, size_t y_bins,
+    double* counts);
+
+/**
+ * @brief Check whether series is sorted in non-descending order.
+ *
+ * Ring offset is applied, and NaN is never sorted. Result of native series
+ * is cached by version.
+ *
+ * @param[in] series    Series view, must be fully prepared.
+ * @return              Whether series is sorted.
+ */
+AUTO_LOCAL bool imgui_stats_sorted(const imgui_series_t* series);
+
+/**
+ * @brief Default number of histogram bins by Sturges' rule.
+ * @param[in] count     The number of elements.
+ * @return              The number of bins.
+ */
+AUTO_LOCAL size_t imgui_stats_sturges(size_t count);
+
+#endif
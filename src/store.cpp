@@ -0,0 +1,241 @@
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "store.hpp"
+
+struct imgui_store_slot
+{
+    std::string                 name;
+    imgui_store_type_t          type;
+    size_t                      capacity;   /**< Elements of array, or bytes of string. */
+    size_t                      nwords;     /**< Words of #words. */
+
+    std::atomic_flag            writer;     /**< Serialize writers. */
+    std::atomic<uint64_t>       seq;        /**< Odd while a write is in progress. */
+    std::atomic<uint64_t>       size;       /**< Valid elements or bytes. */
+    std::atomic<uint64_t>*      words;      /**< Value, accessed word by word so readers never race. */
+};
+
+typedef struct imgui_store
+{
+    std::mutex                                          mutex;  /**< Protect #slots, only taken to create or find. */
+    std::unordered_map<std::string, imgui_store_slot_t*> slots;  /**< Never freed, producers keep their handles. */
+} imgui_store_t;
+
+static imgui_store_t s_store;
+
+static imgui_store_slot_t* _store_create(const char* name, imgui_store_type_t type, size_t capacity)
+{
+    switch (type)
+    {
+    case IMGUI_STORE_NUMBER:
+    case IMGUI_STORE_INTEGER:
+        capacity = 1;
+        break;
+
+    case IMGUI_STORE_ARRAY:
+    case IMGUI_STORE_STRING:
+        break;
+
+    default:
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> guard(s_store.mutex);
+
+    auto it = s_store.slots.find(name);
+    if (it != s_store.slots.end())
+    {
+        imgui_store_slot_t* slot = it->second;
+        return slot->type == type && slot->capacity == capacity ? slot : NULL;
+    }
+
+    imgui_store_slot_t* slot = new imgui_store_slot_t;
+    slot->name = name;
+    slot->type = type;
+    slot->capacity = capacity;
+    slot->nwords = type == IMGUI_STORE_STRING ? (capacity + 7) / 8 : capacity;
+    slot->writer.clear();
+    slot->seq = 0;
+    slot->size = type == IMGUI_STORE_NUMBER || type == IMGUI_STORE_INTEGER ? 1 : 0;
+    slot->words = new std::atomic<uint64_t>[slot->nwords ? slot->nwords : 1];
+    for (size_t i = 0; i < slot->nwords; i++)
+    {
+        slot->words[i].store(0, std::memory_order_relaxed);
+    }
+
+    s_store.slots[name] = slot;
+    return slot;
+}
+
+/**
+ * @brief Begin a write. Readers see an odd sequence until #_store_write_end().
+ */
+static void _store_write_begin(imgui_store_slot_t* slot)
+{
+    while (slot->writer.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+
+    uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void _store_write_end(imgui_store_slot_t* slot)
+{
+    uint64_t seq = slot->seq.load(std::memory_order_relaxed);
+    slot->seq.store(seq + 1, std::memory_order_release);
+    slot->writer.clear(std::memory_order_release);
+}
+
+static void _store_set_word(imgui_store_slot_t* slot, imgui_store_type_t type, uint64_t word)
+{
+    if (slot == NULL || slot->type != type)
+    {
+        return;
+    }
+
+    _store_write_begin(slot);
+    slot->words[0].store(word, std::memory_order_relaxed);
+    _store_write_end(slot);
+}
+
+static void _store_set_number(imgui_store_slot_t* slot, double value)
+{
+    uint64_t word;
+    memcpy(&word, &value, sizeof(word));
+    _store_set_word(slot, IMGUI_STORE_NUMBER, word);
+}
+
+static void _store_set_integer(imgui_store_slot_t* slot, int64_t value)
+{
+    _store_set_word(slot, IMGUI_STORE_INTEGER, (uint64_t)value);
+}
+
+static void _store_add_integer(imgui_store_slot_t* slot, int64_t delta)
+{
+    if (slot == NULL || slot->type != IMGUI_STORE_INTEGER)
+    {
+        return;
+    }
+
+    /* Writers are serialized, so read-modify-write is safe */
+    _store_write_begin(slot);
+    uint64_t value = slot->words[0].load(std::memory_order_relaxed);
+    slot->words[0].store(value + (uint64_t)delta, std::memory_order_relaxed);
+    _store_write_end(slot);
+}
+
+static void _store_set_array(imgui_store_slot_t* slot, const double* data, size_t n)
+{
+    if (slot == NULL || slot->type != IMGUI_STORE_ARRAY)
+    {
+        return;
+    }
+    n = n < slot->capacity ? n : slot->capacity;
+
+    _store_write_begin(slot);
+    for (size_t i = 0; i < n; i++)
+    {
+        uint64_t word;
+        memcpy(&word, &data[i], sizeof(word));
+        slot->words[i].store(word, std::memory_order_relaxed);
+    }
+    slot->size.store(n, std::memory_order_relaxed);
+    _store_write_end(slot);
+}
+
+static void _store_set_string(imgui_store_slot_t* slot, const char* str, size_t len)
+{
+    if (slot == NULL || slot->type != IMGUI_STORE_STRING)
+    {
+        return;
+    }
+    len = len < slot->capacity ? len : slot->capacity;
+
+    _store_write_begin(slot);
+    for (size_t off = 0; off < len; off += 8)
+    {
+        uint64_t word = 0;
+        memcpy(&word, str + off, len - off < 8 ? len - off : 8);
+        slot->words[off / 8].store(word, std::memory_order_relaxed);
+    }
+    slot->size.store(len, std::memory_order_relaxed);
+    _store_write_end(slot);
+}
+
+const imgui_store_api_t* imgui_store_api(void)
+{
+    static const imgui_store_api_t s_api = {
+        _store_create,
+        _store_set_number,
+        _store_set_integer,
+        _store_add_integer,
+        _store_set_array,
+        _store_set_string,
+    };
+    return &s_api;
+}
+
+imgui_store_slot_t* imgui_store_find(const char* name)
+{
+    std::lock_guard<std::mutex> guard(s_store.mutex);
+    auto it = s_store.slots.find(name);
+    return it != s_store.slots.end() ? it->second : NULL;
+}
+
+void imgui_store_names(std::vector<std::string>& names)
+{
+    std::lock_guard<std::mutex> guard(s_store.mutex);
+    for (auto& it : s_store.slots)
+    {
+        names.push_back(it.first);
+    }
+}
+
+imgui_store_type_t imgui_store_type(const imgui_store_slot_t* slot)
+{
+    return slot->type;
+}
+
+size_t imgui_store_words(const imgui_store_slot_t* slot)
+{
+    return slot->nwords;
+}
+
+uint64_t imgui_store_version(const imgui_store_slot_t* slot)
+{
+    return slot->seq.load(std::memory_order_acquire) / 2;
+}
+
+uint64_t imgui_store_read(const imgui_store_slot_t* slot, uint64_t* words, size_t* size)
+{
+    for (;;)
+    {
+        uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        if (seq & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        size_t n = (size_t)slot->size.load(std::memory_order_relaxed);
+        size_t nwords = slot->type == IMGUI_STORE_STRING ? (n + 7) / 8 : n;
+        nwords = nwords < slot->nwords ? nwords : slot->nwords;
+        for (size_t i = 0; i < nwords; i++)
+        {
+            words[i] = slot->words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) == seq)
+        {
+            *size = n;
+            return seq / 2;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef __IMGUI_STORE_HPP__
+#define __IMGUI_STORE_HPP__
+
+#include <imgui_store.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Find slot by name.
+ * @param[in] name      Slot name.
+ * @return              Slot handle, or NULL if not created.
+ */
+AUTO_LOCAL imgui_store_slot_t* imgui_store_find(const char* name);
+
+/**
+ * @brief Get names of all slots.
+ * @param[out] names    Names are appended.
+ */
+AUTO_LOCAL void imgui_store_names(std::vector<std::string>& names);
+
+/**
+ * @brief Get slot value type.
+ * @param[in] slot      Slot handle.
+ * @return              Value type.
+ */
+AUTO_LOCAL imgui_store_type_t imgui_store_type(const imgui_store_slot_t* slot);
+
+/**
+ * @brief Get the number of 64-bit words of slot value.
+ * @param[in] slot      Slot handle.
+ * @return              Words needed by #imgui_store_read().
+ */
+AUTO_LOCAL size_t imgui_store_words(const imgui_store_slot_t* slot);
+
+/**
+ * @brief Get the number of completed writes, without reading value.
+ * @note Lock free.
+ * @param[in] slot      Slot handle.
+ * @return              Write count.
+ */
+AUTO_LOCAL uint64_t imgui_store_version(const imgui_store_slot_t* slot);
+
+/**
+ * @brief Read a consistent copy of slot value.
+ * @note Lock free. Retry while a write is in progress.
+ * @param[in] slot      Slot handle.
+ * @param[out] words    Value, at least #imgui_store_words() words.
+ * @param[out] size     Elements of array, or bytes of string. 1 for scalars.
+ * @return              Write count of the copy.
+ */
+AUTO_LOCAL uint64_t imgui_store_read(const imgui_store_slot_t* slot, uint64_t* words, size_t* size);
+
+#endif
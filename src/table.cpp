@@ -0,0 +1,483 @@
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include "table.hpp"
+#include "thread_pool.hpp"
+
+#define IMGUI_TABLE_CHUNK_SHIFT     12
+#define IMGUI_TABLE_CHUNK_ROWS      ((size_t)1 << IMGUI_TABLE_CHUNK_SHIFT)
+#define IMGUI_TABLE_ARENA_BLOCK     (64 * 1024)
+#define IMGUI_TABLE_SORT_GRAIN      16384
+
+/**
+ * @brief Row and string storage. Shared with running job, so clearing table
+ *   replaces it instead of freeing.
+ */
+typedef struct imgui_table_store
+{
+    std::atomic<int>                    refcnt;
+    std::vector<imgui_table_cell_t*>    chunks;     /**< #IMGUI_TABLE_CHUNK_ROWS rows each, row-major. */
+    std::vector<char*>                  blocks;     /**< String arena. */
+    size_t                              block_left; /**< Free bytes in last block. */
+} imgui_table_store_t;
+
+struct imgui_table
+{
+    std::vector<imgui_table_column_t>   columns;
+    imgui_table_store_t*                store;
+    size_t                              rows;
+
+    /* Lua thread */
+    std::vector<imgui_table_key_t>      keys;       /**< Requested sort keys. */
+    std::string                         filter;     /**< Requested filter, lower case. */
+    int                                 filter_col; /**< Filter column, or -1 for all string columns. */
+    bool                                dirty;      /**< Query or rows changed since last job started. */
+    bool                                has_view;   /**< Whether #view is displayed instead of insertion order. */
+    std::vector<uint32_t>               view;       /**< Displayed rows. */
+
+    /* Shared with job, protected by #mutex */
+    std::mutex                          mutex;
+    std::atomic<int>                    refcnt;
+    bool                                running;    /**< Whether a job is running. */
+    bool                                ready;      /**< Whether #result is not published yet. */
+    uint64_t                            generation; /**< Generation of last started job. */
+    uint64_t                            result_generation;
+    std::vector<uint32_t>               result;
+};
+
+typedef struct imgui_table_job
+{
+    imgui_table_t*                      table;
+    imgui_table_store_t*                store;
+    std::vector<imgui_table_cell_t*>    chunks;     /**< Snapshot, appending may grow store chunk list. */
+    size_t                              rows;
+    std::vector<imgui_table_type_t>     types;
+    std::vector<imgui_table_key_t>      keys;
+    std::string                         filter;
+    int                                 filter_col;
+    uint64_t                            generation;
+
+    std::vector<uint32_t>               index;
+    std::vector<std::vector<uint32_t> > parts;      /**< Filter result of each chunk. */
+    std::vector<size_t>                 bounds;     /**< Sort run boundaries. */
+    size_t                              width;      /**< Runs on each side of a merge in current round. */
+} imgui_table_job_t;
+
+static void _table_store_unref(imgui_table_store_t* store)
+{
+    if (store->refcnt.fetch_sub(1) != 1)
+    {
+        return;
+    }
+    for (size_t i = 0; i < store->chunks.size(); i++)
+    {
+        free(store->chunks[i]);
+    }
+    for (size_t i = 0; i < store->blocks.size(); i++)
+    {
+        free(store->blocks[i]);
+    }
+    delete store;
+}
+
+static imgui_table_store_t* _table_store_new(void)
+{
+    imgui_table_store_t* store = new imgui_table_store_t;
+    store->refcnt = 1;
+    store->block_left = 0;
+    return store;
+}
+
+static void _table_unref(imgui_table_t* table)
+{
+    if (table->refcnt.fetch_sub(1) == 1)
+    {
+        _table_store_unref(table->store);
+        delete table;
+    }
+}
+
+/*
+ * Worker threads.
+ */
+
+static const imgui_table_cell_t* _table_job_at(const imgui_table_job_t* job, size_t row, size_t col)
+{
+    const imgui_table_cell_t* chunk = job->chunks[row >> IMGUI_TABLE_CHUNK_SHIFT];
+    return chunk + (row & (IMGUI_TABLE_CHUNK_ROWS - 1)) * job->types.size() + col;
+}
+
+/**
+ * @brief Find lower case \p needle in \p str ignoring ASCII case.
+ */
+static bool _table_contains(const char* str, size_t len, const std::string& needle)
+{
+    if (needle.size() > len)
+    {
+        return false;
+    }
+    for (size_t i = 0; i + needle.size() <= len; i++)
+    {
+        size_t j = 0;
+        while (j < needle.size() && tolower((unsigned char)str[i + j]) == needle[j])
+        {
+            j++;
+        }
+        if (j == needle.size())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _table_job_match(const imgui_table_job_t* job, size_t row)
+{
+    for (size_t col = 0; col < job->types.size(); col++)
+    {
+        if (job->types[col] != IMGUI_TABLE_STRING || (job->filter_col >= 0 && (size_t)job->filter_col != col))
+        {
+            continue;
+        }
+        const imgui_table_cell_t* cell = _table_job_at(job, row, col);
+        if (_table_contains(cell->s.ptr, cell->s.len, job->filter))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _table_filter_task(void* arg, size_t idx)
+{
+    imgui_table_job_t* job = (imgui_table_job_t*)arg;
+    size_t beg = idx * IMGUI_TABLE_CHUNK_ROWS;
+    size_t end = std::min(beg + IMGUI_TABLE_CHUNK_ROWS, job->rows);
+
+    for (size_t row = beg; row < end; row++)
+    {
+        if (_table_job_match(job, row))
+        {
+            job->parts[idx].push_back((uint32_t)row);
+        }
+    }
+}
+
+static int _table_compare_cell(imgui_table_type_t type, const imgui_table_cell_t* a, const imgui_table_cell_t* b)
+{
+    switch (type)
+    {
+    case IMGUI_TABLE_INTEGER:
+        return a->i < b->i ? -1 : (a->i > b->i ? 1 : 0);
+
+    case IMGUI_TABLE_NUMBER:
+        /* NaN is greater than any number, so ordering stays strict weak */
+        if (isnan(a->f) || isnan(b->f))
+        {
+            return (int)isnan(a->f) - (int)isnan(b->f);
+        }
+        return a->f < b->f ? -1 : (a->f > b->f ? 1 : 0);
+
+    case IMGUI_TABLE_STRING:
+    {
+        int ret = memcmp(a->s.ptr, b->s.ptr, std::min(a->s.len, b->s.len));
+        if (ret != 0)
+        {
+            return ret;
+        }
+        return a->s.len < b->s.len ? -1 : (a->s.len > b->s.len ? 1 : 0);
+    }
+    }
+    return 0;
+}
+
+struct imgui_table_less
+{
+    const imgui_table_job_t* job;
+
+    bool operator()(uint32_t a, uint32_t b) const
+    {
+        for (size_t i = 0; i < job->keys.size(); i++)
+        {
+            const imgui_table_key_t& key = job->keys[i];
+            int ret = _table_compare_cell(job->types[key.column],
+                _table_job_at(job, a, key.column), _table_job_at(job, b, key.column));
+            if (ret != 0)
+            {
+                return key.descending ? ret > 0 : ret < 0;
+            }
+        }
+        return false;
+    }
+};
+
+static void _table_sort_task(void* arg, size_t idx)
+{
+    imgui_table_job_t* job = (imgui_table_job_t*)arg;
+    imgui_table_less less = { job };
+    std::stable_sort(job->index.begin() + job->bounds[idx], job->index.begin() + job->bounds[idx + 1], less);
+}
+
+static void _table_merge_task(void* arg, size_t idx)
+{
+    imgui_table_job_t* job = (imgui_table_job_t*)arg;
+    const size_t runs = job->bounds.size() - 1;
+    size_t first = idx * job->width * 2;
+    size_t middle = std::min(first + job->width, runs);
+    size_t last = std::min(first + job->width * 2, runs);
+
+    imgui_table_less less = { job };
+    std::inplace_merge(job->index.begin() + job->bounds[first], job->index.begin() + job->bounds[middle],
+        job->index.begin() + job->bounds[last], less);
+}
+
+/**
+ * @brief Sort runs in parallel, then merge pairs of runs in parallel rounds.
+ */
+static void _table_job_sort(imgui_table_job_t* job)
+{
+    const size_t n = job->index.size();
+    size_t runs = std::min(imgui_pool_concurrency() + 1, (n + IMGUI_TABLE_SORT_GRAIN - 1) / IMGUI_TABLE_SORT_GRAIN);
+    runs = runs > 0 ? runs : 1;
+
+    job->bounds.resize(runs + 1);
+    for (size_t i = 0; i <= runs; i++)
+    {
+        job->bounds[i] = n * i / runs;
+    }
+    imgui_pool_parallel(runs, _table_sort_task, job);
+
+    for (job->width = 1; job->width < runs; job->width *= 2)
+    {
+        imgui_pool_parallel((runs + job->width * 2 - 1) / (job->width * 2), _table_merge_task, job);
+    }
+}
+
+static void _table_job_task(void* arg)
+{
+    imgui_table_job_t* job = (imgui_table_job_t*)arg;
+
+    if (job->filter.empty())
+    {
+        job->index.resize(job->rows);
+        std::iota(job->index.begin(), job->index.end(), 0);
+    }
+    else
+    {
+        size_t num_chunk = (job->rows + IMGUI_TABLE_CHUNK_ROWS - 1) / IMGUI_TABLE_CHUNK_ROWS;
+        job->parts.resize(num_chunk);
+        imgui_pool_parallel(num_chunk, _table_filter_task, job);
+
+        size_t total = 0;
+        for (size_t i = 0; i < num_chunk; i++)
+        {
+            total += job->parts[i].size();
+        }
+        job->index.reserve(total);
+        for (size_t i = 0; i < num_chunk; i++)
+        {
+            job->index.insert(job->index.end(), job->parts[i].begin(), job->parts[i].end());
+        }
+        job->parts.clear();
+    }
+
+    if (!job->keys.empty())
+    {
+        _table_job_sort(job);
+    }
+
+    imgui_table_t* table = job->table;
+    {
+        std::lock_guard<std::mutex> guard(table->mutex);
+        table->result.swap(job->index);
+        table->result_generation = job->generation;
+        table->ready = true;
+        table->running = false;
+    }
+
+    _table_store_unref(job->store);
+    _table_unref(table);
+    delete job;
+}
+
+/*
+ * Lua thread.
+ */
+
+static void _table_start_job(imgui_table_t* table)
+{
+    imgui_table_job_t* job = new imgui_table_job_t;
+    job->table = table;
+    job->store = table->store;
+    job->chunks = table->store->chunks;
+    job->rows = table->rows;
+    job->keys = table->keys;
+    job->filter = table->filter;
+    job->filter_col = table->filter_col;
+    job->width = 0;
+    for (size_t i = 0; i < table->columns.size(); i++)
+    {
+        job->types.push_back(table->columns[i].type);
+    }
+
+    table->refcnt++;
+    table->store->refcnt++;
+    table->dirty = false;
+    {
+        std::lock_guard<std::mutex> guard(table->mutex);
+        table->running = true;
+        job->generation = ++table->generation;
+    }
+
+    imgui_pool_submit(_table_job_task, job);
+}
+
+imgui_table_t* imgui_table_create(const std::vector<imgui_table_column_t>& columns)
+{
+    imgui_table_t* table = new imgui_table_t;
+    table->columns = columns;
+    table->store = _table_store_new();
+    table->rows = 0;
+    table->filter_col = -1;
+    table->dirty = false;
+    table->has_view = false;
+    table->refcnt = 1;
+    table->running = false;
+    table->ready = false;
+    table->generation = 0;
+    table->result_generation = 0;
+    return table;
+}
+
+void imgui_table_release(imgui_table_t* table)
+{
+    _table_unref(table);
+}
+
+const std::vector<imgui_table_column_t>& imgui_table_columns(const imgui_table_t* table)
+{
+    return table->columns;
+}
+
+size_t imgui_table_rows(const imgui_table_t* table)
+{
+    return table->rows;
+}
+
+imgui_table_cell_t* imgui_table_append(imgui_table_t* table)
+{
+    imgui_table_store_t* store = table->store;
+    const size_t ncol = table->columns.size();
+    size_t chunk = table->rows >> IMGUI_TABLE_CHUNK_SHIFT;
+    if (chunk == store->chunks.size())
+    {
+        store->chunks.push_back((imgui_table_cell_t*)calloc(IMGUI_TABLE_CHUNK_ROWS * ncol,
+            sizeof(imgui_table_cell_t)));
+    }
+
+    imgui_table_cell_t* cells = store->chunks[chunk] + (table->rows & (IMGUI_TABLE_CHUNK_ROWS - 1)) * ncol;
+    table->rows++;
+    table->dirty = true;
+    return cells;
+}
+
+const char* imgui_table_intern(imgui_table_t* table, const char* str, size_t len)
+{
+    imgui_table_store_t* store = table->store;
+
+    /* Long string gets its own block so the current block is not wasted */
+    if (len > IMGUI_TABLE_ARENA_BLOCK / 4)
+    {
+        char* block = (char*)malloc(len ? len : 1);
+        memcpy(block, str, len);
+        store->blocks.insert(store->blocks.end() - (store->blocks.empty() ? 0 : 1), block);
+        return block;
+    }
+
+    if (len > store->block_left)
+    {
+        store->blocks.push_back((char*)malloc(IMGUI_TABLE_ARENA_BLOCK));
+        store->block_left = IMGUI_TABLE_ARENA_BLOCK;
+    }
+    char* dst = store->blocks.back() + IMGUI_TABLE_ARENA_BLOCK - store->block_left;
+    memcpy(dst, str, len);
+    store->block_left -= len;
+    return dst;
+}
+
+const imgui_table_cell_t* imgui_table_at(const imgui_table_t* table, size_t row, size_t col)
+{
+    const imgui_table_cell_t* chunk = table->store->chunks[row >> IMGUI_TABLE_CHUNK_SHIFT];
+    return chunk + (row & (IMGUI_TABLE_CHUNK_ROWS - 1)) * table->columns.size() + col;
+}
+
+void imgui_table_clear(imgui_table_t* table)
+{
+    _table_store_unref(table->store);
+    table->store = _table_store_new();
+    table->rows = 0;
+    table->dirty = true;
+    table->has_view = false;
+    table->view.clear();
+
+    /* Drop result of running job */
+    std::lock_guard<std::mutex> guard(table->mutex);
+    table->generation++;
+}
+
+void imgui_table_sort(imgui_table_t* table, const std::vector<imgui_table_key_t>& keys)
+{
+    table->keys = keys;
+    table->dirty = true;
+}
+
+void imgui_table_filter(imgui_table_t* table, const char* text, int column)
+{
+    std::string filter(text);
+    for (size_t i = 0; i < filter.size(); i++)
+    {
+        filter[i] = (char)tolower((unsigned char)filter[i]);
+    }
+    if (filter != table->filter || column != table->filter_col)
+    {
+        table->filter = filter;
+        table->filter_col = column;
+        table->dirty = true;
+    }
+}
+
+bool imgui_table_view(imgui_table_t* table, const uint32_t** index, size_t* count)
+{
+    const bool trivial = table->keys.empty() && table->filter.empty();
+    bool running;
+    {
+        std::lock_guard<std::mutex> guard(table->mutex);
+        if (table->ready && table->result_generation == table->generation && !trivial)
+        {
+            table->view.swap(table->result);
+            table->has_view = true;
+        }
+        table->ready = false;
+        running = table->running;
+    }
+
+    if (trivial)
+    {
+        table->has_view = false;
+        table->dirty = false;
+    }
+    else if (table->dirty && !running)
+    {
+        _table_start_job(table);
+        running = true;
+    }
+
+    *index = table->has_view ? table->view.data() : NULL;
+    *count = table->has_view ? table->view.size() : table->rows;
+    return running;
+}
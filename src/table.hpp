@@ -0,0 +1,144 @@
+#ifndef __IMGUI_TABLE_HPP__
+#define __IMGUI_TABLE_HPP__
+
+#include <autodo.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Column value type.
+ */
+typedef enum imgui_table_type
+{
+    IMGUI_TABLE_INTEGER,    /**< 64-bit signed integer. */
+    IMGUI_TABLE_NUMBER,     /**< Double. */
+    IMGUI_TABLE_STRING,     /**< String in table arena. */
+} imgui_table_type_t;
+
+typedef union imgui_table_cell
+{
+    int64_t             i;
+    double              f;
+    struct
+    {
+        const char*     ptr;    /**< Never moves until table is cleared. */
+        size_t          len;
+    } s;
+} imgui_table_cell_t;
+
+typedef struct imgui_table_column
+{
+    std::string         name;
+    std::string         format; /**< printf format of numeric column. */
+    imgui_table_type_t  type;
+} imgui_table_column_t;
+
+/**
+ * @brief Sort key.
+ */
+typedef struct imgui_table_key
+{
+    size_t              column;
+    bool                descending;
+} imgui_table_key_t;
+
+/**
+ * @brief Columnar table with asynchronous sorted and filtered view.
+ *
+ * All functions must be called from the Lua thread. Sort and filter run on
+ * worker threads over rows that exist when they start. Rows are stored in
+ * chunks that never move, so appending does not disturb a running job.
+ */
+typedef struct imgui_table imgui_table_t;
+
+/**
+ * @brief Create table.
+ * @param[in] columns   Column definitions.
+ * @return              Table object.
+ */
+AUTO_LOCAL imgui_table_t* imgui_table_create(const std::vector<imgui_table_column_t>& columns);
+
+/**
+ * @brief Release table. A running job keeps data alive until it finishes.
+ * @param[in] table     Table object.
+ */
+AUTO_LOCAL void imgui_table_release(imgui_table_t* table);
+
+/**
+ * @brief Get column definitions.
+ * @param[in] table     Table object.
+ * @return              Column definitions.
+ */
+AUTO_LOCAL const std::vector<imgui_table_column_t>& imgui_table_columns(const imgui_table_t* table);
+
+/**
+ * @brief Get the number of rows.
+ * @param[in] table     Table object.
+ * @return              The number of rows.
+ */
+AUTO_LOCAL size_t imgui_table_rows(const imgui_table_t* table);
+
+/**
+ * @brief Append a row.
+ * @param[in] table     Table object.
+ * @return              Cells of new row, fill all of them. Use
+ *   #imgui_table_intern() for strings.
+ */
+AUTO_LOCAL imgui_table_cell_t* imgui_table_append(imgui_table_t* table);
+
+/**
+ * @brief Copy string into table arena.
+ * @param[in] table     Table object.
+ * @param[in] str       String.
+ * @param[in] len       Length in bytes.
+ * @return              Copy of string.
+ */
+AUTO_LOCAL const char* imgui_table_intern(imgui_table_t* table, const char* str, size_t len);
+
+/**
+ * @brief Get cell.
+ * @param[in] table     Table object.
+ * @param[in] row       Row index in insertion order.
+ * @param[in] col       Column index.
+ * @return              Cell.
+ */
+AUTO_LOCAL const imgui_table_cell_t* imgui_table_at(const imgui_table_t* table, size_t row, size_t col);
+
+/**
+ * @brief Remove all rows.
+ * @param[in] table     Table object.
+ */
+AUTO_LOCAL void imgui_table_clear(imgui_table_t* table);
+
+/**
+ * @brief Set sort keys. Keys are applied in order.
+ * @param[in] table     Table object.
+ * @param[in] keys      Sort keys, empty for insertion order.
+ */
+AUTO_LOCAL void imgui_table_sort(imgui_table_t* table, const std::vector<imgui_table_key_t>& keys);
+
+/**
+ * @brief Set filter. Rows are kept if any string column contains \p text,
+ *   ignoring ASCII case.
+ * @param[in] table     Table object.
+ * @param[in] text      Filter text, empty to keep all rows.
+ * @param[in] column    Only test this column if not negative.
+ */
+AUTO_LOCAL void imgui_table_filter(imgui_table_t* table, const char* text, int column);
+
+/**
+ * @brief Get displayed rows.
+ *
+ * Publish result of finished job, and start a new job if sort keys, filter
+ * or rows changed since last job. Until the new result is ready, the
+ * previous one is displayed.
+ *
+ * @param[in] table     Table object.
+ * @param[out] index    Row index of each displayed row, NULL for insertion
+ *   order. Valid until next call.
+ * @param[out] count    The number of displayed rows.
+ * @return              Whether a job is running.
+ */
+AUTO_LOCAL bool imgui_table_view(imgui_table_t* table, const uint32_t** index, size_t* count);
+
+#endif
@@ -0,0 +1,209 @@
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "thread_pool.hpp"
+#include "lua_imgui.h"
+
+#define IMGUI_POOL_MAX_WORKERS  16
+
+typedef struct imgui_pool_task
+{
+    auto_thread_fn          fn;
+    void*                   arg;
+} imgui_pool_task_t;
+
+typedef struct imgui_pool
+{
+    std::mutex                      mutex;
+    std::deque<imgui_pool_task_t>   queue;
+    std::vector<auto_thread_t*>     workers;
+    auto_sem_t*                     sem;
+} imgui_pool_t;
+
+typedef struct imgui_pool_job
+{
+    imgui_pool_fn           fn;
+    void*                   arg;
+    size_t                  n;
+
+    std::atomic<size_t>     next;
+    std::atomic<size_t>     done;
+    std::atomic<int>        refcnt;
+    auto_sem_t*             sem;
+} imgui_pool_job_t;
+
+static imgui_pool_t s_pool;
+
+static void _imgui_pool_worker(void* arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        api->sem->wait(s_pool.sem);
+
+        imgui_pool_task_t task;
+        {
+            std::lock_guard<std::mutex> guard(s_pool.mutex);
+            task = s_pool.queue.front();
+            s_pool.queue.pop_front();
+        }
+
+        /* Empty task means exit */
+        if (task.fn == NULL)
+        {
+            return;
+        }
+        task.fn(task.arg);
+    }
+}
+
+/**
+ * @brief Start worker threads.
+ * @note Must be called with s_pool.mutex locked.
+ */
+static void _imgui_pool_ensure(void)
+{
+    if (s_pool.sem != NULL)
+    {
+        return;
+    }
+
+    size_t num = std::thread::hardware_concurrency();
+    num = num > 1 ? num - 1 : 1;
+    num = num < IMGUI_POOL_MAX_WORKERS ? num : IMGUI_POOL_MAX_WORKERS;
+
+    s_pool.sem = api->sem->create(0);
+    for (size_t i = 0; i < num; i++)
+    {
+        s_pool.workers.push_back(api->thread->create(_imgui_pool_worker, NULL));
+    }
+}
+
+static void _imgui_pool_enqueue(auto_thread_fn fn, void* arg)
+{
+    imgui_pool_task_t task = { fn, arg };
+    {
+        std::lock_guard<std::mutex> guard(s_pool.mutex);
+        _imgui_pool_ensure();
+        s_pool.queue.push_back(task);
+    }
+    api->sem->post(s_pool.sem);
+}
+
+static void _imgui_pool_job_unref(imgui_pool_job_t* job)
+{
+    if (job->refcnt.fetch_sub(1) == 1)
+    {
+        api->sem->destroy(job->sem);
+        delete job;
+    }
+}
+
+/**
+ * @brief Take tasks from job until nothing left.
+ */
+static void _imgui_pool_job_run(imgui_pool_job_t* job)
+{
+    size_t idx;
+    while ((idx = job->next.fetch_add(1)) < job->n)
+    {
+        job->fn(job->arg, idx);
+
+        if (job->done.fetch_add(1) + 1 == job->n)
+        {
+            api->sem->post(job->sem);
+        }
+    }
+}
+
+static void _imgui_pool_job_helper(void* arg)
+{
+    imgui_pool_job_t* job = (imgui_pool_job_t*)arg;
+    _imgui_pool_job_run(job);
+    _imgui_pool_job_unref(job);
+}
+
+size_t imgui_pool_concurrency(void)
+{
+    std::lock_guard<std::mutex> guard(s_pool.mutex);
+    _imgui_pool_ensure();
+    return s_pool.workers.size();
+}
+
+void imgui_pool_parallel(size_t n, imgui_pool_fn fn, void* arg)
+{
+    if (n == 0)
+    {
+        return;
+    }
+    if (n == 1)
+    {
+        fn(arg, 0);
+        return;
+    }
+
+    size_t num_helper = imgui_pool_concurrency();
+    num_helper = num_helper < n - 1 ? num_helper : n - 1;
+
+    /*
+     * The job is shared with helpers that may start after we return, so it
+     * is reference counted.
+     */
+    imgui_pool_job_t* job = new imgui_pool_job_t;
+    job->fn = fn;
+    job->arg = arg;
+    job->n = n;
+    job->next = 0;
+    job->done = 0;
+    job->refcnt = (int)num_helper + 1;
+    job->sem = api->sem->create(0);
+
+    for (size_t i = 0; i < num_helper; i++)
+    {
+        _imgui_pool_enqueue(_imgui_pool_job_helper, job);
+    }
+
+    _imgui_pool_job_run(job);
+    api->sem->wait(job->sem);
+
+    _imgui_pool_job_unref(job);
+}
+
+void imgui_pool_submit(auto_thread_fn fn, void* arg)
+{
+    _imgui_pool_enqueue(fn, arg);
+}
+
+void imgui_pool_exit(void)
+{
+    std::vector<auto_thread_t*> workers;
+    {
+        std::lock_guard<std::mutex> guard(s_pool.mutex);
+        if (s_pool.sem == NULL)
+        {
+            return;
+        }
+
+        imgui_pool_task_t task = { NULL, NULL };
+        for (size_t i = 0; i < s_pool.workers.size(); i++)
+        {
+            s_pool.queue.push_back(task);
+        }
+        workers.swap(s_pool.workers);
+    }
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        api->sem->post(s_pool.sem);
+    }
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        api->thread->join(workers[i]);
+    }
+
+    api->sem->destroy(s_pool.sem);
+    s_pool.sem = NULL;
+}
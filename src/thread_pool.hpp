@@ -0,0 +1,50 @@
+#ifndef __IMGUI_THREAD_POOL_HPP__
+#define __IMGUI_THREAD_POOL_HPP__
+
+#include <autodo.h>
+
+/**
+ * @brief Parallel task body.
+ * @param[in] arg   User defined argument.
+ * @param[in] idx   Task index.
+ */
+typedef void (*imgui_pool_fn)(void* arg, size_t idx);
+
+/**
+ * @brief Get the number of worker threads.
+ *
+ * Worker threads are created by `api->thread` on first use.
+ *
+ * @note MT-Safe
+ * @return  The number of worker threads.
+ */
+AUTO_LOCAL size_t imgui_pool_concurrency(void);
+
+/**
+ * @brief Run `fn(arg, i)` for every i in [0, n) and wait for all of them.
+ *
+ * The calling thread also take part in the work, so it is fine to call this
+ * function when all workers are busy with background tasks.
+ *
+ * @note MT-Safe
+ * @param[in] n     The number of tasks.
+ * @param[in] fn    Task body.
+ * @param[in] arg   User defined argument passed to \p fn.
+ */
+AUTO_LOCAL void imgui_pool_parallel(size_t n, imgui_pool_fn fn, void* arg);
+
+/**
+ * @brief Run `fn(arg)` in background.
+ * @note MT-Safe
+ * @param[in] fn    Task body.
+ * @param[in] arg   User defined argument passed to \p fn.
+ */
+AUTO_LOCAL void imgui_pool_submit(auto_thread_fn fn, void* arg);
+
+/**
+ * @brief Wait for all queued tasks and stop worker threads.
+ * @warning MT-UnSafe
+ */
+AUTO_LOCAL void imgui_pool_exit(void);
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef __IMGUI_TIMESERIES_HPP__
+#define __IMGUI_TIMESERIES_HPP__
+
+#include "gorilla.hpp"
+#include "series.hpp"
+
+/**
+ * @brief The number of decoded blocks kept for each time series.
+ */
+#define IMGUI_TIMESERIES_LRU_SIZE   16
+
+/**
+ * @brief A decoded block.
+ */
+typedef struct imgui_timeseries_lru
+{
+    size_t                  block;      /**< Block index, SIZE_MAX if empty. */
+    uint64_t                stamp;      /**< Last use. */
+    std::vector<int64_t>    ticks;      /**< Decoded timestamps. */
+    std::vector<double>     values;     /**< Decoded values. */
+} imgui_timeseries_lru_t;
+
+/**
+ * @brief Compressed time series.
+ *
+ * Samples are appended to an uncompressed tail. When the tail is full it is
+ * sealed into a Gorilla compressed block. Timestamps are quantized to
+ * integer ticks of #resolution seconds, so regular sampling compress to one
+ * bit per timestamp.
+ */
+typedef struct imgui_timeseries
+{
+    double                              resolution; /**< Seconds per tick. */
+    size_t                              block_size; /**< Samples per block. */
+    std::vector<imgui_gorilla_block_t>  blocks;     /**< Sealed blocks, in time order. */
+    std::vector<int64_t>                tail_ticks; /**< Timestamps of hot tail. */
+    std::vector<double>                 tail_values;/**< Values of hot tail. */
+    size_t                              size;       /**< The number of samples. */
+    double                              v_min;      /**< Minimum value. */
+    double                              v_max;      /**< Maximum value. */
+    uint64_t                            version;    /**< Data version. */
+
+    imgui_timeseries_lru_t              lru[IMGUI_TIMESERIES_LRU_SIZE];
+    uint64_t                            lru_clock;
+
+    /* Samples of last requested window */
+    std::vector<double>                 win_x;
+    std::vector<double>                 win_y;
+    uint64_t                            win_source; /**< Data version the window is decoded from. */
+    uint64_t                            win_x_version;
+    uint64_t                            win_y_version;
+    double                              win_min;
+    double                              win_max;
+} imgui_timeseries_t;
+
+/**
+ * @brief Test whether the function argument \p arg is a time series.
+ * @param[in] L     Lua VM.
+ * @param[in] arg   Argument index.
+ * @return          Time series object, or NULL.
+ */
+AUTO_LOCAL imgui_timeseries_t* imgui_timeseries_test(lua_State* L, int arg);
+
+/**
+ * @brief Decode samples whose timestamp is in [\p t_min, \p t_max].
+ *
+ * Only blocks overlapping the range are decoded, plus one sample of margin on
+ * each side. Decoded blocks are kept in a small LRU, and the window is kept
+ * until version or range changes.
+ *
+ * @param[in] ts        Time series.
+ * @param[in] t_min     Range minimum in seconds.
+ * @param[in] t_max     Range maximum in seconds.
+ * @param[out] xs       Timestamps in seconds, valid until next call.
+ * @param[out] ys       Values, valid until next call.
+ */
+AUTO_LOCAL void imgui_timeseries_window(imgui_timeseries_t* ts, double t_min, double t_max,
+    imgui_series_t* xs, imgui_series_t* ys);
+
+/**
+ * @brief Get time range and value range of all samples.
+ * @param[in] ts        Time series, must not be empty.
+ * @param[out] t_first  Timestamp of first sample.
+ * @param[out] t_last   Timestamp of last sample.
+ * @param[out] v_min    Minimum value.
+ * @param[out] v_max    Maximum value.
+ */
+AUTO_LOCAL void imgui_timeseries_bounds(const imgui_timeseries_t* ts, double* t_first,
+    double* t_last, double* v_min, double* v_max);
+
+#endif
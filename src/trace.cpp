@@ -0,0 +1,261 @@
+#include <errno.h>
+#include <stdio.h>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "trace.hpp"
+#include "lua_imgui.h"
+
+/**
+ * @brief Events buffered for each thread, must be power of 2.
+ */
+#define IMGUI_TRACE_RING_SIZE   16384
+
+/**
+ * @brief Interval between two flushes, in milliseconds.
+ */
+#define IMGUI_TRACE_FLUSH_MS    20
+
+typedef struct imgui_trace_ev
+{
+    uint64_t                ts;
+    uint64_t                dur;
+    const char*             name;
+    char                    phase;
+} imgui_trace_ev_t;
+
+/**
+ * @brief Single producer single consumer ring. The owner thread appends, the
+ *   writer thread consumes.
+ */
+typedef struct imgui_trace_ring
+{
+    std::atomic<uint64_t>   head;       /**< Next event to append. */
+    std::atomic<uint64_t>   tail;       /**< Next event to consume. */
+    std::atomic<uint64_t>   dropped;
+    int                     tid;
+    const char*             name;
+    bool                    named;      /**< Thread name written to current file. */
+    imgui_trace_ev_t        events[IMGUI_TRACE_RING_SIZE];
+} imgui_trace_ring_t;
+
+typedef struct imgui_trace
+{
+    std::mutex                          mutex;      /**< Protect #rings and #file. */
+    std::vector<imgui_trace_ring_t*>    rings;      /**< Never freed, threads keep their ring. */
+    FILE*                               file;
+    bool                                first;      /**< No event written to file yet. */
+    auto_thread_t*                      writer;
+    std::atomic<int>                    looping;
+    std::unordered_set<std::string>     names;
+} imgui_trace_t;
+
+std::atomic<int> imgui_trace_active(0);
+
+static imgui_trace_t s_trace;
+
+static thread_local imgui_trace_ring_t* s_ring = NULL;
+static thread_local const char* s_thread_name = NULL;
+
+static imgui_trace_ring_t* _trace_ring(void)
+{
+    if (s_ring != NULL)
+    {
+        return s_ring;
+    }
+
+    imgui_trace_ring_t* ring = new imgui_trace_ring_t;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    ring->name = s_thread_name;
+    ring->named = false;
+
+    std::lock_guard<std::mutex> guard(s_trace.mutex);
+    ring->tid = (int)s_trace.rings.size() + 1;
+    s_trace.rings.push_back(ring);
+    return s_ring = ring;
+}
+
+static void _trace_write_string(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (; *str != '\0'; str++)
+    {
+        unsigned char c = (unsigned char)*str;
+        if (c == '"' || c == '\\')
+        {
+            fputc('\\', file);
+            fputc(c, file);
+        }
+        else if (c < 0x20)
+        {
+            fprintf(file, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+static void _trace_write_sep(void)
+{
+    fputs(s_trace.first ? "\n" : ",\n", s_trace.file);
+    s_trace.first = false;
+}
+
+/**
+ * @brief Write all buffered events to file.
+ * @note Must be called with mutex locked.
+ */
+static void _trace_drain(void)
+{
+    FILE* file = s_trace.file;
+    for (imgui_trace_ring_t* ring : s_trace.rings)
+    {
+        if (!ring->named && ring->name != NULL)
+        {
+            _trace_write_sep();
+            fprintf(file, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", ring->tid);
+            _trace_write_string(file, ring->name);
+            fputs("}}", file);
+            ring->named = true;
+        }
+
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+        {
+            const imgui_trace_ev_t* ev = &ring->events[tail & (IMGUI_TRACE_RING_SIZE - 1)];
+
+            _trace_write_sep();
+            fprintf(file, "{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f", ev->phase, ring->tid, ev->ts / 1000.0);
+            if (ev->name != NULL)
+            {
+                fputs(",\"name\":", file);
+                _trace_write_string(file, ev->name);
+            }
+            if (ev->phase == 'X')
+            {
+                fprintf(file, ",\"dur\":%.3f", ev->dur / 1000.0);
+            }
+            else if (ev->phase == 'i')
+            {
+                fputs(",\"s\":\"t\"", file);
+            }
+            fputc('}', file);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+}
+
+static void _trace_writer(void* arg)
+{
+    (void)arg;
+
+    while (s_trace.looping.load(std::memory_order_acquire))
+    {
+        {
+            std::lock_guard<std::mutex> guard(s_trace.mutex);
+            _trace_drain();
+            fflush(s_trace.file);
+        }
+        api->thread->sleep(IMGUI_TRACE_FLUSH_MS);
+    }
+}
+
+int imgui_trace_start(const char* path)
+{
+    if (imgui_trace_active.load())
+    {
+        imgui_trace_stop();
+    }
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return errno;
+    }
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+
+    {
+        std::lock_guard<std::mutex> guard(s_trace.mutex);
+        s_trace.file = file;
+        s_trace.first = true;
+        for (imgui_trace_ring_t* ring : s_trace.rings)
+        {
+            /* Events left from last trace are dropped */
+            ring->tail.store(ring->head.load(std::memory_order_acquire));
+            ring->dropped = 0;
+            ring->named = false;
+        }
+    }
+
+    s_trace.looping = 1;
+    s_trace.writer = api->thread->create(_trace_writer, NULL);
+    imgui_trace_active = 1;
+    return 0;
+}
+
+uint64_t imgui_trace_stop(void)
+{
+    if (!imgui_trace_active.load())
+    {
+        return 0;
+    }
+
+    imgui_trace_active = 0;
+    s_trace.looping = 0;
+    api->thread->join(s_trace.writer);
+    s_trace.writer = NULL;
+
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> guard(s_trace.mutex);
+    _trace_drain();
+    for (imgui_trace_ring_t* ring : s_trace.rings)
+    {
+        dropped += ring->dropped.load();
+    }
+
+    fputs("\n]}\n", s_trace.file);
+    fclose(s_trace.file);
+    s_trace.file = NULL;
+    return dropped;
+}
+
+void imgui_trace_event(char phase, const char* name, uint64_t ts, uint64_t dur)
+{
+    imgui_trace_ring_t* ring = _trace_ring();
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (head - tail >= IMGUI_TRACE_RING_SIZE)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    imgui_trace_ev_t* ev = &ring->events[head & (IMGUI_TRACE_RING_SIZE - 1)];
+    ev->ts = phase == 'X' ? ts : api->misc->hrtime();
+    ev->dur = dur;
+    ev->name = name;
+    ev->phase = phase;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void imgui_trace_thread_name(const char* name)
+{
+    s_thread_name = name;
+    if (s_ring != NULL)
+    {
+        s_ring->name = name;
+    }
+}
+
+const char* imgui_trace_intern(const char* name)
+{
+    return s_trace.names.insert(name).first->c_str();
+}
@@ -0,0 +1,83 @@
+#ifndef __IMGUI_TRACE_HPP__
+#define __IMGUI_TRACE_HPP__
+
+#include <autodo.h>
+#include <atomic>
+
+/**
+ * @brief Nonzero while a trace file is open.
+ */
+AUTO_LOCAL extern std::atomic<int> imgui_trace_active;
+
+/**
+ * @brief Begin a zone on calling thread.
+ * @param[in] name  Zone name, must stay valid until trace stops.
+ */
+#define IMGUI_TRACE_BEGIN(name) \
+    do { if (imgui_trace_active.load(std::memory_order_relaxed)) imgui_trace_event('B', name, 0, 0); } while (0)
+
+/**
+ * @brief End last zone on calling thread.
+ */
+#define IMGUI_TRACE_END() \
+    do { if (imgui_trace_active.load(std::memory_order_relaxed)) imgui_trace_event('E', NULL, 0, 0); } while (0)
+
+/**
+ * @brief Record a zone that already finished.
+ * @param[in] name  Zone name, must stay valid until trace stops.
+ * @param[in] ts    Begin time in nanoseconds.
+ * @param[in] dur   Duration in nanoseconds.
+ */
+#define IMGUI_TRACE_COMPLETE(name, ts, dur) \
+    do { if (imgui_trace_active.load(std::memory_order_relaxed)) imgui_trace_event('X', name, ts, dur); } while (0)
+
+/**
+ * @brief Record an instant event.
+ * @param[in] name  Event name, must stay valid until trace stops.
+ */
+#define IMGUI_TRACE_INSTANT(name) \
+    do { if (imgui_trace_active.load(std::memory_order_relaxed)) imgui_trace_event('i', name, 0, 0); } while (0)
+
+/**
+ * @brief Start writing trace events to \p path in Chrome trace event format.
+ *
+ * The file can be loaded by Perfetto UI and chrome://tracing.
+ *
+ * @param[in] path  File path, truncated if exists.
+ * @return          0 if success, otherwise errno.
+ */
+AUTO_LOCAL int imgui_trace_start(const char* path);
+
+/**
+ * @brief Stop tracing, write pending events and close file.
+ * @return          The number of events dropped because a buffer was full.
+ */
+AUTO_LOCAL uint64_t imgui_trace_stop(void);
+
+/**
+ * @brief Append event to the buffer of calling thread.
+ *
+ * Use the IMGUI_TRACE_* macros instead, which skip the call when not tracing.
+ *
+ * @param[in] phase Chrome trace event phase: 'B', 'E', 'X' or 'i'.
+ * @param[in] name  Event name, NULL for 'E'.
+ * @param[in] ts    Begin time of 'X', ignored otherwise.
+ * @param[in] dur   Duration of 'X', ignored otherwise.
+ */
+AUTO_LOCAL void imgui_trace_event(char phase, const char* name, uint64_t ts, uint64_t dur);
+
+/**
+ * @brief Set name of calling thread shown in trace.
+ * @param[in] name  Thread name, must be static.
+ */
+AUTO_LOCAL void imgui_trace_thread_name(const char* name);
+
+/**
+ * @brief Get a copy of \p name that stays valid until process exits.
+ * @note Not thread safe, only called on Lua thread.
+ * @param[in] name  Zone name.
+ * @return          Interned name.
+ */
+AUTO_LOCAL const char* imgui_trace_intern(const char* name);
+
+#endif
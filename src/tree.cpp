@@ -0,0 +1,290 @@
+#include "tree.hpp"
+
+#define IMGUI_TREE_LEAF     (1U << 0)
+#define IMGUI_TREE_EXPANDED (1U << 1)
+#define IMGUI_TREE_LOADED   (1U << 2)
+
+/**
+ * @brief Node links use 0 as none, since root is never a child or sibling.
+ */
+typedef struct imgui_tree_node
+{
+    size_t              label;          /**< Offset in label arena. */
+    uint32_t            len;            /**< Label length. */
+    uint32_t            parent;
+    uint32_t            first_child;
+    uint32_t            last_child;
+    uint32_t            next_sibling;
+    uint32_t            depth;          /**< 0 for top-level. */
+    uint32_t            flags;
+} imgui_tree_node_t;
+
+struct imgui_tree
+{
+    std::vector<imgui_tree_node_t>  nodes;      /**< Node 0 is root. */
+    std::vector<char>               labels;     /**< Labels back to back. */
+    std::vector<uint32_t>           rows;       /**< Visible nodes in display order. */
+    bool                            dirty;      /**< Whether #rows need rebuild. */
+
+    imgui_tree_load_fn              load;
+    void*                           arg;
+};
+
+static void _tree_reset_root(imgui_tree_t* tree)
+{
+    imgui_tree_node_t root = {};
+    root.flags = IMGUI_TREE_EXPANDED | IMGUI_TREE_LOADED;
+    tree->nodes.assign(1, root);
+}
+
+/**
+ * @brief Check whether children of \p node are visible.
+ */
+static bool _tree_children_visible(const imgui_tree_t* tree, uint32_t node)
+{
+    for (;;)
+    {
+        if (!(tree->nodes[node].flags & IMGUI_TREE_EXPANDED))
+        {
+            return false;
+        }
+        if (node == 0)
+        {
+            return true;
+        }
+        node = tree->nodes[node].parent;
+    }
+}
+
+/**
+ * @brief Append visible descendants of expanded \p node in display order.
+ */
+static void _tree_collect(const imgui_tree_t* tree, uint32_t node, std::vector<uint32_t>& out)
+{
+    std::vector<uint32_t> pending;  /* Next sibling of each open ancestor */
+    uint32_t cur = tree->nodes[node].first_child;
+
+    for (;;)
+    {
+        if (cur == 0)
+        {
+            if (pending.empty())
+            {
+                break;
+            }
+            cur = pending.back();
+            pending.pop_back();
+            continue;
+        }
+
+        out.push_back(cur);
+        const imgui_tree_node_t& n = tree->nodes[cur];
+        if ((n.flags & IMGUI_TREE_EXPANDED) && n.first_child != 0)
+        {
+            pending.push_back(n.next_sibling);
+            cur = n.first_child;
+        }
+        else
+        {
+            cur = n.next_sibling;
+        }
+    }
+}
+
+static void _tree_sync(imgui_tree_t* tree)
+{
+    if (tree->dirty)
+    {
+        tree->rows.clear();
+        _tree_collect(tree, 0, tree->rows);
+        tree->dirty = false;
+    }
+}
+
+/**
+ * @brief Load children of \p node if never done.
+ */
+static void _tree_load(imgui_tree_t* tree, uint32_t node)
+{
+    if (tree->nodes[node].flags & IMGUI_TREE_LOADED)
+    {
+        return;
+    }
+
+    /* Mark first so a loader failing half way is not called again */
+    tree->nodes[node].flags |= IMGUI_TREE_LOADED;
+    if (tree->load != NULL)
+    {
+        tree->load(tree, node, tree->arg);
+    }
+}
+
+imgui_tree_t* imgui_tree_create(imgui_tree_load_fn fn, void* arg)
+{
+    imgui_tree_t* tree = new imgui_tree_t;
+    _tree_reset_root(tree);
+    tree->dirty = false;
+    tree->load = fn;
+    tree->arg = arg;
+    return tree;
+}
+
+void imgui_tree_destroy(imgui_tree_t* tree)
+{
+    delete tree;
+}
+
+uint32_t imgui_tree_add(imgui_tree_t* tree, uint32_t parent, const char* label, size_t len, bool leaf)
+{
+    const uint32_t id = (uint32_t)tree->nodes.size();
+
+    imgui_tree_node_t node = {};
+    node.label = tree->labels.size();
+    node.len = (uint32_t)len;
+    node.parent = parent;
+    node.depth = parent == 0 ? 0 : tree->nodes[parent].depth + 1;
+    node.flags = leaf ? IMGUI_TREE_LEAF : 0;
+    tree->labels.insert(tree->labels.end(), label, label + len);
+    tree->nodes.push_back(node);
+
+    imgui_tree_node_t& p = tree->nodes[parent];
+    p.flags = (p.flags & ~IMGUI_TREE_LEAF) | IMGUI_TREE_LOADED;
+    if (p.last_child != 0)
+    {
+        tree->nodes[p.last_child].next_sibling = id;
+    }
+    else
+    {
+        p.first_child = id;
+    }
+    p.last_child = id;
+
+    if (_tree_children_visible(tree, parent))
+    {
+        tree->dirty = true;
+    }
+    return id;
+}
+
+void imgui_tree_clear(imgui_tree_t* tree)
+{
+    _tree_reset_root(tree);
+    tree->labels.clear();
+    tree->rows.clear();
+    tree->dirty = false;
+}
+
+size_t imgui_tree_size(const imgui_tree_t* tree)
+{
+    return tree->nodes.size() - 1;
+}
+
+const char* imgui_tree_label(const imgui_tree_t* tree, uint32_t node, size_t* len)
+{
+    *len = tree->nodes[node].len;
+    return tree->labels.data() + tree->nodes[node].label;
+}
+
+uint32_t imgui_tree_parent(const imgui_tree_t* tree, uint32_t node)
+{
+    return tree->nodes[node].parent;
+}
+
+uint32_t imgui_tree_depth(const imgui_tree_t* tree, uint32_t node)
+{
+    return tree->nodes[node].depth;
+}
+
+bool imgui_tree_is_leaf(const imgui_tree_t* tree, uint32_t node)
+{
+    return tree->nodes[node].flags & IMGUI_TREE_LEAF;
+}
+
+bool imgui_tree_is_expanded(const imgui_tree_t* tree, uint32_t node)
+{
+    return tree->nodes[node].flags & IMGUI_TREE_EXPANDED;
+}
+
+void imgui_tree_expand(imgui_tree_t* tree, uint32_t node, bool expand)
+{
+    if (node == 0 || imgui_tree_is_expanded(tree, node) == expand)
+    {
+        return;
+    }
+    if (expand)
+    {
+        /* Loader may clear the tree */
+        _tree_load(tree, node);
+        if (node >= tree->nodes.size() || (tree->nodes[node].flags & IMGUI_TREE_LEAF))
+        {
+            return;
+        }
+        tree->nodes[node].flags |= IMGUI_TREE_EXPANDED;
+    }
+    else
+    {
+        tree->nodes[node].flags &= ~IMGUI_TREE_EXPANDED;
+    }
+
+    if (_tree_children_visible(tree, tree->nodes[node].parent))
+    {
+        tree->dirty = true;
+    }
+}
+
+void imgui_tree_toggle(imgui_tree_t* tree, size_t row)
+{
+    _tree_sync(tree);
+    if (row >= tree->rows.size())
+    {
+        return;
+    }
+
+    const uint32_t node = tree->rows[row];
+    imgui_tree_node_t* n = &tree->nodes[node];
+    if (n->flags & IMGUI_TREE_EXPANDED)
+    {
+        size_t end = row + 1;
+        while (end < tree->rows.size() && tree->nodes[tree->rows[end]].depth > n->depth)
+        {
+            end++;
+        }
+        tree->rows.erase(tree->rows.begin() + row + 1, tree->rows.begin() + end);
+        n->flags &= ~IMGUI_TREE_EXPANDED;
+        return;
+    }
+
+    /*
+     * Loader may add nodes elsewhere and reallocate node array, or clear the
+     * tree. If the row no longer shows this node, just rebuild rows.
+     */
+    _tree_load(tree, node);
+    if (node >= tree->nodes.size() || row >= tree->rows.size() || tree->rows[row] != node)
+    {
+        tree->dirty = true;
+        _tree_sync(tree);
+        return;
+    }
+    n = &tree->nodes[node];
+    if (n->flags & IMGUI_TREE_LEAF)
+    {
+        return;
+    }
+    n->flags |= IMGUI_TREE_EXPANDED;
+
+    if (tree->dirty)
+    {
+        _tree_sync(tree);
+        return;
+    }
+
+    std::vector<uint32_t> children;
+    _tree_collect(tree, node, children);
+    tree->rows.insert(tree->rows.begin() + row + 1, children.begin(), children.end());
+}
+
+const std::vector<uint32_t>& imgui_tree_rows(imgui_tree_t* tree)
+{
+    _tree_sync(tree);
+    return tree->rows;
+}
@@ -0,0 +1,129 @@
+#ifndef __IMGUI_TREE_HPP__
+#define __IMGUI_TREE_HPP__
+
+#include <autodo.h>
+#include <vector>
+
+/**
+ * @brief Tree of labels in a flat node array.
+ *
+ * Node 0 is the invisible root, top-level nodes are its children. Children of
+ * a node are loaded on demand the first time it is expanded, and the list of
+ * visible rows is updated in place when a node is toggled, so drawing only
+ * costs the rows on screen however large the tree is.
+ */
+typedef struct imgui_tree imgui_tree_t;
+
+/**
+ * @brief Load children of a node by #imgui_tree_add().
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node being expanded for the first time.
+ * @param[in] arg       User defined argument.
+ */
+typedef void (*imgui_tree_load_fn)(imgui_tree_t* tree, uint32_t node, void* arg);
+
+/**
+ * @brief Create tree.
+ * @param[in] fn        Children loader, or NULL if every node is added eagerly.
+ * @param[in] arg       User defined argument passed to \p fn.
+ * @return              Tree object.
+ */
+AUTO_LOCAL imgui_tree_t* imgui_tree_create(imgui_tree_load_fn fn, void* arg);
+
+/**
+ * @brief Destroy tree.
+ * @param[in] tree      Tree object.
+ */
+AUTO_LOCAL void imgui_tree_destroy(imgui_tree_t* tree);
+
+/**
+ * @brief Append a child. Adding a child marks \p parent as loaded.
+ * @param[in] tree      Tree object.
+ * @param[in] parent    Parent node, 0 for top-level.
+ * @param[in] label     Label.
+ * @param[in] len       Label length in bytes.
+ * @param[in] leaf      Whether node never has children.
+ * @return              Node id.
+ */
+AUTO_LOCAL uint32_t imgui_tree_add(imgui_tree_t* tree, uint32_t parent, const char* label, size_t len, bool leaf);
+
+/**
+ * @brief Remove all nodes.
+ * @param[in] tree      Tree object.
+ */
+AUTO_LOCAL void imgui_tree_clear(imgui_tree_t* tree);
+
+/**
+ * @brief Get the number of nodes, excluding root.
+ * @param[in] tree      Tree object.
+ * @return              The number of nodes.
+ */
+AUTO_LOCAL size_t imgui_tree_size(const imgui_tree_t* tree);
+
+/**
+ * @brief Get label.
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ * @param[out] len      Length in bytes.
+ * @return              Label, not NUL terminated. Valid until next add.
+ */
+AUTO_LOCAL const char* imgui_tree_label(const imgui_tree_t* tree, uint32_t node, size_t* len);
+
+/**
+ * @brief Get parent.
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ * @return              Parent id, 0 for top-level.
+ */
+AUTO_LOCAL uint32_t imgui_tree_parent(const imgui_tree_t* tree, uint32_t node);
+
+/**
+ * @brief Get depth.
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ * @return              Depth, 0 for top-level.
+ */
+AUTO_LOCAL uint32_t imgui_tree_depth(const imgui_tree_t* tree, uint32_t node);
+
+/**
+ * @brief Check whether node never has children.
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ */
+AUTO_LOCAL bool imgui_tree_is_leaf(const imgui_tree_t* tree, uint32_t node);
+
+/**
+ * @brief Check whether node is expanded.
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ */
+AUTO_LOCAL bool imgui_tree_is_expanded(const imgui_tree_t* tree, uint32_t node);
+
+/**
+ * @brief Expand or collapse a node, loading its children if needed.
+ *
+ * Visible rows are rebuilt on next #imgui_tree_rows() if the node is visible.
+ * Use #imgui_tree_toggle() for a node on screen instead.
+ *
+ * @param[in] tree      Tree object.
+ * @param[in] node      Node id.
+ * @param[in] expand    Whether to expand.
+ */
+AUTO_LOCAL void imgui_tree_expand(imgui_tree_t* tree, uint32_t node, bool expand);
+
+/**
+ * @brief Expand or collapse the node at a visible row, loading its children
+ *   if needed. Only rows below it are inserted or erased.
+ * @param[in] tree      Tree object.
+ * @param[in] row       Row index in #imgui_tree_rows().
+ */
+AUTO_LOCAL void imgui_tree_toggle(imgui_tree_t* tree, size_t row);
+
+/**
+ * @brief Get visible nodes in display order.
+ * @param[in] tree      Tree object.
+ * @return              Node ids, valid until next modification.
+ */
+AUTO_LOCAL const std::vector<uint32_t>& imgui_tree_rows(imgui_tree_t* tree);
+
+#endif
@@ -0,0 +1,51 @@
+local imgui = require("imgui")
+local playback = imgui.playback
+
+-- Scroll, resize and typing scenario driven by synthetic input
+local events = {
+    { 0, "move", 100, 100 },
+    { 2, "click", 0 },
+}
+for i = 0, 59 do
+    table.insert(events, { 5 + i, "wheel", i < 30 and -1 or 1 })
+end
+for i = 0, 19 do
+    table.insert(events, { 70 + i, "resize", 640 + i * 16, 480 + i * 9 })
+end
+table.insert(events, { 95, "move", 30, 35 })
+table.insert(events, { 96, "click", 0 })
+table.insert(events, { 98, "move", 100, 60 })
+table.insert(events, { 99, "click", 0 })
+table.insert(events, { 101, "text", "hello world" })
+table.insert(events, { 104, "key", "Enter" })
+table.insert(events, { 110, "exit" })
+
+local clicked = 0
+
+local function on_gui()
+    imgui.SetNextWindowPos(0, 0)
+    imgui.SetNextWindowSize(400, 300)
+    imgui.Begin("Playback", false)
+    if imgui.Button("click me") then
+        clicked = clicked + 1
+    end
+    imgui.InputText("input")
+    for i = 1, 200 do
+        imgui.Text("line " .. i)
+    end
+    imgui.End()
+end
+
+playback.start(events)
+local gui_token = imgui.loop({ window_hidden = true }, on_gui)
+gui_token:await()
+
+playback.check(clicked == 1, "button clicked " .. clicked .. " times")
+local report = playback.stop()
+
+io.write(string.format("frames %d, mean %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+    report.frames, report.mean, report.p50, report.p95, report.p99, report.max))
+for _, msg in ipairs(report.failures) do
+    io.write("FAIL " .. msg .. "\n")
+end
+assert(report.finished and #report.failures == 0)